@@ -0,0 +1,443 @@
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+#include "ast/ast_walker.h"
+#include "semantic/semantic_analyzer.h"
+#include "ir/ir_builder.h"
+#include "ir/ir_parser.h"
+#include "optimizer/optimizer.h"
+#include "codegen/code_generator.h"
+#include "common/perf_counters.h"
+#include "program_generator.h"
+
+using namespace minicompiler;
+
+namespace {
+
+// 输入规模：small / medium / huge
+enum InputSize { kSmall = 0, kMedium = 1, kHuge = 2 };
+
+const char* sizeName(int64_t size) {
+    static const char* names[] = {"small", "medium", "huge"};
+    return names[size];
+}
+
+/**
+ * @brief 用固定种子生成指定规模的输入程序
+ */
+std::string synthesizeProgram(int64_t size) {
+    static const uint64_t bytes[] = {16 << 10, 512 << 10, 4 << 20};
+
+    GeneratorOptions options;
+    options.seed = 2024;
+    options.maxDepth = 2;
+    options.targetBytes = bytes[size];
+    return ProgramGenerator(options).generate();
+}
+
+/**
+ * @brief 统计AST节点数
+ */
+class NodeCounter : public ASTWalker<NodeCounter> {
+public:
+    size_t count = 0;
+
+    void walk(ASTNode* node) {
+        count++;
+        ASTWalker<NodeCounter>::walk(node);
+    }
+};
+
+size_t countInstructions(const IRModule& module) {
+    size_t count = 0;
+    for (const auto& function : module.getFunctions()) {
+        count += function->getInstructionCount();
+    }
+    return count;
+}
+
+/**
+ * @brief 每种规模的输入及各阶段的中间结果，首次使用时构造
+ */
+struct Inputs {
+    std::string source;
+    std::vector<Token> tokens;
+    std::unique_ptr<Program> ast;
+    size_t astNodes = 0;
+    std::string irText;
+    size_t irInstructions = 0;
+};
+
+const Inputs& inputsFor(int64_t size) {
+    static std::unique_ptr<Inputs> cache[3];
+    if (!cache[size]) {
+        auto inputs = std::make_unique<Inputs>();
+        inputs->source = synthesizeProgram(size);
+
+        Lexer lexer(inputs->source);
+        inputs->tokens = lexer.scanTokens();
+
+        Parser parser(inputs->tokens);
+        inputs->ast = parser.parse();
+
+        // 与编译器驱动一致，生成IR之前先做语义分析，标注表达式类型
+        SemanticAnalyzer analyzer;
+        analyzer.analyze(inputs->ast.get());
+
+        NodeCounter counter;
+        counter.walk(inputs->ast.get());
+        inputs->astNodes = counter.count;
+
+        IRBuilder builder("bench");
+        auto module = builder.build(inputs->ast.get());
+        inputs->irInstructions = countInstructions(*module);
+        inputs->irText = module->toString();
+
+        cache[size] = std::move(inputs);
+    }
+    return *cache[size];
+}
+
+std::shared_ptr<IRModule> freshModule(const Inputs& inputs) {
+    IRParser parser(inputs.irText);
+    return parser.parse();
+}
+
+/**
+ * @brief 在作用域内丢弃std::cout输出（优化器和代码生成器会打印进度信息）
+ */
+class QuietStdout {
+public:
+    QuietStdout() : saved_(std::cout.rdbuf(&null_)) {}
+    ~QuietStdout() { std::cout.rdbuf(saved_); }
+
+private:
+    struct NullBuffer : std::streambuf {
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+
+    NullBuffer null_;
+    std::streambuf* saved_;
+};
+
+/**
+ * @brief 设置环境变量MINICOMPILER_PERF_COUNTERS=1时，为基准附加每次迭代的硬件计数器
+ *
+ * 构造时开始计数，report()停止计数并写入基准的计数器。PauseTiming期间应调用pause()。
+ * 计数器不可用时为空操作。
+ */
+class BenchCounters {
+public:
+    explicit BenchCounters(benchmark::State& state) : state_(state) {
+        static const bool enabled = std::getenv("MINICOMPILER_PERF_COUNTERS") != nullptr;
+        if (enabled) {
+            counters_ = std::make_unique<PerfCounters>();
+            if (!counters_->isAvailable()) {
+                counters_.reset();
+            }
+        }
+        resume();
+    }
+
+    void resume() {
+        if (counters_) {
+            counters_->start();
+        }
+    }
+
+    void pause() {
+        if (!counters_) {
+            return;
+        }
+        if (first_) {
+            total_ = counters_->stop();
+            first_ = false;
+        } else {
+            total_ += counters_->stop();
+        }
+    }
+
+    void report() {
+        if (!counters_) {
+            return;
+        }
+        pause();
+
+        for (size_t i = 0; i < kPerfCounterCount; ++i) {
+            auto counter = static_cast<PerfCounter>(i);
+            if (total_.has(counter)) {
+                state_.counters[PerfCounters::name(counter)] = benchmark::Counter(
+                    static_cast<double>(total_.get(counter)), benchmark::Counter::kAvgIterations);
+            }
+        }
+        if (total_.has(PerfCounter::CYCLES) && total_.has(PerfCounter::INSTRUCTIONS) &&
+            total_.get(PerfCounter::CYCLES) > 0) {
+            state_.counters["IPC"] = static_cast<double>(total_.get(PerfCounter::INSTRUCTIONS)) /
+                                     static_cast<double>(total_.get(PerfCounter::CYCLES));
+        }
+    }
+
+private:
+    benchmark::State& state_;
+    std::unique_ptr<PerfCounters> counters_;
+    PerfCounterValues total_;
+    bool first_ = true;
+};
+
+void setRate(benchmark::State& state, const char* name, size_t perIteration) {
+    state.counters[name] = benchmark::Counter(static_cast<double>(perIteration),
+                                              benchmark::Counter::kIsIterationInvariantRate);
+}
+
+} // namespace
+
+static void BM_Lexer(benchmark::State& state) {
+    const Inputs& inputs = inputsFor(state.range(0));
+
+    BenchCounters counters(state);
+    for (auto _ : state) {
+        Lexer lexer(inputs.source);
+        auto tokens = lexer.scanTokens();
+        benchmark::DoNotOptimize(tokens.data());
+    }
+
+    counters.report();
+    state.SetLabel(sizeName(state.range(0)));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * inputs.source.size()));
+    setRate(state, "tokens/s", inputs.tokens.size());
+}
+BENCHMARK(BM_Lexer)->DenseRange(kSmall, kHuge)->Unit(benchmark::kMicrosecond);
+
+static void BM_Parser(benchmark::State& state) {
+    const Inputs& inputs = inputsFor(state.range(0));
+
+    BenchCounters counters(state);
+    for (auto _ : state) {
+        Parser parser(inputs.tokens);
+        auto program = parser.parse();
+        benchmark::DoNotOptimize(program.get());
+    }
+
+    counters.report();
+    state.SetLabel(sizeName(state.range(0)));
+    setRate(state, "nodes/s", inputs.astNodes);
+}
+BENCHMARK(BM_Parser)->DenseRange(kSmall, kHuge)->Unit(benchmark::kMicrosecond);
+
+// 第二个参数为并行解析的线程数
+static void BM_ParserParallel(benchmark::State& state) {
+    const Inputs& inputs = inputsFor(state.range(0));
+
+    BenchCounters counters(state);
+    for (auto _ : state) {
+        Parser parser(inputs.tokens);
+        parser.setParallelJobs(static_cast<unsigned>(state.range(1)));
+        auto program = parser.parse();
+        benchmark::DoNotOptimize(program.get());
+    }
+
+    counters.report();
+    state.SetLabel(sizeName(state.range(0)));
+    setRate(state, "nodes/s", inputs.astNodes);
+}
+BENCHMARK(BM_ParserParallel)
+    ->ArgsProduct({{kMedium, kHuge}, {1, 4}})
+    ->Unit(benchmark::kMicrosecond);
+
+// 只解析从main可达的函数体
+static void BM_ParserLazy(benchmark::State& state) {
+    const Inputs& inputs = inputsFor(state.range(0));
+
+    BenchCounters counters(state);
+    for (auto _ : state) {
+        Parser parser(inputs.tokens);
+        parser.setLazyFunctionBodies(true);
+        auto program = parser.parse();
+        benchmark::DoNotOptimize(program.get());
+    }
+
+    counters.report();
+    state.SetLabel(sizeName(state.range(0)));
+    setRate(state, "nodes/s", inputs.astNodes);
+}
+BENCHMARK(BM_ParserLazy)->DenseRange(kSmall, kHuge)->Unit(benchmark::kMicrosecond);
+
+static void BM_ASTWalk(benchmark::State& state) {
+    const Inputs& inputs = inputsFor(state.range(0));
+
+    BenchCounters counters(state);
+    for (auto _ : state) {
+        NodeCounter counter;
+        counter.walk(inputs.ast.get());
+        benchmark::DoNotOptimize(counter.count);
+    }
+
+    counters.report();
+    state.SetLabel(sizeName(state.range(0)));
+    setRate(state, "nodes/s", inputs.astNodes);
+}
+BENCHMARK(BM_ASTWalk)->DenseRange(kSmall, kHuge)->Unit(benchmark::kMicrosecond);
+
+// 第二个参数为检查函数体的线程数
+static void BM_SemanticAnalysis(benchmark::State& state) {
+    const Inputs& inputs = inputsFor(state.range(0));
+
+    BenchCounters counters(state);
+    for (auto _ : state) {
+        SemanticAnalyzer analyzer;
+        analyzer.setParallelJobs(static_cast<unsigned>(state.range(1)));
+        bool ok = analyzer.analyze(inputs.ast.get());
+        benchmark::DoNotOptimize(ok);
+    }
+
+    counters.report();
+    state.SetLabel(sizeName(state.range(0)));
+    setRate(state, "nodes/s", inputs.astNodes);
+}
+BENCHMARK(BM_SemanticAnalysis)
+    ->ArgsProduct({{kSmall, kMedium, kHuge}, {1, 4}})
+    ->Unit(benchmark::kMicrosecond);
+
+static void runIRBuilder(benchmark::State& state, bool flatten) {
+    const Inputs& inputs = inputsFor(state.range(0));
+
+    BenchCounters counters(state);
+    for (auto _ : state) {
+        IRBuilder builder("bench");
+        builder.setFlattenExpressions(flatten);
+        auto module = builder.build(inputs.ast.get());
+        benchmark::DoNotOptimize(module.get());
+    }
+
+    counters.report();
+    state.SetLabel(sizeName(state.range(0)));
+    setRate(state, "instructions/s", inputs.irInstructions);
+}
+
+static void BM_IRBuilder(benchmark::State& state) {
+    runIRBuilder(state, false);
+}
+BENCHMARK(BM_IRBuilder)->DenseRange(kSmall, kHuge)->Unit(benchmark::kMicrosecond);
+
+// 表达式先展平为后序数组再生成
+static void BM_IRBuilderFlat(benchmark::State& state) {
+    runIRBuilder(state, true);
+}
+BENCHMARK(BM_IRBuilderFlat)->DenseRange(kSmall, kHuge)->Unit(benchmark::kMicrosecond);
+
+static void BM_IRParser(benchmark::State& state) {
+    const Inputs& inputs = inputsFor(state.range(0));
+
+    BenchCounters counters(state);
+    for (auto _ : state) {
+        auto module = freshModule(inputs);
+        benchmark::DoNotOptimize(module.get());
+    }
+
+    counters.report();
+    state.SetLabel(sizeName(state.range(0)));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * inputs.irText.size()));
+    setRate(state, "instructions/s", inputs.irInstructions);
+}
+BENCHMARK(BM_IRParser)->DenseRange(kSmall, kHuge)->Unit(benchmark::kMicrosecond);
+
+static void BM_OptimizerPass(benchmark::State& state, const std::string& pass) {
+    const Inputs& inputs = inputsFor(state.range(0));
+    QuietStdout quiet;
+    std::shared_ptr<IRModule> module;
+
+    BenchCounters counters(state);
+    for (auto _ : state) {
+        // 每次迭代都需要未经优化的新模块，旧模块的析构也不计入时间
+        counters.pause();
+        state.PauseTiming();
+        module = freshModule(inputs);
+        Optimizer optimizer(2);
+        optimizer.setWholeProgram(true);
+        state.ResumeTiming();
+        counters.resume();
+
+        optimizer.runPass(pass, module);
+        benchmark::DoNotOptimize(module.get());
+    }
+
+    counters.report();
+    state.SetLabel(sizeName(state.range(0)));
+    setRate(state, "instructions/s", inputs.irInstructions);
+}
+
+static void BM_Optimize(benchmark::State& state) {
+    const Inputs& inputs = inputsFor(state.range(0));
+    QuietStdout quiet;
+    std::shared_ptr<IRModule> module;
+
+    BenchCounters counters(state);
+    for (auto _ : state) {
+        counters.pause();
+        state.PauseTiming();
+        module = freshModule(inputs);
+        state.ResumeTiming();
+        counters.resume();
+
+        Optimizer optimizer(2);
+        benchmark::DoNotOptimize(optimizer.optimize(module).get());
+    }
+
+    counters.report();
+    state.SetLabel(sizeName(state.range(0)));
+    setRate(state, "instructions/s", inputs.irInstructions);
+}
+BENCHMARK(BM_Optimize)->DenseRange(kSmall, kHuge)->Unit(benchmark::kMicrosecond);
+
+static void BM_CodeGen(benchmark::State& state) {
+    const Inputs& inputs = inputsFor(state.range(0));
+    auto module = freshModule(inputs);
+    QuietStdout quiet;
+
+    BenchCounters counters(state);
+    for (auto _ : state) {
+        CodeGenerator codeGen("x86_64-unknown-linux-gnu");
+        benchmark::DoNotOptimize(codeGen.generate(module, "/dev/null"));
+    }
+
+    counters.report();
+    state.SetLabel(sizeName(state.range(0)));
+    setRate(state, "functions/s", module->getFunctions().size());
+}
+BENCHMARK(BM_CodeGen)->DenseRange(kSmall, kHuge)->Unit(benchmark::kMicrosecond);
+
+static void BM_EmitIR(benchmark::State& state) {
+    const Inputs& inputs = inputsFor(state.range(0));
+    auto module = freshModule(inputs);
+    QuietStdout quiet;
+
+    BenchCounters counters(state);
+    for (auto _ : state) {
+        // std::cout已被丢弃，这里只衡量IR文本的格式化开销
+        module->print(std::cout);
+    }
+
+    counters.report();
+    state.SetLabel(sizeName(state.range(0)));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * inputs.irText.size()));
+    setRate(state, "instructions/s", inputs.irInstructions);
+}
+BENCHMARK(BM_EmitIR)->DenseRange(kSmall, kHuge)->Unit(benchmark::kMicrosecond);
+
+// 为每个优化pass注册一个基准测试：BM_OptimizerPass/<pass>/<size>
+static const bool passBenchmarksRegistered = []() {
+    for (const auto& pass : Optimizer::getPassNames()) {
+        benchmark::RegisterBenchmark(("BM_OptimizerPass/" + pass).c_str(), BM_OptimizerPass, pass)
+            ->DenseRange(kSmall, kHuge)
+            ->Unit(benchmark::kMicrosecond);
+    }
+    return true;
+}();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,47 @@
+#!/bin/sh
+# 性能回归门禁：重复运行基准并与基线比较
+#
+# 用法: perf_gate.sh <perf_gate> <minicompiler_bench> <minicompiler_runtime_bench> <baseline.json> [update]
+#
+# 环境变量:
+#   PERF_GATE_REPETITIONS  每个基准的重复次数（默认5）
+#   PERF_GATE_TOLERANCE    允许的中位数变慢比例（默认0.10）
+#   PERF_GATE_ALPHA        Mann-Whitney检验的显著性水平（默认0.05）
+
+set -eu
+
+if [ $# -lt 4 ]; then
+    echo "Usage: $0 <perf_gate> <minicompiler_bench> <minicompiler_runtime_bench> <baseline.json> [update]" >&2
+    exit 2
+fi
+
+GATE=$1
+COMPILER_BENCH=$2
+RUNTIME_BENCH=$3
+BASELINE=$4
+MODE=${5:-compare}
+
+REPETITIONS=${PERF_GATE_REPETITIONS:-5}
+TOLERANCE=${PERF_GATE_TOLERANCE:-0.10}
+ALPHA=${PERF_GATE_ALPHA:-0.05}
+
+# 编译期：medium规模的词法、语法分析、IR生成和优化；运行时：-O0和-O2下的生成代码
+COMPILER_FILTER='^BM_(Lexer|Parser|IRBuilder|Optimize)/1$'
+RUNTIME_FILTER='^BM_Run/.*/O[02]$'
+
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+
+"$COMPILER_BENCH" --benchmark_filter="$COMPILER_FILTER" \
+    --benchmark_repetitions="$REPETITIONS" --benchmark_enable_random_interleaving=true \
+    --benchmark_out="$OUT/compiler.json" --benchmark_out_format=json > /dev/null
+"$RUNTIME_BENCH" --benchmark_filter="$RUNTIME_FILTER" \
+    --benchmark_repetitions="$REPETITIONS" --benchmark_enable_random_interleaving=true \
+    --benchmark_out="$OUT/runtime.json" --benchmark_out_format=json > /dev/null
+
+if [ "$MODE" = "update" ]; then
+    exec "$GATE" update --baseline="$BASELINE" "$OUT/compiler.json" "$OUT/runtime.json"
+fi
+
+"$GATE" compare --baseline="$BASELINE" --tolerance="$TOLERANCE" --alpha="$ALPHA" \
+    "$OUT/compiler.json" "$OUT/runtime.json"
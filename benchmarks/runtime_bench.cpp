@@ -0,0 +1,138 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+#include "ir/ir_builder.h"
+#include "ir/ir_interpreter.h"
+#include "optimizer/optimizer.h"
+
+using namespace minicompiler;
+
+namespace {
+
+/**
+ * @brief 运行时基准语料中的一个程序：<name>.mc和期望输出<name>.expected
+ */
+struct Kernel {
+    std::string name;
+    std::string source;
+    std::string expected;
+};
+
+std::string readFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    std::ostringstream oss;
+    oss << file.rdbuf();
+    return oss.str();
+}
+
+std::vector<Kernel> loadCorpus(const std::filesystem::path& directory) {
+    std::vector<Kernel> kernels;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.path().extension() != ".mc") {
+            continue;
+        }
+
+        std::filesystem::path expected = entry.path();
+        expected.replace_extension(".expected");
+        kernels.push_back({entry.path().stem().string(), readFile(entry.path()), readFile(expected)});
+    }
+
+    std::sort(kernels.begin(), kernels.end(),
+              [](const Kernel& a, const Kernel& b) { return a.name < b.name; });
+    return kernels;
+}
+
+/**
+ * @brief 在作用域内丢弃std::cout输出（优化器会打印进度信息）
+ */
+class QuietStdout {
+public:
+    QuietStdout() : saved_(std::cout.rdbuf(&null_)) {}
+    ~QuietStdout() { std::cout.rdbuf(saved_); }
+
+private:
+    struct NullBuffer : std::streambuf {
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+
+    NullBuffer null_;
+    std::streambuf* saved_;
+};
+
+std::shared_ptr<IRModule> compile(const Kernel& kernel, int optimizationLevel) {
+    QuietStdout quiet;
+
+    Lexer lexer(kernel.source);
+    Parser parser(lexer.scanTokens());
+    auto program = parser.parse();
+
+    IRBuilder builder(kernel.name);
+    auto module = builder.build(program.get());
+
+    Optimizer optimizer(optimizationLevel);
+    return optimizer.optimize(module);
+}
+
+} // namespace
+
+/**
+ * @brief 在指定优化级别下编译并解释执行一个程序
+ *
+ * 编译只做一次，计时只包含执行。输出与期望不一致时标记为错误，
+ * 避免把错误的优化结果当成性能提升。
+ */
+static void BM_Run(benchmark::State& state, const Kernel& kernel, int optimizationLevel) {
+    auto module = compile(kernel, optimizationLevel);
+
+    std::ostringstream output;
+    IRInterpreter check(module, output);
+    check.run();
+    if (output.str() != kernel.expected) {
+        state.SkipWithError("output does not match expected output");
+        return;
+    }
+
+    uint64_t instructions = check.getInstructionCount();
+    uint64_t calls = check.getCallCount();
+
+    for (auto _ : state) {
+        std::ostringstream discard;
+        IRInterpreter interpreter(module, discard);
+        benchmark::DoNotOptimize(interpreter.run());
+    }
+
+    state.counters["instructions"] = static_cast<double>(instructions);
+    state.counters["calls"] = static_cast<double>(calls);
+    state.counters["instructions/s"] = benchmark::Counter(
+        static_cast<double>(instructions), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+int main(int argc, char** argv) {
+    // 语料在注册基准之前加载，生命周期覆盖整个运行过程
+    static const std::vector<Kernel> kernels = loadCorpus(MINICOMPILER_RUNTIME_CORPUS_DIR);
+
+    for (const auto& kernel : kernels) {
+        for (int level = 0; level <= 2; ++level) {
+            std::string name = "BM_Run/" + kernel.name + "/O" + std::to_string(level);
+            benchmark::RegisterBenchmark(name.c_str(), BM_Run, std::cref(kernel), level)
+                ->Unit(benchmark::kMicrosecond);
+        }
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
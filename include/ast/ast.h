@@ -1,9 +1,11 @@
 #ifndef MINICOMPILER_AST_H
 #define MINICOMPILER_AST_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
+#include "common/string_interner.h"
 #include "common/token.h"
 
 namespace minicompiler {
@@ -11,6 +13,49 @@ namespace minicompiler {
 // 前向声明
 class ASTVisitor;
 
+/**
+ * @brief 表达式的值类型，由语义分析计算
+ */
+enum class ValueType : uint8_t {
+    UNKNOWN,    // 未经语义分析
+    INT,
+    FLOAT,
+    VOID,
+    STRING,     // 字符串字面量，只能作为print的参数
+    ERROR,      // 已报告过错误的表达式，不再引发连锁错误
+};
+
+/**
+ * @brief 类型名称（用于诊断信息）
+ */
+const char* valueTypeName(ValueType type);
+
+/**
+ * @brief AST节点种类
+ *
+ * 表达式、语句各自连续排列，Expression/Literal/Statement::classof依赖这一顺序。
+ */
+enum class ASTNodeKind : uint8_t {
+    // 表达式
+    IntegerLiteral,
+    FloatLiteral,
+    StringLiteral,
+    VariableExpression,
+    BinaryExpression,
+    UnaryExpression,
+    CallExpression,
+    // 语句
+    ExpressionStatement,
+    VarDeclaration,
+    BlockStatement,
+    IfStatement,
+    WhileStatement,
+    ReturnStatement,
+    FunctionDeclaration,
+    // 根节点
+    Program
+};
+
 /**
  * @brief AST节点基类
  */
@@ -18,6 +63,12 @@ class ASTNode {
 public:
     virtual ~ASTNode() = default;
     
+    /**
+     * @brief 获取节点种类，用于ASTWalker的switch分派和isa/dynCast
+     * @return 节点种类
+     */
+    ASTNodeKind getKind() const { return kind_; }
+    
     /**
      * @brief 接受访问者模式的访问方法
      * @param visitor 访问者对象
@@ -29,6 +80,12 @@ public:
      * @return 源代码位置
      */
     virtual SourceLocation getLocation() const = 0;
+    
+protected:
+    explicit ASTNode(ASTNodeKind kind) : kind_(kind) {}
+    
+private:
+    ASTNodeKind kind_;
 };
 
 /**
@@ -37,6 +94,22 @@ public:
 class Expression : public ASTNode {
 public:
     virtual ~Expression() = default;
+    
+    /**
+     * @brief 语义分析得到的类型，未分析时为UNKNOWN
+     */
+    ValueType getType() const { return type_; }
+    void setType(ValueType type) { type_ = type; }
+    
+    static bool classof(const ASTNode* node) {
+        return node->getKind() >= ASTNodeKind::IntegerLiteral && node->getKind() <= ASTNodeKind::CallExpression;
+    }
+    
+protected:
+    explicit Expression(ASTNodeKind kind) : ASTNode(kind) {}
+    
+private:
+    ValueType type_ = ValueType::UNKNOWN;
 };
 
 /**
@@ -45,6 +118,13 @@ public:
 class Statement : public ASTNode {
 public:
     virtual ~Statement() = default;
+    
+    static bool classof(const ASTNode* node) {
+        return node->getKind() >= ASTNodeKind::ExpressionStatement && node->getKind() <= ASTNodeKind::FunctionDeclaration;
+    }
+    
+protected:
+    explicit Statement(ASTNodeKind kind) : ASTNode(kind) {}
 };
 
 /**
@@ -53,6 +133,13 @@ public:
 class Literal : public Expression {
 public:
     virtual ~Literal() = default;
+    
+    static bool classof(const ASTNode* node) {
+        return node->getKind() >= ASTNodeKind::IntegerLiteral && node->getKind() <= ASTNodeKind::StringLiteral;
+    }
+    
+protected:
+    explicit Literal(ASTNodeKind kind) : Expression(kind) {}
 };
 
 /**
@@ -61,13 +148,15 @@ public:
 class IntegerLiteral : public Literal {
 public:
     IntegerLiteral(int value, const SourceLocation& location)
-        : value_(value), location_(location) {}
+        : Literal(ASTNodeKind::IntegerLiteral), value_(value), location_(location) {}
     
     int getValue() const { return value_; }
     SourceLocation getLocation() const override { return location_; }
     
     void accept(ASTVisitor& visitor) override;
     
+    static bool classof(const ASTNode* node) { return node->getKind() == ASTNodeKind::IntegerLiteral; }
+    
 private:
     int value_;
     SourceLocation location_;
@@ -79,13 +168,15 @@ private:
 class FloatLiteral : public Literal {
 public:
     FloatLiteral(float value, const SourceLocation& location)
-        : value_(value), location_(location) {}
+        : Literal(ASTNodeKind::FloatLiteral), value_(value), location_(location) {}
     
     float getValue() const { return value_; }
     SourceLocation getLocation() const override { return location_; }
     
     void accept(ASTVisitor& visitor) override;
     
+    static bool classof(const ASTNode* node) { return node->getKind() == ASTNodeKind::FloatLiteral; }
+    
 private:
     float value_;
     SourceLocation location_;
@@ -97,13 +188,15 @@ private:
 class StringLiteral : public Literal {
 public:
     StringLiteral(const std::string& value, const SourceLocation& location)
-        : value_(value), location_(location) {}
+        : Literal(ASTNodeKind::StringLiteral), value_(value), location_(location) {}
     
     const std::string& getValue() const { return value_; }
     SourceLocation getLocation() const override { return location_; }
     
     void accept(ASTVisitor& visitor) override;
     
+    static bool classof(const ASTNode* node) { return node->getKind() == ASTNodeKind::StringLiteral; }
+    
 private:
     std::string value_;
     SourceLocation location_;
@@ -115,16 +208,25 @@ private:
 class VariableExpression : public Expression {
 public:
     VariableExpression(const std::string& name, const SourceLocation& location)
-        : name_(name), location_(location) {}
+        : Expression(ASTNodeKind::VariableExpression), name_(name), location_(location) {}
     
     const std::string& getName() const { return name_; }
     SourceLocation getLocation() const override { return location_; }
     
+    /**
+     * @brief 名字在Program驻留表中的编号，未驻留时为kNoSymbol
+     */
+    Symbol getSymbol() const { return symbol_; }
+    void setSymbol(Symbol symbol) { symbol_ = symbol; }
+    
     void accept(ASTVisitor& visitor) override;
     
+    static bool classof(const ASTNode* node) { return node->getKind() == ASTNodeKind::VariableExpression; }
+    
 private:
     std::string name_;
     SourceLocation location_;
+    Symbol symbol_ = kNoSymbol;
 };
 
 /**
@@ -134,7 +236,7 @@ class BinaryExpression : public Expression {
 public:
     BinaryExpression(std::unique_ptr<Expression> left, TokenType op, 
                     std::unique_ptr<Expression> right, const SourceLocation& location)
-        : left_(std::move(left)), operator_(op), right_(std::move(right)), location_(location) {}
+        : Expression(ASTNodeKind::BinaryExpression), left_(std::move(left)), operator_(op), right_(std::move(right)), location_(location) {}
     
     Expression* getLeft() const { return left_.get(); }
     TokenType getOperator() const { return operator_; }
@@ -143,6 +245,8 @@ public:
     
     void accept(ASTVisitor& visitor) override;
     
+    static bool classof(const ASTNode* node) { return node->getKind() == ASTNodeKind::BinaryExpression; }
+    
 private:
     std::unique_ptr<Expression> left_;
     TokenType operator_;
@@ -156,7 +260,7 @@ private:
 class UnaryExpression : public Expression {
 public:
     UnaryExpression(TokenType op, std::unique_ptr<Expression> operand, const SourceLocation& location)
-        : operator_(op), operand_(std::move(operand)), location_(location) {}
+        : Expression(ASTNodeKind::UnaryExpression), operator_(op), operand_(std::move(operand)), location_(location) {}
     
     TokenType getOperator() const { return operator_; }
     Expression* getOperand() const { return operand_.get(); }
@@ -164,6 +268,8 @@ public:
     
     void accept(ASTVisitor& visitor) override;
     
+    static bool classof(const ASTNode* node) { return node->getKind() == ASTNodeKind::UnaryExpression; }
+    
 private:
     TokenType operator_;
     std::unique_ptr<Expression> operand_;
@@ -177,7 +283,7 @@ class CallExpression : public Expression {
 public:
     CallExpression(const std::string& callee, std::vector<std::unique_ptr<Expression>> arguments,
                   const SourceLocation& location)
-        : callee_(callee), arguments_(std::move(arguments)), location_(location) {}
+        : Expression(ASTNodeKind::CallExpression), callee_(callee), arguments_(std::move(arguments)), location_(location) {}
     
     const std::string& getCallee() const { return callee_; }
     const std::vector<std::unique_ptr<Expression>>& getArguments() const { return arguments_; }
@@ -185,6 +291,8 @@ public:
     
     void accept(ASTVisitor& visitor) override;
     
+    static bool classof(const ASTNode* node) { return node->getKind() == ASTNodeKind::CallExpression; }
+    
 private:
     std::string callee_;
     std::vector<std::unique_ptr<Expression>> arguments_;
@@ -197,13 +305,15 @@ private:
 class ExpressionStatement : public Statement {
 public:
     ExpressionStatement(std::unique_ptr<Expression> expression)
-        : expression_(std::move(expression)) {}
+        : Statement(ASTNodeKind::ExpressionStatement), expression_(std::move(expression)) {}
     
     Expression* getExpression() const { return expression_.get(); }
     SourceLocation getLocation() const override { return expression_->getLocation(); }
     
     void accept(ASTVisitor& visitor) override;
     
+    static bool classof(const ASTNode* node) { return node->getKind() == ASTNodeKind::ExpressionStatement; }
+    
 private:
     std::unique_ptr<Expression> expression_;
 };
@@ -215,20 +325,29 @@ class VarDeclaration : public Statement {
 public:
     VarDeclaration(const std::string& type, const std::string& name, 
                   std::unique_ptr<Expression> initializer, const SourceLocation& location)
-        : type_(type), name_(name), initializer_(std::move(initializer)), location_(location) {}
+        : Statement(ASTNodeKind::VarDeclaration), type_(type), name_(name), initializer_(std::move(initializer)), location_(location) {}
     
     const std::string& getType() const { return type_; }
     const std::string& getName() const { return name_; }
     Expression* getInitializer() const { return initializer_.get(); }
     SourceLocation getLocation() const override { return location_; }
     
+    /**
+     * @brief 名字在Program驻留表中的编号，未驻留时为kNoSymbol
+     */
+    Symbol getSymbol() const { return symbol_; }
+    void setSymbol(Symbol symbol) { symbol_ = symbol; }
+    
     void accept(ASTVisitor& visitor) override;
     
+    static bool classof(const ASTNode* node) { return node->getKind() == ASTNodeKind::VarDeclaration; }
+    
 private:
     std::string type_;
     std::string name_;
     std::unique_ptr<Expression> initializer_;
     SourceLocation location_;
+    Symbol symbol_ = kNoSymbol;
 };
 
 /**
@@ -237,13 +356,15 @@ private:
 class BlockStatement : public Statement {
 public:
     BlockStatement(std::vector<std::unique_ptr<Statement>> statements, const SourceLocation& location)
-        : statements_(std::move(statements)), location_(location) {}
+        : Statement(ASTNodeKind::BlockStatement), statements_(std::move(statements)), location_(location) {}
     
     const std::vector<std::unique_ptr<Statement>>& getStatements() const { return statements_; }
     SourceLocation getLocation() const override { return location_; }
     
     void accept(ASTVisitor& visitor) override;
     
+    static bool classof(const ASTNode* node) { return node->getKind() == ASTNodeKind::BlockStatement; }
+    
 private:
     std::vector<std::unique_ptr<Statement>> statements_;
     SourceLocation location_;
@@ -258,7 +379,7 @@ public:
                std::unique_ptr<Statement> thenBranch,
                std::unique_ptr<Statement> elseBranch,
                const SourceLocation& location)
-        : condition_(std::move(condition)), 
+        : Statement(ASTNodeKind::IfStatement), condition_(std::move(condition)), 
           thenBranch_(std::move(thenBranch)), 
           elseBranch_(std::move(elseBranch)), 
           location_(location) {}
@@ -270,6 +391,8 @@ public:
     
     void accept(ASTVisitor& visitor) override;
     
+    static bool classof(const ASTNode* node) { return node->getKind() == ASTNodeKind::IfStatement; }
+    
 private:
     std::unique_ptr<Expression> condition_;
     std::unique_ptr<Statement> thenBranch_;
@@ -285,7 +408,7 @@ public:
     WhileStatement(std::unique_ptr<Expression> condition, 
                   std::unique_ptr<Statement> body,
                   const SourceLocation& location)
-        : condition_(std::move(condition)), body_(std::move(body)), location_(location) {}
+        : Statement(ASTNodeKind::WhileStatement), condition_(std::move(condition)), body_(std::move(body)), location_(location) {}
     
     Expression* getCondition() const { return condition_.get(); }
     Statement* getBody() const { return body_.get(); }
@@ -293,6 +416,8 @@ public:
     
     void accept(ASTVisitor& visitor) override;
     
+    static bool classof(const ASTNode* node) { return node->getKind() == ASTNodeKind::WhileStatement; }
+    
 private:
     std::unique_ptr<Expression> condition_;
     std::unique_ptr<Statement> body_;
@@ -305,13 +430,15 @@ private:
 class ReturnStatement : public Statement {
 public:
     ReturnStatement(std::unique_ptr<Expression> value, const SourceLocation& location)
-        : value_(std::move(value)), location_(location) {}
+        : Statement(ASTNodeKind::ReturnStatement), value_(std::move(value)), location_(location) {}
     
     Expression* getValue() const { return value_.get(); }
     SourceLocation getLocation() const override { return location_; }
     
     void accept(ASTVisitor& visitor) override;
     
+    static bool classof(const ASTNode* node) { return node->getKind() == ASTNodeKind::ReturnStatement; }
+    
 private:
     std::unique_ptr<Expression> value_;
     SourceLocation location_;
@@ -324,13 +451,14 @@ struct FunctionParameter {
     std::string type;
     std::string name;
     SourceLocation location;
+    Symbol symbol = kNoSymbol;  // 名字在Program驻留表中的编号
     
     FunctionParameter(const std::string& t, const std::string& n, const SourceLocation& loc)
         : type(t), name(n), location(loc) {}
 };
 
 /**
- * @brief 函数声明
+ * @brief 函数声明；以分号结尾的原型没有函数体，getBody()返回nullptr
  */
 class FunctionDeclaration : public Statement {
 public:
@@ -339,7 +467,7 @@ public:
                        std::vector<FunctionParameter> parameters,
                        std::unique_ptr<BlockStatement> body,
                        const SourceLocation& location)
-        : returnType_(returnType), 
+        : Statement(ASTNodeKind::FunctionDeclaration), returnType_(returnType), 
           name_(name), 
           parameters_(std::move(parameters)), 
           body_(std::move(body)), 
@@ -348,11 +476,15 @@ public:
     const std::string& getReturnType() const { return returnType_; }
     const std::string& getName() const { return name_; }
     const std::vector<FunctionParameter>& getParameters() const { return parameters_; }
+    void setParameterSymbol(size_t index, Symbol symbol) { parameters_[index].symbol = symbol; }
     BlockStatement* getBody() const { return body_.get(); }
+    void setBody(std::unique_ptr<BlockStatement> body) { body_ = std::move(body); }
     SourceLocation getLocation() const override { return location_; }
     
     void accept(ASTVisitor& visitor) override;
     
+    static bool classof(const ASTNode* node) { return node->getKind() == ASTNodeKind::FunctionDeclaration; }
+    
 private:
     std::string returnType_;
     std::string name_;
@@ -367,17 +499,26 @@ private:
 class Program : public ASTNode {
 public:
     Program(std::vector<std::unique_ptr<Statement>> statements)
-        : statements_(std::move(statements)) {}
+        : ASTNode(ASTNodeKind::Program), statements_(std::move(statements)) {}
     
     const std::vector<std::unique_ptr<Statement>>& getStatements() const { return statements_; }
     SourceLocation getLocation() const override { 
         return statements_.empty() ? SourceLocation() : statements_[0]->getLocation(); 
     }
     
+    /**
+     * @brief 标识符驻留表，节点中的Symbol都是它分配的编号；手工构造的AST可能没有
+     */
+    const std::shared_ptr<StringInterner>& getInterner() const { return interner_; }
+    void setInterner(std::shared_ptr<StringInterner> interner) { interner_ = std::move(interner); }
+    
     void accept(ASTVisitor& visitor) override;
     
+    static bool classof(const ASTNode* node) { return node->getKind() == ASTNodeKind::Program; }
+    
 private:
     std::vector<std::unique_ptr<Statement>> statements_;
+    std::shared_ptr<StringInterner> interner_;
 };
 
 /**
@@ -404,6 +545,27 @@ public:
     virtual void visit(Program* node) = 0;
 };
 
+/**
+ * @brief 判断节点是否为T类型（按节点种类比较，不使用RTTI）
+ */
+template <typename T>
+inline bool isa(const ASTNode* node) {
+    return node && T::classof(node);
+}
+
+/**
+ * @brief 按节点种类做向下转换，类型不符时返回nullptr
+ */
+template <typename T>
+inline T* dynCast(ASTNode* node) {
+    return isa<T>(node) ? static_cast<T*>(node) : nullptr;
+}
+
+template <typename T>
+inline const T* dynCast(const ASTNode* node) {
+    return isa<T>(node) ? static_cast<const T*>(node) : nullptr;
+}
+
 } // namespace minicompiler
 
 #endif // MINICOMPILER_AST_H 
\ No newline at end of file
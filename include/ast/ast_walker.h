@@ -0,0 +1,133 @@
+#ifndef MINICOMPILER_AST_WALKER_H
+#define MINICOMPILER_AST_WALKER_H
+
+#include "ast/ast.h"
+
+namespace minicompiler {
+
+/**
+ * @brief 基于节点种类switch分派的AST遍历框架（CRTP）
+ *
+ * 与ASTVisitor的accept/visit双重虚调用不同，walk按getKind()分派到
+ * Derived::visit，调用在编译期确定，可以内联，也不依赖RTTI。
+ * IRBuilder等热路径上的遍历器应当使用它；ASTVisitor保留给需要运行时多态的场合。
+ *
+ * 用法：
+ * @code
+ * class MyWalker : public ASTWalker<MyWalker> {
+ * public:
+ *     using ASTWalker<MyWalker>::visit;      // 保留未覆盖节点的默认遍历
+ *     void visit(CallExpression* node) { ... }
+ * };
+ * @endcode
+ *
+ * 默认的visit依次walk所有子节点，Derived只需覆盖关心的节点；
+ * 覆盖walk本身可以在每个节点上挂钩（例如计数），默认实现中的子节点遍历同样经过它。
+ */
+template <typename Derived>
+class ASTWalker {
+public:
+    /**
+     * @brief 按节点种类分派到Derived::visit
+     * @param node AST节点
+     */
+    void walk(ASTNode* node) {
+        Derived& self = derived();
+        switch (node->getKind()) {
+            case ASTNodeKind::IntegerLiteral: self.visit(static_cast<IntegerLiteral*>(node)); break;
+            case ASTNodeKind::FloatLiteral: self.visit(static_cast<FloatLiteral*>(node)); break;
+            case ASTNodeKind::StringLiteral: self.visit(static_cast<StringLiteral*>(node)); break;
+            case ASTNodeKind::VariableExpression: self.visit(static_cast<VariableExpression*>(node)); break;
+            case ASTNodeKind::BinaryExpression: self.visit(static_cast<BinaryExpression*>(node)); break;
+            case ASTNodeKind::UnaryExpression: self.visit(static_cast<UnaryExpression*>(node)); break;
+            case ASTNodeKind::CallExpression: self.visit(static_cast<CallExpression*>(node)); break;
+            case ASTNodeKind::ExpressionStatement: self.visit(static_cast<ExpressionStatement*>(node)); break;
+            case ASTNodeKind::VarDeclaration: self.visit(static_cast<VarDeclaration*>(node)); break;
+            case ASTNodeKind::BlockStatement: self.visit(static_cast<BlockStatement*>(node)); break;
+            case ASTNodeKind::IfStatement: self.visit(static_cast<IfStatement*>(node)); break;
+            case ASTNodeKind::WhileStatement: self.visit(static_cast<WhileStatement*>(node)); break;
+            case ASTNodeKind::ReturnStatement: self.visit(static_cast<ReturnStatement*>(node)); break;
+            case ASTNodeKind::FunctionDeclaration: self.visit(static_cast<FunctionDeclaration*>(node)); break;
+            case ASTNodeKind::Program: self.visit(static_cast<Program*>(node)); break;
+        }
+    }
+
+    // 默认实现：遍历子节点
+    void visit(IntegerLiteral*) {}
+    void visit(FloatLiteral*) {}
+    void visit(StringLiteral*) {}
+    void visit(VariableExpression*) {}
+
+    void visit(BinaryExpression* node) {
+        derived().walk(node->getLeft());
+        derived().walk(node->getRight());
+    }
+
+    void visit(UnaryExpression* node) {
+        derived().walk(node->getOperand());
+    }
+
+    void visit(CallExpression* node) {
+        for (const auto& arg : node->getArguments()) {
+            derived().walk(arg.get());
+        }
+    }
+
+    void visit(ExpressionStatement* node) {
+        derived().walk(node->getExpression());
+    }
+
+    void visit(VarDeclaration* node) {
+        if (node->getInitializer()) {
+            derived().walk(node->getInitializer());
+        }
+    }
+
+    void visit(BlockStatement* node) {
+        for (const auto& stmt : node->getStatements()) {
+            derived().walk(stmt.get());
+        }
+    }
+
+    void visit(IfStatement* node) {
+        derived().walk(node->getCondition());
+        derived().walk(node->getThenBranch());
+        if (node->getElseBranch()) {
+            derived().walk(node->getElseBranch());
+        }
+    }
+
+    void visit(WhileStatement* node) {
+        derived().walk(node->getCondition());
+        derived().walk(node->getBody());
+    }
+
+    void visit(ReturnStatement* node) {
+        if (node->getValue()) {
+            derived().walk(node->getValue());
+        }
+    }
+
+    void visit(FunctionDeclaration* node) {
+        if (node->getBody()) {
+            derived().walk(node->getBody());
+        }
+    }
+
+    void visit(Program* node) {
+        for (const auto& stmt : node->getStatements()) {
+            derived().walk(stmt.get());
+        }
+    }
+
+protected:
+    ASTWalker() = default;
+    ~ASTWalker() = default;
+
+private:
+    Derived& derived() { return static_cast<Derived&>(*this); }
+};
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_AST_WALKER_H
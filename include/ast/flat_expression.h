@@ -0,0 +1,114 @@
+#ifndef MINICOMPILER_FLAT_EXPRESSION_H
+#define MINICOMPILER_FLAT_EXPRESSION_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ast/ast.h"
+
+namespace minicompiler {
+
+/**
+ * @brief 扁平化的表达式节点
+ *
+ * 节点按后序存放，子节点总在父节点之前，以下标引用。
+ * 赋值的左侧不单独成节点，目标变量名记在name中。
+ */
+struct FlatExpr {
+    ASTNodeKind kind;
+    ValueType type = ValueType::UNKNOWN;  // 语义分析得到的类型
+    TokenType op = TokenType::UNKNOWN;  // 二元/一元运算符，赋值为ASSIGN
+    uint32_t lhs = 0;                   // 左操作数/一元操作数；调用时为首个参数在参数表中的下标
+    uint32_t rhs = 0;                   // 右操作数/赋值的值；调用时为参数个数
+    union {
+        int32_t intValue;
+        float floatValue;
+        uint32_t name;                  // 变量名/被调函数/赋值目标/字符串字面量在名字表中的下标
+    };
+
+    explicit FlatExpr(ASTNodeKind k) : kind(k), intValue(0) {}
+};
+
+/**
+ * @brief 一个函数内所有表达式的扁平化表示
+ *
+ * build按语句顺序展平函数中的每个表达式根（表达式语句、变量初始化、
+ * if/while条件、return值），各表达式占据nodes中连续的一段。
+ * 条件中的&&、||和!按IRBuilder::emitCondition的方式拆开，分别展平各个操作数；
+ * 值上下文中的&&、||需要短路控制流，不展平。
+ * 名字直接引用AST中的字符串，AST必须比表格活得久。
+ */
+class FlatExpressionTable {
+public:
+    /**
+     * @brief 一个表达式根在nodes中的范围，根节点位于end - 1
+     */
+    struct Range {
+        const Expression* root;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    /**
+     * @brief 展平函数体中的所有表达式，替换之前的内容
+     * @param function 函数声明
+     */
+    void build(FunctionDeclaration* function);
+
+    /**
+     * @brief 按build时的顺序取下一个表达式
+     * @param root 调用方即将求值的表达式
+     * @return root对应的范围；root不是下一个已展平的表达式时返回nullptr
+     */
+    const Range* next(const Expression* root) {
+        if (cursor_ < ranges_.size() && ranges_[cursor_].root == root) {
+            return &ranges_[cursor_++];
+        }
+        return nullptr;
+    }
+
+    const FlatExpr& node(uint32_t index) const { return nodes_[index]; }
+    const std::string& name(uint32_t index) const { return *names_[index]; }
+    Symbol symbol(uint32_t index) const { return symbols_[index]; }
+    uint32_t argument(uint32_t index) const { return arguments_[index]; }
+
+    size_t size() const { return nodes_.size(); }
+    size_t expressionCount() const { return ranges_.size(); }
+
+    void clear();
+
+private:
+    friend class FlatExpressionCollector;
+
+    /**
+     * @brief 展平一个表达式根，无法展平时回滚并返回false
+     */
+    bool add(Expression* root);
+
+    /**
+     * @brief 按短路控制流拆开条件后展平各部分
+     */
+    void addCondition(Expression* condition);
+
+    /**
+     * @brief 按后序追加节点
+     * @return 子树根节点的下标
+     */
+    uint32_t flatten(Expression* expr, bool& ok);
+
+    uint32_t addName(const std::string& name, Symbol symbol = kNoSymbol);
+
+    std::vector<FlatExpr> nodes_;
+    std::vector<const std::string*> names_;
+    std::vector<Symbol> symbols_;       // 与names_一一对应，被调函数名为kNoSymbol
+    std::vector<uint32_t> arguments_;
+    std::vector<Range> ranges_;
+    size_t cursor_ = 0;
+
+    // 展开调用时暂存参数根的下标
+    std::vector<uint32_t> pending_;
+};
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_FLAT_EXPRESSION_H
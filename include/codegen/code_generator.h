@@ -3,6 +3,8 @@
 
 #include <string>
 #include <memory>
+#include <ostream>
+#include "common/cancellation.h"
 #include "ir/ir.h"
 
 namespace minicompiler {
@@ -26,8 +28,31 @@ public:
      */
     bool generate(std::shared_ptr<IRModule> module, const std::string& outputFile);
     
+    /**
+     * @brief 设置并行代码生成的分区数
+     * @param jobs 分区数，1表示串行生成
+     */
+    void setParallelJobs(unsigned jobs) { jobs_ = jobs; }
+    
+    /**
+     * @brief 设置输出进度信息的流
+     * @param progress 输出流，默认为std::cout，为nullptr时不输出
+     */
+    void setProgressStream(std::ostream* progress) { progress_ = progress; }
+    
+    /**
+     * @brief 设置取消标志，在生成每个函数之前检查
+     *
+     * 已取消时generate删除写了一半的输出文件并抛出CompilationCancelled。
+     * @param token 取消标志，为nullptr时不检查
+     */
+    void setCancellationToken(const CancellationToken* token) { cancellation_ = token; }
+    
 private:
     std::string targetTriple_;
+    unsigned jobs_ = 1;
+    std::ostream* progress_;
+    const CancellationToken* cancellation_ = nullptr;
     
     // 寄存器分配
     void allocateRegisters(std::shared_ptr<IRFunction> function);
@@ -35,8 +60,11 @@ private:
     // 指令选择
     void selectInstructions(std::shared_ptr<IRFunction> function);
     
-    // 生成汇编代码
-    std::string generateAssembly(std::shared_ptr<IRModule> module);
+    // 生成汇编代码并流式写入输出流
+    void emitAssembly(std::shared_ptr<IRModule> module, std::ostream& os);
+    
+    // 生成单个函数的汇编代码
+    void emitFunctionAssembly(std::shared_ptr<IRFunction> function, std::ostream& os);
 };
 
 } // namespace minicompiler
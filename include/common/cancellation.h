@@ -0,0 +1,51 @@
+#ifndef MINICOMPILER_CANCELLATION_H
+#define MINICOMPILER_CANCELLATION_H
+
+#include <atomic>
+#include <stdexcept>
+
+namespace minicompiler {
+
+/**
+ * @brief 编译被取消时抛出的异常
+ */
+class CompilationCancelled : public std::runtime_error {
+public:
+    CompilationCancelled() : std::runtime_error("Compilation cancelled") {}
+};
+
+/**
+ * @brief 协作式取消标志
+ *
+ * 任意线程都可以调用cancel()；编译的各个阶段在函数和pass的边界上检查标志，
+ * 发现已取消时抛出CompilationCancelled，已经完成的工作直接丢弃。
+ */
+class CancellationToken {
+public:
+    /**
+     * @brief 请求取消
+     */
+    void cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief 是否已经请求取消
+     */
+    bool isCancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> cancelled_{false};
+};
+
+/**
+ * @brief 已经请求取消时抛出CompilationCancelled
+ * @param token 取消标志，为nullptr时不检查
+ */
+inline void throwIfCancelled(const CancellationToken* token) {
+    if (token && token->isCancelled()) {
+        throw CompilationCancelled();
+    }
+}
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_CANCELLATION_H
@@ -0,0 +1,74 @@
+#ifndef MINICOMPILER_JSON_H
+#define MINICOMPILER_JSON_H
+
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace minicompiler {
+
+/**
+ * @brief JSON解析错误异常类
+ */
+class JsonError : public std::runtime_error {
+public:
+    JsonError(const std::string& message, size_t offset)
+        : std::runtime_error(message + " at offset " + std::to_string(offset)) {}
+};
+
+/**
+ * @brief 最小的JSON值，只支持性能门禁读取基准结果和基线、批量编译读取NDJSON记录所需的功能
+ */
+class JsonValue {
+public:
+    enum class Kind { Null, Bool, Number, String, Array, Object };
+
+    JsonValue() = default;
+
+    /**
+     * @brief 解析JSON文本
+     * @param text JSON文本
+     * @return 根值
+     */
+    static JsonValue parse(const std::string& text);
+
+    Kind getKind() const { return kind_; }
+    bool isNull() const { return kind_ == Kind::Null; }
+    bool isNumber() const { return kind_ == Kind::Number; }
+    bool isString() const { return kind_ == Kind::String; }
+    bool isArray() const { return kind_ == Kind::Array; }
+    bool isObject() const { return kind_ == Kind::Object; }
+
+    bool asBool() const { return boolValue_; }
+    double asNumber() const { return number_; }
+    const std::string& asString() const { return string_; }
+    const std::vector<JsonValue>& asArray() const { return array_; }
+    const std::map<std::string, JsonValue>& asObject() const { return object_; }
+
+    /**
+     * @brief 按键查找对象成员
+     * @return 成员，不存在或不是对象时返回nullptr
+     */
+    const JsonValue* find(const std::string& key) const;
+
+private:
+    friend class JsonReader;
+
+    Kind kind_ = Kind::Null;
+    bool boolValue_ = false;
+    double number_ = 0.0;
+    std::string string_;
+    std::vector<JsonValue> array_;
+    std::map<std::string, JsonValue> object_;
+};
+
+/**
+ * @brief 把字符串转义后写成JSON字符串字面量
+ */
+std::string jsonQuote(const std::string& text);
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_JSON_H
@@ -0,0 +1,55 @@
+#ifndef MINICOMPILER_OUTPUT_FILE_H
+#define MINICOMPILER_OUTPUT_FILE_H
+
+#include <fstream>
+#include <string>
+
+namespace minicompiler {
+
+/**
+ * @brief 带大缓冲区的输出文件
+ *
+ * IR和汇编直接流式写入文件，不在内存中拼接完整文本。
+ * 每个线程复用同一块缓冲区，同一线程同时打开多个文件时后打开的文件使用独立缓冲区。
+ */
+class OutputFile {
+public:
+    /**
+     * @brief 构造函数，打开（截断）输出文件
+     * @param path 文件路径
+     */
+    explicit OutputFile(const std::string& path);
+
+    ~OutputFile();
+
+    OutputFile(const OutputFile&) = delete;
+    OutputFile& operator=(const OutputFile&) = delete;
+
+    /**
+     * @brief 文件是否成功打开
+     */
+    bool isOpen() const { return file_.is_open(); }
+
+    /**
+     * @brief 获取输出流
+     */
+    std::ostream& stream() { return file_; }
+
+    /**
+     * @brief 刷新缓冲区并关闭文件
+     * @return 全部内容是否写入成功
+     */
+    bool close();
+
+private:
+    // 缓冲区大小
+    static constexpr size_t kBufferSize = 1 << 20;
+
+    std::ofstream file_;
+    char* buffer_ = nullptr;
+    bool ownsBuffer_ = false;
+};
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_OUTPUT_FILE_H
@@ -0,0 +1,89 @@
+#ifndef MINICOMPILER_PERF_COUNTERS_H
+#define MINICOMPILER_PERF_COUNTERS_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace minicompiler {
+
+/**
+ * @brief 采集的硬件计数器
+ */
+enum class PerfCounter {
+    CYCLES,
+    INSTRUCTIONS,
+    BRANCH_MISSES,
+    L1D_MISSES,
+    LLC_MISSES,
+    DTLB_MISSES,
+    COUNT
+};
+
+constexpr size_t kPerfCounterCount = static_cast<size_t>(PerfCounter::COUNT);
+
+/**
+ * @brief 一段区间内的计数器读数，不可用的计数器没有值
+ */
+struct PerfCounterValues {
+    std::array<uint64_t, kPerfCounterCount> values{};
+    std::array<bool, kPerfCounterCount> available{};
+
+    bool has(PerfCounter counter) const { return available[static_cast<size_t>(counter)]; }
+    uint64_t get(PerfCounter counter) const { return values[static_cast<size_t>(counter)]; }
+
+    /**
+     * @brief 累加另一段区间的读数，任一方不可用的计数器结果也不可用
+     */
+    PerfCounterValues& operator+=(const PerfCounterValues& other);
+};
+
+/**
+ * @brief 基于Linux perf_event_open的硬件计数器
+ *
+ * 计数器只统计用户态，覆盖调用线程及其之后创建的线程。
+ * 每个计数器单独打开，容器或虚拟机中不支持的计数器直接标记为不可用，
+ * 全部不可用时start/stop为空操作。非Linux平台上所有计数器都不可用。
+ */
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+     * @brief 是否至少有一个计数器可用
+     */
+    bool isAvailable() const;
+
+    /**
+     * @brief 没有任何计数器可用时的原因
+     */
+    const std::string& getError() const { return error_; }
+
+    /**
+     * @brief 清零并开始计数
+     */
+    void start();
+
+    /**
+     * @brief 停止计数并读取
+     * @return 自上次start以来的读数（计数器被复用时按运行时间比例换算）
+     */
+    PerfCounterValues stop();
+
+    /**
+     * @brief 计数器名称
+     */
+    static const char* name(PerfCounter counter);
+
+private:
+    std::array<int, kPerfCounterCount> fds_;
+    std::string error_;
+};
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_PERF_COUNTERS_H
@@ -0,0 +1,112 @@
+#ifndef MINICOMPILER_SCOPED_SYMBOL_TABLE_H
+#define MINICOMPILER_SCOPED_SYMBOL_TABLE_H
+
+#include <cstdint>
+#include <vector>
+#include "common/string_interner.h"
+
+namespace minicompiler {
+
+/**
+ * @brief 按词法作用域嵌套的符号表，以驻留编号为键
+ *
+ * 所有作用域的声明按声明顺序放在一个数组中，head_[symbol]指向该名字当前可见的声明，
+ * 每个声明记录被它遮蔽的上一个声明。因此：
+ * - 查找是一次数组访问，不哈希字符串；
+ * - pushScope只记录数组长度，O(1)；
+ * - popScope截断数组并恢复被遮蔽的声明，均摊到每个声明O(1)。
+ *
+ * @tparam Value 声明携带的值
+ */
+template <typename Value>
+class ScopedSymbolTable {
+public:
+    /**
+     * @brief 进入新的作用域
+     */
+    void pushScope() { scopes_.push_back(entries_.size()); }
+
+    /**
+     * @brief 离开当前作用域，丢弃其中的声明
+     */
+    void popScope() {
+        size_t mark = scopes_.back();
+        scopes_.pop_back();
+        while (entries_.size() > mark) {
+            const Entry& entry = entries_.back();
+            head_[entry.symbol] = entry.shadowed;
+            entries_.pop_back();
+        }
+    }
+
+    /**
+     * @brief 在当前作用域声明名字，遮蔽外层（或本层之前）的同名声明
+     * @param symbol 名字的驻留编号
+     * @param value 声明的值
+     */
+    void declare(Symbol symbol, Value value) {
+        if (symbol >= head_.size()) {
+            head_.resize(static_cast<size_t>(symbol) + 1, kNone);
+        }
+        entries_.push_back(Entry{symbol, head_[symbol], std::move(value)});
+        head_[symbol] = static_cast<uint32_t>(entries_.size() - 1);
+    }
+
+    /**
+     * @brief 查找当前可见的声明
+     * @return 声明的值，未声明时返回nullptr
+     */
+    Value* lookup(Symbol symbol) {
+        if (symbol >= head_.size() || head_[symbol] == kNone) {
+            return nullptr;
+        }
+        return &entries_[head_[symbol]].value;
+    }
+
+    const Value* lookup(Symbol symbol) const {
+        return const_cast<ScopedSymbolTable*>(this)->lookup(symbol);
+    }
+
+    /**
+     * @brief 名字是否在当前（最内层）作用域中声明过
+     */
+    bool isDeclaredInCurrentScope(Symbol symbol) const {
+        if (symbol >= head_.size() || head_[symbol] == kNone) {
+            return false;
+        }
+        return scopes_.empty() || head_[symbol] >= scopes_.back();
+    }
+
+    /**
+     * @brief 作用域嵌套深度
+     */
+    size_t depth() const { return scopes_.size(); }
+
+    /**
+     * @brief 清空所有作用域和声明，保留已分配的容量
+     */
+    void clear() {
+        for (const Entry& entry : entries_) {
+            head_[entry.symbol] = kNone;
+        }
+        entries_.clear();
+        scopes_.clear();
+    }
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct Entry {
+        Symbol symbol;
+        uint32_t shadowed;  // 被遮蔽的声明在entries_中的下标
+        Value value;
+    };
+
+    std::vector<Entry> entries_;
+    std::vector<size_t> scopes_;
+    std::vector<uint32_t> head_;
+};
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_SCOPED_SYMBOL_TABLE_H
@@ -0,0 +1,81 @@
+#ifndef MINICOMPILER_STRING_INTERNER_H
+#define MINICOMPILER_STRING_INTERNER_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace minicompiler {
+
+/**
+ * @brief 驻留字符串的编号，同一驻留表中相同的字符串编号相同
+ *
+ * 编号从0开始连续分配，可以直接用作数组下标。
+ */
+using Symbol = uint32_t;
+
+constexpr Symbol kNoSymbol = UINT32_MAX;
+
+/**
+ * @brief 字符串驻留表
+ *
+ * 解析器把每个标识符驻留一次，之后的符号表查找按编号进行，不再哈希字符串。
+ * 索引是线性探测的开放寻址表，槽位只存哈希值和编号，探测时很少需要比较字符串。
+ * 不是线程安全的。
+ */
+class StringInterner {
+public:
+    StringInterner() = default;
+
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    /**
+     * @brief 驻留字符串
+     * @param text 字符串
+     * @return 字符串的编号
+     */
+    Symbol intern(std::string_view text);
+
+    /**
+     * @brief 查找已驻留的字符串
+     * @return 字符串的编号，未驻留时返回kNoSymbol
+     */
+    Symbol find(std::string_view text) const;
+
+    /**
+     * @brief 编号对应的字符串
+     */
+    const std::string& str(Symbol symbol) const { return strings_[symbol]; }
+
+    size_t size() const { return strings_.size(); }
+
+    /**
+     * @brief 删除所有字符串，保留索引的容量，编号重新从0开始
+     */
+    void clear();
+
+private:
+    struct Slot {
+        uint32_t hash;
+        Symbol symbol;      // 空槽为kNoSymbol
+    };
+
+    static uint32_t hash(std::string_view text);
+
+    /**
+     * @brief 查找text所在的槽，未驻留时返回应插入的空槽
+     */
+    Slot& probe(std::string_view text, uint32_t h);
+
+    void grow();
+
+    std::deque<std::string> strings_;
+    std::vector<Slot> slots_;   // 容量是2的幂，装载率不超过1/2
+};
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_STRING_INTERNER_H
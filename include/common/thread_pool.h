@@ -0,0 +1,74 @@
+#ifndef MINICOMPILER_THREAD_POOL_H
+#define MINICOMPILER_THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace minicompiler {
+
+/**
+ * @brief 固定大小的线程池
+ *
+ * 工作线程在构造时创建、析构时回收，可以在多次编译之间复用。
+ * 在工作线程内部再次调用parallelFor时直接串行执行，避免互相等待造成死锁。
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief 构造函数
+     * @param threadCount 工作线程数，0表示使用硬件并发数
+     */
+    explicit ThreadPool(unsigned threadCount = 0);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief 获取工作线程数
+     * @return 工作线程数
+     */
+    unsigned getThreadCount() const { return static_cast<unsigned>(workers_.size()); }
+
+    /**
+     * @brief 并行执行body(0) ... body(count - 1)并等待全部完成
+     * @param count 任务数
+     * @param body 任务函数，第一个抛出的异常会在调用线程中重新抛出
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    /**
+     * @brief 提交一个异步任务
+     * @param task 任务函数
+     * @return 任务结果的future
+     */
+    template <typename F>
+    auto submit(F task) -> std::future<decltype(task())> {
+        using Result = decltype(task());
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+        std::future<Result> future = packaged->get_future();
+        enqueue([packaged]() { (*packaged)(); });
+        return future;
+    }
+
+private:
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stopping_ = false;
+
+    void enqueue(std::function<void()> task);
+    void workerLoop();
+};
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_THREAD_POOL_H
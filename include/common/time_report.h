@@ -0,0 +1,81 @@
+#ifndef MINICOMPILER_TIME_REPORT_H
+#define MINICOMPILER_TIME_REPORT_H
+
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "common/perf_counters.h"
+
+namespace minicompiler {
+
+/**
+ * @brief 各编译阶段的耗时报告（--time-report），可选附带硬件计数器
+ *
+ * 同名阶段多次出现时累加（例如多个输入文件的词法分析）。
+ * 未启用时阶段计时为空操作。
+ */
+class TimeReport {
+public:
+    /**
+     * @brief 一个阶段的计时区间，析构时记入报告
+     */
+    class Phase {
+    public:
+        Phase(TimeReport* report, std::string name);
+        ~Phase();
+
+        Phase(Phase&& other) noexcept;
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+        Phase& operator=(Phase&&) = delete;
+
+    private:
+        TimeReport* report_;
+        std::string name_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    /**
+     * @brief 构造函数
+     * @param enabled 是否记录
+     * @param hardwareCounters 是否同时采集硬件计数器
+     */
+    explicit TimeReport(bool enabled = false, bool hardwareCounters = false);
+
+    bool isEnabled() const { return enabled_; }
+
+    /**
+     * @brief 开始一个阶段，返回的对象析构时结束
+     * @param name 阶段名称
+     */
+    Phase phase(std::string name) { return Phase(enabled_ ? this : nullptr, std::move(name)); }
+
+    /**
+     * @brief 输出报告
+     * @param os 输出流
+     */
+    void print(std::ostream& os) const;
+
+private:
+    struct Entry {
+        std::string name;
+        double seconds = 0.0;
+        size_t count = 0;
+        PerfCounterValues counters;
+    };
+
+    void record(const std::string& name, double seconds, const PerfCounterValues& counters);
+
+    bool enabled_;
+    std::unique_ptr<PerfCounters> counters_;
+    std::chrono::steady_clock::time_point start_;
+
+    // 按首次出现的顺序
+    std::vector<Entry> entries_;
+};
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_TIME_REPORT_H
@@ -0,0 +1,69 @@
+#ifndef MINICOMPILER_BATCH_COMPILER_H
+#define MINICOMPILER_BATCH_COMPILER_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "driver/compiler_context.h"
+
+namespace minicompiler {
+
+/**
+ * @brief 批量编译的选项
+ */
+struct BatchOptions {
+    unsigned jobs = 1;              // 同时编译的记录数，每个工作线程有自己的CompilerContext
+    bool ordered = true;            // 按输入顺序输出结果；为false时按完成顺序输出
+    CompileOptions defaults;        // 记录中的flags在此基础上修改
+};
+
+/**
+ * @brief 批量编译：从NDJSON流中读取程序，逐个编译并流式输出结果
+ *
+ * 每行输入是一个记录（空行忽略）：
+ * @code
+ * {"name": "a.mc", "source": "int main() { return 0; }", "flags": ["-O1", "--emit-ir"]}
+ * @endcode
+ * 支持的flags：-O0/-O1/-O2、--emit-ir、--from-ir、--lazy-functions、--time-budget=<ms>，
+ * 以及"-o", "<file>"生成目标代码。
+ *
+ * 每个记录输出一行结果，index是记录在输入中的序号（从0开始，空行不计）：
+ * @code
+ * {"index": 0, "name": "a.mc", "success": true, "diagnostics": [], "ir": "..."}
+ * @endcode
+ * 只有--emit-ir时才有ir字段。诊断是Diagnostic::toString()格式的字符串。
+ * 每行结果写出后立即刷新，调用方可以边读边处理。
+ */
+class BatchCompiler {
+public:
+    /**
+     * @brief 构造函数
+     * @param options 批量编译选项
+     */
+    explicit BatchCompiler(BatchOptions options);
+
+    /**
+     * @brief 编译输入流中的所有记录
+     * @param input NDJSON输入
+     * @param output NDJSON输出
+     * @return 失败的记录数
+     */
+    size_t run(std::istream& input, std::ostream& output);
+
+private:
+    BatchOptions options_;
+
+    /**
+     * @brief 编译一个记录，返回结果行（不含换行）
+     * @param context 当前工作线程的编译上下文
+     * @param index 记录序号
+     * @param line 记录的JSON文本
+     * @param failed 输出：是否失败
+     */
+    std::string compileRecord(CompilerContext& context, size_t index, const std::string& line, bool& failed);
+};
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_BATCH_COMPILER_H
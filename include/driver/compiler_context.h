@@ -0,0 +1,139 @@
+#ifndef MINICOMPILER_COMPILER_CONTEXT_H
+#define MINICOMPILER_COMPILER_CONTEXT_H
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "ast/ast.h"
+#include "common/cancellation.h"
+#include "common/string_interner.h"
+#include "common/thread_pool.h"
+#include "common/time_report.h"
+#include "ir/ir.h"
+
+namespace minicompiler {
+
+/**
+ * @brief 一次编译的选项
+ */
+struct CompileOptions {
+    std::string moduleName = "module";
+    int optimizationLevel = 0;          // 0表示不优化
+    bool fromIR = false;                // 源代码是IR文本；以ModuleID注释开头时自动识别
+    bool lazyFunctions = false;         // 只编译从main可达的函数
+    bool emitIR = false;                // 在结果中附带IR文本
+    std::chrono::milliseconds timeBudget{0};    // 编译时间预算，超过后跳过昂贵的优化；0表示没有预算
+    TimeReport* timeReport = nullptr;   // 各阶段计时，为nullptr时不计时
+    std::ostream* progress = nullptr;   // 输出阶段进度，为nullptr时不输出
+    std::shared_ptr<CancellationToken> cancellation;   // 取消标志，为nullptr时不能取消
+};
+
+/**
+ * @brief 编译诊断
+ */
+struct Diagnostic {
+    std::string kind;       // "Parse error"或"Semantic error"
+    std::string message;
+    SourceLocation location;
+
+    /**
+     * @brief 格式化为"kind: message at line L, column C"
+     */
+    std::string toString() const;
+};
+
+/**
+ * @brief 一次编译的结果
+ */
+struct CompileResult {
+    bool success = false;
+    bool cancelled = false;                 // 被取消标志中止，此时没有诊断和模块
+    std::vector<Diagnostic> diagnostics;    // 按阶段、源代码顺序排列
+    std::shared_ptr<IRModule> module;       // 失败时为nullptr
+    std::string ir;                         // emitIR时为IR文本
+    std::vector<std::string> skippedPasses; // 因时间预算跳过的优化，见Optimizer::getSkipped()
+};
+
+/**
+ * @brief 可重复使用的编译上下文，供嵌入编译器的进程使用
+ *
+ * 上下文持有跨编译复用的状态：解析和语义分析共用的线程池、标识符驻留表。
+ * 每次compile开始时清空驻留表（保留容量），线程在上下文的整个生命周期内保持运行，
+ * 因此连续编译大量小文件时不需要重新创建线程和重新分配索引。
+ *
+ * 同一个上下文不能同时在多个线程中调用compile；并发编译时每个线程使用各自的上下文。
+ */
+class CompilerContext {
+public:
+    /**
+     * @brief 构造函数
+     * @param jobs 解析和语义分析的并行线程数，0表示使用硬件并发数
+     */
+    explicit CompilerContext(unsigned jobs = 0);
+
+    CompilerContext(const CompilerContext&) = delete;
+    CompilerContext& operator=(const CompilerContext&) = delete;
+
+    /**
+     * @brief 把源代码编译为IR模块
+     *
+     * 依次进行词法分析、语法分析、语义分析、IR生成和（可选的）优化。
+     * 语法或语义错误作为诊断返回；IR文本格式错误等其它错误以异常抛出。
+     * options.cancellation被取消时，各阶段在下一个函数或pass的边界上停止，
+     * 返回cancelled为true的结果。
+     * @param source 源代码或IR文本
+     * @param options 编译选项
+     * @return 编译结果
+     */
+    CompileResult compile(const std::string& source, const CompileOptions& options);
+
+    /**
+     * @brief 在新线程中编译，立即返回
+     *
+     * 结果就绪之前不能再使用这个上下文；options中的timeReport和progress必须保持有效。
+     * 放弃编译时取消options.cancellation，future很快就绪，结果的cancelled为true。
+     * compile抛出的异常通过future重新抛出。
+     * @param source 源代码或IR文本
+     * @param options 编译选项
+     * @return 编译结果的future
+     */
+    std::future<CompileResult> compileAsync(std::string source, CompileOptions options);
+
+    /**
+     * @brief 获取并行线程数
+     */
+    unsigned getParallelJobs() const { return pool_.getThreadCount(); }
+
+    /**
+     * @brief 获取共享的线程池
+     */
+    ThreadPool& getThreadPool() { return pool_; }
+
+    /**
+     * @brief 获取已经完成的编译次数
+     */
+    size_t getCompileCount() const { return compileCount_; }
+
+private:
+    ThreadPool pool_;
+    std::shared_ptr<StringInterner> interner_;
+    size_t compileCount_ = 0;
+
+    /**
+     * @brief compile的实现，取消时抛出CompilationCancelled
+     */
+    CompileResult compileModule(const std::string& source, const CompileOptions& options);
+
+    /**
+     * @brief 解析、分析源代码并生成IR，出错时返回nullptr
+     */
+    std::shared_ptr<IRModule> buildModule(const std::string& source, const CompileOptions& options,
+                                          std::vector<Diagnostic>& diagnostics);
+};
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_COMPILER_CONTEXT_H
@@ -53,6 +53,7 @@ enum class IROpcode {
     // 控制流
     JMP,        // 无条件跳转
     JMP_IF,     // 条件跳转
+    BR,         // 条件分支（br cond, 真目标, 假目标）
     CALL,       // 函数调用
     RET,        // 函数返回
     
@@ -84,6 +85,12 @@ public:
      * @return 字符串表示
      */
     virtual std::string toString() const = 0;
+    
+    /**
+     * @brief 将值的字符串表示写入输出流
+     * @param os 输出流
+     */
+    virtual void print(std::ostream& os) const { os << toString(); }
 };
 
 /**
@@ -104,6 +111,7 @@ public:
     int getValue() const { return value_; }
     IRType getType() const override { return IRType::INT32; }
     std::string toString() const override;
+    void print(std::ostream& os) const override { os << value_; }
     
 private:
     int value_;
@@ -124,6 +132,23 @@ private:
     float value_;
 };
 
+/**
+ * @brief IR字符串常量，目前只作为print的实参
+ *
+ * 文本形式为带引号的字符串，'"'、'\'和不可打印的字节写成"\XX"（两位十六进制）。
+ */
+class IRStringConstant : public IRConstant {
+public:
+    explicit IRStringConstant(std::string value) : value_(std::move(value)) {}
+    
+    const std::string& getValue() const { return value_; }
+    IRType getType() const override { return IRType::POINTER; }
+    std::string toString() const override;
+    
+private:
+    std::string value_;
+};
+
 /**
  * @brief IR标识符（变量、函数等）
  */
@@ -134,23 +159,69 @@ public:
     
     const std::string& getName() const { return name_; }
     IRType getType() const override { return type_; }
+    
+    /**
+     * @brief 设置类型，IRParser用它确定先于定义被引用的标识符的类型
+     */
+    void setType(IRType type) { type_ = type; }
+    
     std::string toString() const override;
+    void print(std::ostream& os) const override { os << '%' << name_; }
     
 private:
     std::string name_;
     IRType type_;
 };
 
+class IRBasicBlock;
+
 /**
- * @brief IR标签
+ * @brief IR标签（跳转目标）
+ *
+ * 由IRBasicBlock::getLabel得到的标签直接指向基本块，名字只用于输出。
  */
 class IRLabel : public IRValue {
 public:
+    /**
+     * @brief 只有名字、不指向任何基本块的标签
+     * @param name 标签名
+     */
     explicit IRLabel(const std::string& name) : name_(name) {}
     
-    const std::string& getName() const { return name_; }
+    /**
+     * @brief 标签名，指向基本块时取基本块的名字（仅用于输出）
+     */
+    const std::string& getName() const;
+    
+    /**
+     * @brief 跳转目标基本块，只按名字构造的标签返回nullptr
+     */
+    IRBasicBlock* getBlock() const { return block_; }
+    
     IRType getType() const override { return IRType::LABEL; }
     std::string toString() const override;
+    void print(std::ostream& os) const override { os << getName() << ':'; }
+    
+private:
+    friend class IRBasicBlock;
+    
+    explicit IRLabel(IRBasicBlock* block) : block_(block) {}
+    
+    std::string name_;
+    IRBasicBlock* block_ = nullptr;
+};
+
+/**
+ * @brief IR函数引用（call指令的被调用者）
+ */
+class IRFunctionRef : public IRValue {
+public:
+    explicit IRFunctionRef(const std::string& name) : name_(name) {}
+    
+    const std::string& getName() const { return name_; }
+    IRType getType() const override { return IRType::POINTER; }
+    std::string toString() const override;
+    void print(std::ostream& os) const override { os << '@' << name_; }
     
 private:
     std::string name_;
@@ -170,7 +241,18 @@ public:
     std::shared_ptr<IRIdentifier> getResult() const { return result_; }
     const std::vector<std::shared_ptr<IRValue>>& getOperands() const { return operands_; }
     
+    void setOperand(size_t index, std::shared_ptr<IRValue> value) {
+        operands_[index] = std::move(value);
+    }
+    
+    /**
+     * @brief 获取call指令的被调用函数名
+     * @return 函数名，不是call指令或没有被调用者时返回空串
+     */
+    std::string getCallee() const;
+    
     std::string toString() const;
+    void print(std::ostream& os) const;
     
 private:
     IROpcode opcode_;
@@ -184,21 +266,43 @@ private:
 class IRBasicBlock {
 public:
     explicit IRBasicBlock(const std::string& name) : name_(name) {}
+    ~IRBasicBlock();
+    
+    IRBasicBlock(const IRBasicBlock&) = delete;
+    IRBasicBlock& operator=(const IRBasicBlock&) = delete;
     
     const std::string& getName() const { return name_; }
+    
+    /**
+     * @brief 指向本基本块的标签，所有跳到这里的指令共享同一个对象
+     *
+     * 跳转目标通过IRLabel::getBlock直接得到，不需要按名字查找。
+     * 基本块销毁后标签退化为只有名字的标签。
+     */
+    const std::shared_ptr<IRLabel>& getLabel();
     const std::vector<std::shared_ptr<IRInstruction>>& getInstructions() const { return instructions_; }
     
     void addInstruction(std::shared_ptr<IRInstruction> instruction) {
         instructions_.push_back(std::move(instruction));
     }
     
+    void setInstructions(std::vector<std::shared_ptr<IRInstruction>> instructions) {
+        instructions_ = std::move(instructions);
+    }
+    
     std::string toString() const;
+    void print(std::ostream& os) const;
     
 private:
     std::string name_;
     std::vector<std::shared_ptr<IRInstruction>> instructions_;
+    std::shared_ptr<IRLabel> label_;
 };
 
+inline const std::string& IRLabel::getName() const {
+    return block_ ? block_->getName() : name_;
+}
+
 /**
  * @brief IR函数参数
  */
@@ -227,13 +331,32 @@ public:
         blocks_.push_back(std::move(block));
     }
     
+    void setBlocks(std::vector<std::shared_ptr<IRBasicBlock>> blocks) {
+        blocks_ = std::move(blocks);
+    }
+    
+    /**
+     * @brief 统计函数中的指令数量
+     * @return 指令数量
+     */
+    size_t getInstructionCount() const;
+    
     std::string toString() const;
+    void print(std::ostream& os) const;
+    
+    /**
+     * @brief 只输出签名，形式为"declare <type> @name(<params>)"
+     * @param os 输出流
+     */
+    void printDeclaration(std::ostream& os) const;
     
 private:
     std::string name_;
     IRType returnType_;
     std::vector<IRFunctionParameter> parameters_;
     std::vector<std::shared_ptr<IRBasicBlock>> blocks_;
+    
+    void printSignature(std::ostream& os) const;
 };
 
 /**
@@ -250,11 +373,46 @@ public:
         functions_.push_back(std::move(function));
     }
     
+    void setFunctions(std::vector<std::shared_ptr<IRFunction>> functions) {
+        functions_ = std::move(functions);
+    }
+    
+    /**
+     * @brief 外部函数声明：本模块调用、由其它模块定义的函数，只有签名没有基本块
+     */
+    const std::vector<std::shared_ptr<IRFunction>>& getDeclarations() const { return declarations_; }
+    
+    void addDeclaration(std::shared_ptr<IRFunction> declaration) {
+        declarations_.push_back(std::move(declaration));
+    }
+    
+    void setDeclarations(std::vector<std::shared_ptr<IRFunction>> declarations) {
+        declarations_ = std::move(declarations);
+    }
+    
+    /**
+     * @brief 按名称查找函数
+     * @param name 函数名
+     * @return 函数，不存在时返回nullptr
+     */
+    std::shared_ptr<IRFunction> getFunction(const std::string& name) const;
+    
+    /**
+     * @brief 获取模块的文本表示（小模块和测试使用，大模块请使用print流式输出）
+     * @return 字符串表示
+     */
     std::string toString() const;
     
+    /**
+     * @brief 将模块的文本表示流式写入输出流
+     * @param os 输出流
+     */
+    void print(std::ostream& os) const;
+    
 private:
     std::string name_;
     std::vector<std::shared_ptr<IRFunction>> functions_;
+    std::vector<std::shared_ptr<IRFunction>> declarations_;
 };
 
 /**
@@ -3,9 +3,13 @@
 
 #include <memory>
 #include <string>
-#include <unordered_map>
 #include <stack>
-#include "ast/ast.h"
+#include <unordered_map>
+#include <unordered_set>
+#include "ast/ast_walker.h"
+#include "ast/flat_expression.h"
+#include "common/cancellation.h"
+#include "common/scoped_symbol_table.h"
 #include "ir/ir.h"
 
 namespace minicompiler {
@@ -13,7 +17,7 @@ namespace minicompiler {
 /**
  * @brief IR构建器类，负责将AST转换为IR
  */
-class IRBuilder : public ASTVisitor {
+class IRBuilder : public ASTWalker<IRBuilder> {
 public:
     /**
      * @brief 构造函数
@@ -28,22 +32,38 @@ public:
      */
     std::shared_ptr<IRModule> build(Program* program);
     
-    // ASTVisitor接口实现
-    void visit(IntegerLiteral* node) override;
-    void visit(FloatLiteral* node) override;
-    void visit(StringLiteral* node) override;
-    void visit(VariableExpression* node) override;
-    void visit(BinaryExpression* node) override;
-    void visit(UnaryExpression* node) override;
-    void visit(CallExpression* node) override;
-    void visit(ExpressionStatement* node) override;
-    void visit(VarDeclaration* node) override;
-    void visit(BlockStatement* node) override;
-    void visit(IfStatement* node) override;
-    void visit(WhileStatement* node) override;
-    void visit(ReturnStatement* node) override;
-    void visit(FunctionDeclaration* node) override;
-    void visit(Program* node) override;
+    /**
+     * @brief 是否先把每个函数的表达式展平为后序数组再生成IR（默认关闭）
+     *
+     * 展平后每个表达式按数组顺序一遍生成，不经过递归遍历和表达式结果栈。
+     * 两种方式生成的IR完全相同；目前IR生成的耗时主要在IR对象的分配上，
+     * 两者的差别见基准BM_IRBuilder/BM_IRBuilderFlat。
+     * @param enable 是否开启
+     */
+    void setFlattenExpressions(bool enable) { flattenExpressions_ = enable; }
+    
+    /**
+     * @brief 设置取消标志，在生成每个函数之前检查，已取消时build抛出CompilationCancelled
+     * @param token 取消标志，为nullptr时不检查
+     */
+    void setCancellationToken(const CancellationToken* token) { cancellation_ = token; }
+    
+    // 各类节点的处理，由ASTWalker::walk按节点种类分派
+    void visit(IntegerLiteral* node);
+    void visit(FloatLiteral* node);
+    void visit(StringLiteral* node);
+    void visit(VariableExpression* node);
+    void visit(BinaryExpression* node);
+    void visit(UnaryExpression* node);
+    void visit(CallExpression* node);
+    void visit(ExpressionStatement* node);
+    void visit(VarDeclaration* node);
+    void visit(BlockStatement* node);
+    void visit(IfStatement* node);
+    void visit(WhileStatement* node);
+    void visit(ReturnStatement* node);
+    void visit(FunctionDeclaration* node);
+    void visit(Program* node);
     
 private:
     // IR模块
@@ -55,29 +75,49 @@ private:
     // 当前基本块
     std::shared_ptr<IRBasicBlock> currentBlock_;
     
-    // 符号表（变量名 -> IR标识符）
-    std::unordered_map<std::string, std::shared_ptr<IRIdentifier>> symbolTable_;
+    // 取消标志
+    const CancellationToken* cancellation_ = nullptr;
+    
+    // 标识符驻留表，来自Program；手工构造的AST没有时自建一个
+    std::shared_ptr<StringInterner> interner_;
+    
+    // 符号表（驻留编号 -> IR标识符），函数和语句块各为一层作用域
+    ScopedSymbolTable<std::shared_ptr<IRIdentifier>> symbols_;
+    
+    // 函数名 -> 声明，调用时据此转换参数（被调函数可以定义在后面）
+    std::unordered_map<std::string, const FunctionDeclaration*> functions_;
     
     // 表达式结果栈
     std::stack<std::shared_ptr<IRValue>> valueStack_;
     
+    // 当前函数的扁平化表达式，以及展平求值时各节点的结果
+    bool flattenExpressions_ = false;
+    FlatExpressionTable flatExprs_;
+    std::vector<std::shared_ptr<IRValue>> flatValues_;
+    
     // 标签计数器
     int labelCounter_ = 0;
     
     // 临时变量计数器
     int tempCounter_ = 0;
     
+    // 同名变量重复声明时的重命名计数器
+    int shadowCounter_ = 0;
+    
+    // 当前函数中已经用作alloca的名字，包括已经离开作用域的变量
+    std::unordered_set<std::string> variableNames_;
+    
     // 辅助方法
     
     /**
-     * @brief 创建新的基本块
+     * @brief 创建新的基本块，此时还不属于当前函数
      * @param name 基本块名称
      * @return 基本块
      */
     std::shared_ptr<IRBasicBlock> createBlock(const std::string& name);
     
     /**
-     * @brief 设置当前基本块
+     * @brief 把基本块追加到当前函数并设为当前基本块
      * @param block 基本块
      */
     void setCurrentBlock(std::shared_ptr<IRBasicBlock> block);
@@ -110,6 +150,118 @@ private:
      */
     IRType typeFromString(const std::string& cType);
     
+    /**
+     * @brief 语义分析记录的类型对应的IR类型
+     * @param type 表达式的类型
+     * @param fallback 未经语义分析（或类型无效）时使用的类型
+     * @return IR类型
+     */
+    static IRType irType(ValueType type, IRType fallback);
+    
+    /**
+     * @brief 把值转换为指定类型，int与float之间生成int_to_float/float_to_int
+     *
+     * 常量直接折叠为目标类型的常量；类型相同或不是数值类型时原样返回。
+     * @param value 值
+     * @param type 目标类型
+     * @return 转换后的值
+     */
+    std::shared_ptr<IRValue> convert(std::shared_ptr<IRValue> value, IRType type);
+    
+    /**
+     * @brief 生成二元运算（不含赋值和短路运算），操作数按需转换为共同类型
+     * @param op 运算符
+     * @param type 表达式的类型
+     * @return 运算结果
+     */
+    std::shared_ptr<IRValue> emitBinary(TokenType op, ValueType type,
+                                        std::shared_ptr<IRValue> left, std::shared_ptr<IRValue> right);
+    
+    /**
+     * @brief 生成一元运算
+     * @param op 运算符
+     * @param type 表达式的类型
+     * @return 运算结果
+     */
+    std::shared_ptr<IRValue> emitUnary(TokenType op, ValueType type, std::shared_ptr<IRValue> operand);
+    
+    /**
+     * @brief 生成函数调用，实参转换为形参类型
+     * @param callee 被调函数名
+     * @param type 调用表达式的类型
+     * @param args 实参
+     * @return 调用结果
+     */
+    std::shared_ptr<IRValue> emitCall(const std::string& callee, ValueType type,
+                                      std::vector<std::shared_ptr<IRValue>> args);
+    
+    /**
+     * @brief 把值转换为变量的类型后存入变量
+     * @return 存入的值（赋值表达式的值）
+     */
+    std::shared_ptr<IRValue> emitStore(std::shared_ptr<IRValue> value, const std::shared_ptr<IRIdentifier>& var);
+    
+    /**
+     * @brief 取名字的驻留编号，AST中没有记录时现场驻留
+     * @param symbol AST中记录的编号
+     * @param name 名字
+     * @return 驻留编号
+     */
+    Symbol symbolFor(Symbol symbol, const std::string& name);
+    
+    /**
+     * @brief 在当前作用域声明变量
+     *
+     * 名字在当前函数中已经用过时（内层遮蔽外层，或者并列的语句块中声明过同名变量），
+     * IR中改名为name.N，使同一函数中的每个alloca都有唯一的名字。
+     * @param symbol 驻留编号
+     * @param name 源代码中的名字
+     * @param type 变量类型
+     * @return 变量标识符
+     */
+    std::shared_ptr<IRIdentifier> declareVariable(Symbol symbol, const std::string& name, IRType type);
+    
+    /**
+     * @brief 查找当前可见的变量
+     * @return 变量标识符，未声明时返回nullptr
+     */
+    std::shared_ptr<IRIdentifier> lookupVariable(Symbol symbol, const std::string& name);
+    
+    /**
+     * @brief 生成表达式的IR，已展平的表达式走emitFlat，否则遍历AST
+     * @param expr 表达式
+     * @return 表达式的值
+     */
+    std::shared_ptr<IRValue> emitExpression(Expression* expr);
+    
+    /**
+     * @brief 生成跳转到target的jmp
+     * @param target 目标基本块
+     */
+    void emitJump(IRBasicBlock* target);
+    
+    /**
+     * @brief 生成条件跳转，&&、||和!直接转为控制流，不物化布尔值
+     * @param expr 条件表达式
+     * @param trueBlock 条件为真时的目标
+     * @param falseBlock 条件为假时的目标
+     */
+    void emitCondition(Expression* expr, IRBasicBlock* trueBlock, IRBasicBlock* falseBlock);
+    
+    /**
+     * @brief 在值上下文中短路求值&&或||，结果为0或1
+     * @param node 逻辑与/或表达式
+     * @return 表达式的值
+     */
+    std::shared_ptr<IRValue> emitLogicalValue(BinaryExpression* node);
+    
+    /**
+     * @brief 按后序数组一遍生成表达式的IR
+     * @param range 表达式在flatExprs_中的范围
+     * @return 表达式的值
+     */
+    std::shared_ptr<IRValue> emitFlat(const FlatExpressionTable::Range& range);
+    
     /**
      * @brief 获取栈顶值并弹出
      * @return 栈顶值
@@ -0,0 +1,92 @@
+#ifndef MINICOMPILER_IR_INTERPRETER_H
+#define MINICOMPILER_IR_INTERPRETER_H
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ir/ir.h"
+
+namespace minicompiler {
+
+/**
+ * @brief IR解释执行错误异常类（除零、调用未定义函数、超出指令上限等）
+ */
+class IRInterpreterError : public std::runtime_error {
+public:
+    explicit IRInterpreterError(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+/**
+ * @brief IR解释器，用于运行时基准和优化结果的正确性验证
+ *
+ * 执行前把每个函数的基本块展平为一个指令数组，标识符映射到栈帧槽位，
+ * 标签解析为指令下标，执行时不再做名称查找。
+ * 值在运行时携带类型，整数运算按32位补码回绕。
+ * 模块中未定义的print作为内建函数，每个实参输出一行，格式与运行时库（runtime/runtime.h）相同。
+ */
+class IRInterpreter {
+public:
+    /**
+     * @brief 构造函数
+     * @param module 待执行的模块
+     * @param output print的输出流
+     */
+    explicit IRInterpreter(std::shared_ptr<IRModule> module, std::ostream& output = std::cout);
+
+    ~IRInterpreter();
+
+    /**
+     * @brief 执行入口函数
+     * @param entry 入口函数名
+     * @return 入口函数的返回值（浮点数返回值截断为整数）
+     */
+    int run(const std::string& entry = "main");
+
+    /**
+     * @brief 设置可执行的指令数上限，超出时抛出IRInterpreterError，0表示不限制
+     */
+    void setInstructionLimit(uint64_t limit) { instructionLimit_ = limit; }
+
+    /**
+     * @brief 获取已执行的指令数
+     */
+    uint64_t getInstructionCount() const { return instructionCount_; }
+
+    /**
+     * @brief 获取已执行的函数调用数（包括内建函数）
+     */
+    uint64_t getCallCount() const { return callCount_; }
+
+private:
+    struct Value;
+    struct Function;
+
+    /**
+     * @brief 把函数翻译为展平的指令数组
+     */
+    const Function& decode(size_t index);
+
+    Value execute(size_t index, const std::vector<Value>& arguments, int depth);
+
+    std::shared_ptr<IRModule> module_;
+    std::ostream& output_;
+
+    // 函数名 -> 模块中的下标
+    std::unordered_map<std::string, size_t> functionIndex_;
+
+    // 已翻译的函数，首次调用时翻译
+    std::vector<std::unique_ptr<Function>> decoded_;
+
+    uint64_t instructionLimit_ = 0;
+    uint64_t instructionCount_ = 0;
+    uint64_t callCount_ = 0;
+};
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_IR_INTERPRETER_H
@@ -0,0 +1,54 @@
+#ifndef MINICOMPILER_IR_LINKER_H
+#define MINICOMPILER_IR_LINKER_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "ir/ir.h"
+
+namespace minicompiler {
+
+/**
+ * @brief IR链接器，将多个IR模块合并为一个整程序模块（用于-flto）
+ */
+class IRLinker {
+public:
+    /**
+     * @brief 构造函数
+     * @param moduleName 合并后模块的名称
+     */
+    explicit IRLinker(const std::string& moduleName);
+
+    /**
+     * @brief 链接一个模块，同名函数重复定义时抛出std::runtime_error
+     * @param module 待链接的模块
+     */
+    void link(std::shared_ptr<IRModule> module);
+
+    /**
+     * @brief 链接完所有模块后检查符号，调用了没有定义的函数、声明与定义的签名不一致时
+     *        抛出std::runtime_error；合并后的模块不含外部声明
+     */
+    void resolve();
+
+    /**
+     * @brief 获取合并后的模块
+     * @return IR模块
+     */
+    std::shared_ptr<IRModule> getModule() const { return module_; }
+
+private:
+    std::shared_ptr<IRModule> module_;
+
+    // 已定义的函数名 -> 所在的源模块名
+    std::unordered_map<std::string, std::string> definedIn_;
+
+    // 各模块的外部函数声明及其所在的源模块名，resolve()时与定义核对
+    std::vector<std::pair<std::shared_ptr<IRFunction>, std::string>> declarations_;
+};
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_IR_LINKER_H
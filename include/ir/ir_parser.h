@@ -0,0 +1,122 @@
+#ifndef MINICOMPILER_IR_PARSER_H
+#define MINICOMPILER_IR_PARSER_H
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "common/token.h"
+#include "ir/ir.h"
+
+namespace minicompiler {
+
+/**
+ * @brief IR文本解析错误异常类
+ */
+class IRParseError : public std::runtime_error {
+public:
+    IRParseError(const std::string& message, const SourceLocation& location)
+        : std::runtime_error(message), location_(location) {}
+
+    SourceLocation getLocation() const { return location_; }
+
+private:
+    SourceLocation location_;
+};
+
+/**
+ * @brief IR文本解析器，将IRModule::toString()的输出重新构造为IR模块
+ *
+ * 文本中不携带临时变量的类型，解析器按照IRBuilder的规则推导：
+ * 算术指令取第一个操作数的类型，比较和逻辑指令的结果为i32，load取被加载变量的类型，
+ * call取模块中被调用函数（定义或declare声明）的返回类型，void和未知函数为i32，
+ * alloca使用文本中显式给出的类型。同一函数中每个%名字只能由一条指令定义，
+ * 先于定义出现的引用在定义处确定类型。
+ */
+class IRParser {
+public:
+    /**
+     * @brief 构造函数
+     * @param source IR文本
+     * @param moduleName 文本中没有ModuleID时使用的模块名
+     */
+    explicit IRParser(std::string source, std::string moduleName = "");
+
+    /**
+     * @brief 解析整个模块
+     * @return IR模块
+     */
+    std::shared_ptr<IRModule> parse();
+
+private:
+    // IR文本
+    std::string source_;
+    std::string moduleName_;
+
+    // 当前处理位置
+    size_t current_ = 0;
+    size_t lineStart_ = 0;
+    int line_ = 1;
+
+    // 当前函数内的标识符表（名称 -> IR标识符），键指向source_内部；
+    // 先于定义被引用的标识符暂时为i32，到定义它的指令时再确定类型
+    struct IdentifierEntry {
+        std::shared_ptr<IRIdentifier> ident;
+        bool defined = false;
+    };
+    std::unordered_map<std::string_view, IdentifierEntry> identifiers_;
+
+    // 当前函数中结果类型由操作数推导的指令；有标识符先于定义被引用时在函数结束后重新推导
+    std::vector<IRInstruction*> inferred_;
+    bool forwardReferences_ = false;
+
+    // 当前函数内的基本块（名称 -> 基本块），跳转可以先于基本块定义出现
+    struct BlockEntry {
+        std::shared_ptr<IRBasicBlock> block;
+        bool defined = false;
+    };
+    std::unordered_map<std::string_view, BlockEntry> blocks_;
+
+    // 当前函数的参数列表
+    const std::vector<IRFunctionParameter>* parameters_ = nullptr;
+
+    // 模块中所有函数的返回类型，解析函数体之前收集，用于推导call结果的类型
+    std::unordered_map<std::string, IRType> returnTypes_;
+
+    // 解析方法
+    void collectReturnTypes();
+    std::shared_ptr<IRFunction> parseSignature();
+    std::shared_ptr<IRFunction> parseDeclaration();
+    std::shared_ptr<IRFunction> parseFunction();
+    std::shared_ptr<IRInstruction> parseInstruction();
+    std::shared_ptr<IRValue> parseOperand();
+    std::shared_ptr<IRValue> parseString();
+    IRType parseType();
+    BlockEntry& blockFor(std::string_view name);
+
+    // 标识符管理
+    std::shared_ptr<IRIdentifier> lookupIdentifier(std::string_view name);
+    std::shared_ptr<IRIdentifier> defineIdentifier(std::string_view name, IRType type);
+    void resolveForwardReferences();
+    IRType inferResultType(IROpcode opcode, const std::vector<std::shared_ptr<IRValue>>& operands) const;
+
+    // 辅助方法
+    bool isAtEnd() const { return current_ >= source_.size(); }
+    char peek() const { return isAtEnd() ? '\0' : source_[current_]; }
+    bool atLineEnd() const { return isAtEnd() || source_[current_] == '\n'; }
+    void skipSpaces();
+    void skipLine();
+    void nextLine();
+    bool match(char expected);
+    void expect(char expected, const std::string& message);
+    bool matchWord(std::string_view word);
+    std::string_view scanName();
+
+    // 错误处理
+    IRParseError error(const std::string& message) const;
+};
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_IR_PARSER_H
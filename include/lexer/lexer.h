@@ -5,6 +5,7 @@
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include "common/cancellation.h"
 #include "common/token.h"
 
 namespace minicompiler {
@@ -26,6 +27,12 @@ public:
      */
     std::vector<Token> scanTokens();
     
+    /**
+     * @brief 设置取消标志，scanTokens每扫描kCancellationInterval个标记检查一次
+     * @param token 取消标志，为nullptr时不检查
+     */
+    void setCancellationToken(const CancellationToken* token) { cancellation_ = token; }
+    
     /**
      * @brief 扫描下一个标记
      * @return 下一个标记
@@ -75,12 +82,16 @@ private:
     // 已扫描的标记
     std::vector<Token> tokens_;
     
+    // 取消标志
+    const CancellationToken* cancellation_ = nullptr;
+    static constexpr size_t kCancellationInterval = 4096;
+    
     // 关键字映射表
     static std::unordered_map<std::string, TokenType> keywords_;
     
     // 辅助方法
     char advance();
-    char peek(size_t offset = 0) const;
+    char peekChar(size_t offset = 0) const;
     bool match(char expected);
     void skipWhitespace();
     
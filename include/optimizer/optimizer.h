@@ -1,7 +1,12 @@
 #ifndef MINICOMPILER_OPTIMIZER_H
 #define MINICOMPILER_OPTIMIZER_H
 
+#include <chrono>
 #include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "common/cancellation.h"
 #include "ir/ir.h"
 
 namespace minicompiler {
@@ -24,8 +29,81 @@ public:
      */
     std::shared_ptr<IRModule> optimize(std::shared_ptr<IRModule> module);
     
+    /**
+     * @brief 设置模块是否为完整程序（-flto链接后的模块）
+     *
+     * 完整程序中所有调用点都可见，可以安全地进行过程间常量传播和死函数消除。
+     * @param wholeProgram 是否为完整程序
+     */
+    void setWholeProgram(bool wholeProgram) { wholeProgram_ = wholeProgram; }
+    
+    /**
+     * @brief 设置输出pass进度的流
+     * @param progress 输出流，默认为std::cout，为nullptr时不输出
+     */
+    void setProgressStream(std::ostream* progress) { progress_ = progress; }
+    
+    /**
+     * @brief 设置编译时间预算的截止时间
+     *
+     * 预算只作用于开销随程序规模增长的内联和过程间常量传播，截止时间已过时跳过它们；
+     * 其余pass总是运行，其中死函数消除很便宜，而且让后面的pass处理的函数更少。
+     * 内联按模块中的顺序逐个检查调用者：用已处理指令的平均耗时乘以该调用者的指令数
+     * 估计它的开销，预计会超过截止时间时跳过它（第一个调用者还没有耗时数据，总是处理）。
+     * 跳过pass只会少做优化，结果仍然正确。
+     * @param deadline 截止时间，默认没有预算
+     */
+    void setDeadline(std::chrono::steady_clock::time_point deadline) { deadline_ = deadline; }
+    
+    /**
+     * @brief 设置取消标志，在每个pass开始前和内联的每个函数之前检查
+     *
+     * 已取消时optimize抛出CompilationCancelled，模块可能只完成了部分优化，不应再使用。
+     * @param token 取消标志，为nullptr时不检查
+     */
+    void setCancellationToken(const CancellationToken* token) { cancellation_ = token; }
+    
+    /**
+     * @brief 获取因时间预算跳过的pass和函数
+     * @return "pass"或"pass:函数名"，按跳过的顺序排列
+     */
+    const std::vector<std::string>& getSkipped() const { return skipped_; }
+    
+    /**
+     * @brief 获取所有可单独运行的pass名称
+     * @return pass名称列表，按optimize中的执行顺序排列
+     */
+    static const std::vector<std::string>& getPassNames();
+    
+    /**
+     * @brief 单独运行一个pass（用于基准测试和逐pass定位问题）
+     * @param name pass名称
+     * @param module IR模块
+     * @return pass是否存在
+     */
+    bool runPass(const std::string& name, std::shared_ptr<IRModule> module);
+    
 private:
     int level_;
+    bool wholeProgram_ = false;
+    std::ostream* progress_;
+    std::chrono::steady_clock::time_point deadline_ = std::chrono::steady_clock::time_point::max();
+    std::vector<std::string> skipped_;
+    const CancellationToken* cancellation_ = nullptr;
+    
+    // 内联时生成的名称后缀计数器
+    int inlineCounter_ = 0;
+    
+    // 开始一个pass：检查取消标志并输出进度
+    void beginPass(const char* pass);
+    
+    /**
+     * @brief 开始一个可以跳过的pass
+     * @param pass pass名称（用于进度输出）
+     * @param name pass的短名称（同getPassNames）
+     * @return 截止时间已过时返回false，pass应当跳过
+     */
+    bool beginOptionalPass(const char* pass, const char* name);
     
     // 各种优化pass
     void constantFolding(std::shared_ptr<IRModule> module);
@@ -33,6 +111,15 @@ private:
     void commonSubexpressionElimination(std::shared_ptr<IRModule> module);
     void loopInvariantCodeMotion(std::shared_ptr<IRModule> module);
     void functionInlining(std::shared_ptr<IRModule> module);
+    void interproceduralConstantPropagation(std::shared_ptr<IRModule> module);
+    void deadFunctionElimination(std::shared_ptr<IRModule> module);
+    
+    // 内联辅助方法
+    bool shouldInline(const IRFunction& caller, const IRFunction& callee) const;
+    void inlineCall(const std::shared_ptr<IRInstruction>& call, const IRFunction& callee,
+                    std::shared_ptr<IRBasicBlock>& block,
+                    std::vector<std::shared_ptr<IRBasicBlock>>& blocks,
+                    std::vector<std::shared_ptr<IRInstruction>>& allocas);
 };
 
 } // namespace minicompiler
@@ -7,9 +7,12 @@
 #include <string>
 #include "lexer/lexer.h"
 #include "ast/ast.h"
+#include "common/cancellation.h"
 
 namespace minicompiler {
 
+class ThreadPool;
+
 /**
  * @brief 解析错误异常类
  */
@@ -37,26 +40,160 @@ public:
     
     /**
      * @brief 解析程序
+     *
+     * 出错时不中止：在语句和顶层声明的边界上恢复后继续解析，出错的语句或声明不进入AST，
+     * AST中不会有空节点。所有错误通过getErrors()获取。
      * @return 程序AST
      */
     std::unique_ptr<Program> parse();
     
+    /**
+     * @brief 设置并行解析的线程数
+     *
+     * 大于1时先按花括号匹配扫描标记序列，找出顶层函数的边界，把连续的若干个函数分成一段，
+     * 各段在工作线程上用独立的解析器和驻留表解析，再按顺序合并。结果（AST、符号编号、错误）
+     * 与串行解析完全相同；某一段的解析越过了段边界时（花括号不配对等错误输入），整体退回串行解析。
+     * @param jobs 线程数，1表示串行解析
+     */
+    void setParallelJobs(unsigned jobs) { jobs_ = jobs; }
+    
+    /**
+     * @brief 使用已有的线程池并行解析，不再每次解析时创建线程
+     * @param pool 线程池，为nullptr时按需创建
+     */
+    void setThreadPool(ThreadPool* pool) { pool_ = pool; }
+    
+    /**
+     * @brief 使用给定的驻留表，解析结束后交给Program
+     *
+     * 多次编译可以复用同一个驻留表（清空后保留容量）。
+     * @param interner 驻留表
+     */
+    void setInterner(std::shared_ptr<StringInterner> interner) { interner_ = std::move(interner); }
+    
+    /**
+     * @brief 只解析可达函数的函数体
+     *
+     * 开启后第一遍只解析函数签名，函数体按花括号匹配跳过，记下起始位置；
+     * 然后从main开始（没有main时所有函数都是入口）按调用关系解析可达函数的函数体，
+     * 不可达的函数不进入AST，也就不会进行语义分析和生成IR。
+     * 不可达函数体中的错误不会报告。开启时不使用并行解析。
+     * @param lazy 是否跳过不可达的函数体
+     */
+    void setLazyFunctionBodies(bool lazy) { lazyBodies_ = lazy; }
+    
+    /**
+     * @brief 设置取消标志，在每个顶层声明和每个延迟解析的函数体之前检查
+     *
+     * 已取消时parse()抛出CompilationCancelled。
+     * @param token 取消标志，为nullptr时不检查
+     */
+    void setCancellationToken(const CancellationToken* token) { cancellation_ = token; }
+    
+    /**
+     * @brief 获取解析过程中的所有错误
+     * @return 错误列表，按出现顺序排列
+     */
+    const std::vector<ParseError>& getErrors() const { return errors_; }
+    
+    /**
+     * @brief 是否有解析错误
+     */
+    bool hadError() const { return !errors_.empty(); }
+    
 private:
-    // 标记序列
-    std::vector<Token> tokens_;
+    // 标记序列；分段解析器不拥有标记，只引用整个序列
+    std::vector<Token> ownedTokens_;
+    const Token* tokens_;
+    
+    // 解析范围的结束位置：串行解析时是END_OF_FILE，分段解析时是下一段第一个标记
+    size_t end_;
+    
+    // 是否在段边界之外还需要查看标记，此时分段结果可能与串行解析不同
+    mutable bool crossedEnd_ = false;
+    
+    // 并行解析的线程数
+    unsigned jobs_ = 1;
+    
+    // 外部提供的线程池
+    ThreadPool* pool_ = nullptr;
+    
+    // 是否跳过不可达的函数体
+    bool lazyBodies_ = false;
+    
+    // 取消标志
+    const CancellationToken* cancellation_ = nullptr;
+    
+    /**
+     * @brief 跳过的函数体
+     */
+    struct PendingBody {
+        FunctionDeclaration* function;
+        size_t begin;   // '{'之后第一个标记的位置
+    };
+    std::vector<PendingBody> pendingBodies_;
+    
+    // 标识符驻留表，解析结束后交给Program
+    std::shared_ptr<StringInterner> interner_;
     
     // 当前处理位置
     size_t current_ = 0;
     
+    // 已报告的错误
+    std::vector<ParseError> errors_;
+    
+    // 当前表达式的嵌套深度（括号、调用参数、赋值右侧）
+    int expressionDepth_ = 0;
+    
+    // 上一个解析完的子表达式的树高度（叶子为1，括号不增加高度）
+    int expressionHeight_ = 0;
+    
+    /**
+     * @brief 构造只解析[begin, end)范围的分段解析器
+     * @param tokens 整个标记序列
+     * @param begin 起始位置，必须是顶层声明的开头
+     * @param end 结束位置
+     */
+    Parser(const Token* tokens, size_t begin, size_t end);
+    
+    /**
+     * @brief 解析顶层声明直到解析范围的结束位置
+     * @param statements 输出的顶层语句
+     */
+    void parseDeclarations(std::vector<std::unique_ptr<Statement>>& statements);
+    
+    /**
+     * @brief 分段并行解析
+     * @param statements 输出的顶层语句
+     * @return 分段解析成功时返回true；返回false时什么也没有输出，应当串行解析
+     */
+    bool parseParallel(std::vector<std::unique_ptr<Statement>>& statements);
+    
+    /**
+     * @brief 从入口函数开始，按调用关系解析可达函数的函数体，删除不可达的函数
+     * @param statements 顶层语句
+     */
+    void parseReachableBodies(std::vector<std::unique_ptr<Statement>>& statements);
+    
+    /**
+     * @brief 从'{'之后跳到配对的'}'之后
+     */
+    void skipBlock();
+    
+    /**
+     * @brief 按花括号和圆括号匹配扫描，找出所有顶层函数声明的起始位置
+     * @return 起始位置列表；括号不配对时返回空列表
+     */
+    std::vector<size_t> findFunctionStarts() const;
+    
     // 辅助方法
     bool isAtEnd() const;
     const Token& peek() const;
     const Token& previous() const;
-    Token advance();
+    const Token& advance();
     bool check(TokenType type) const;
     bool match(TokenType type);
-    bool match(std::initializer_list<TokenType> types);
-    Token consume(TokenType type, const std::string& message);
+    const Token& consume(TokenType type, const std::string& message);
     
     // 递归下降解析方法
     std::unique_ptr<Statement> declaration();
@@ -71,20 +208,45 @@ private:
     
     std::unique_ptr<Expression> expression();
     std::unique_ptr<Expression> assignment();
-    std::unique_ptr<Expression> logicalOr();
-    std::unique_ptr<Expression> logicalAnd();
-    std::unique_ptr<Expression> equality();
-    std::unique_ptr<Expression> comparison();
-    std::unique_ptr<Expression> term();
-    std::unique_ptr<Expression> factor();
+    
+    /**
+     * @brief 优先级爬升：解析优先级不低于minPrecedence的二元运算
+     *
+     * 同一优先级的运算符在一个循环中左结合地折叠，只有右操作数中更紧的运算符才递归，
+     * 递归深度不超过优先级的级数。
+     * @param minPrecedence 最低优先级
+     */
+    std::unique_ptr<Expression> binary(int minPrecedence);
+    
     std::unique_ptr<Expression> unary();
     std::unique_ptr<Expression> call();
     std::unique_ptr<Expression> primary();
     
     std::unique_ptr<Expression> finishCall(std::unique_ptr<Expression> callee);
     
+    /**
+     * @brief 记录刚构造的子表达式的树高度，超过嵌套限制时抛出ParseError
+     * @param height 子表达式的高度
+     */
+    void checkExpressionHeight(int height);
+    
     // 错误处理
+    
+    /**
+     * @brief 语句级恢复：跳到下一条语句的开头（';'之后，或语句关键字、'{'、'}'之前）
+     */
     void synchronize();
+    
+    /**
+     * @brief 声明级恢复：跳到花括号之外的下一个类型关键字
+     */
+    void synchronizeDeclaration();
+    
+    /**
+     * @brief 记录错误，不中断解析
+     */
+    void report(ParseError error);
+    
     ParseError error(const std::string& message);
     ParseError error(const Token& token, const std::string& message);
 };
@@ -0,0 +1,87 @@
+#ifndef MINICOMPILER_RUNTIME_FORMAT_H
+#define MINICOMPILER_RUNTIME_FORMAT_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace minicompiler {
+
+/**
+ * @brief formatInt最多写入的字符数（"-2147483648"）
+ */
+constexpr size_t kMaxIntChars = 11;
+
+/**
+ * @brief formatFloat最多写入的字符数（"-1.17549e-38"，以及inf、nan）
+ */
+constexpr size_t kMaxFloatChars = 16;
+
+namespace detail {
+
+/**
+ * @brief "00" "01" ... "99"，每次除以100写出两位数字
+ */
+struct DigitPairs {
+    char digits[200];
+
+    constexpr DigitPairs() : digits() {
+        for (int i = 0; i < 100; ++i) {
+            digits[2 * i] = static_cast<char>('0' + i / 10);
+            digits[2 * i + 1] = static_cast<char>('0' + i % 10);
+        }
+    }
+};
+
+inline constexpr DigitPairs kDigitPairs;
+
+} // namespace detail
+
+/**
+ * @brief 把整数格式化为十进制文本，不分配内存
+ *
+ * 从低位开始每次取两位查表，除法次数是逐位转换的一半。
+ * @param value 整数
+ * @param out 输出位置，至少有kMaxIntChars个字符的空间
+ * @return 写入的最后一个字符之后的位置
+ */
+inline char* formatInt(int32_t value, char* out) {
+    uint32_t magnitude = static_cast<uint32_t>(value);
+    if (value < 0) {
+        *out++ = '-';
+        magnitude = 0u - magnitude;
+    }
+
+    char digits[10];
+    char* end = digits + sizeof(digits);
+    char* begin = end;
+    while (magnitude >= 100) {
+        begin -= 2;
+        std::memcpy(begin, detail::kDigitPairs.digits + (magnitude % 100) * 2, 2);
+        magnitude /= 100;
+    }
+    if (magnitude >= 10) {
+        begin -= 2;
+        std::memcpy(begin, detail::kDigitPairs.digits + magnitude * 2, 2);
+    } else {
+        *--begin = static_cast<char>('0' + magnitude);
+    }
+
+    std::memcpy(out, begin, static_cast<size_t>(end - begin));
+    return out + (end - begin);
+}
+
+/**
+ * @brief 把浮点数格式化为6位有效数字的文本，与printf("%g")和std::ostream的默认格式相同，不分配内存
+ * @param value 浮点数
+ * @param out 输出位置，至少有kMaxFloatChars个字符的空间
+ * @return 写入的最后一个字符之后的位置
+ */
+inline char* formatFloat(float value, char* out) {
+    return std::to_chars(out, out + kMaxFloatChars, value, std::chars_format::general, 6).ptr;
+}
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_RUNTIME_FORMAT_H
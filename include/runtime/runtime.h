@@ -0,0 +1,53 @@
+#ifndef MINICOMPILER_RUNTIME_H
+#define MINICOMPILER_RUNTIME_H
+
+/**
+ * @brief 编译后程序的运行时库（libmcrt）
+ *
+ * 生成的代码把print(a, b, ...)的每个实参翻译为一次mc_print_*调用，每个值输出一行，
+ * 与IR解释器的输出相同。
+ *
+ * 输出先写入每个线程自己的缓冲区，缓冲区满、调用mc_flush或线程（包括主线程经exit）结束时
+ * 用write(2)整块写出，大量输出的程序不再是每个值一次系统调用。格式化不分配内存。
+ * 同一线程的输出保持顺序；不同线程的输出以整块为单位交错。
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 输出一个整数和换行
+ */
+void mc_print_i32(int32_t value);
+
+/**
+ * @brief 输出一个浮点数（6位有效数字）和换行
+ */
+void mc_print_f32(float value);
+
+/**
+ * @brief 输出一个字符串和换行
+ * @param text 字符串，不需要以'\0'结尾
+ * @param length 字节数
+ */
+void mc_print_str(const char* text, size_t length);
+
+/**
+ * @brief 把当前线程缓冲的输出写出
+ */
+void mc_flush(void);
+
+/**
+ * @brief 设置输出的文件描述符（默认为1），切换前先写出当前线程缓冲的输出
+ */
+void mc_set_output_fd(int fd);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // MINICOMPILER_RUNTIME_H
@@ -0,0 +1,93 @@
+#ifndef MINICOMPILER_SEMANTIC_ANALYZER_H
+#define MINICOMPILER_SEMANTIC_ANALYZER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ast/ast.h"
+
+namespace minicompiler {
+
+class ThreadPool;
+
+/**
+ * @brief 语义错误
+ */
+struct SemanticError {
+    std::string message;
+    SourceLocation location;
+};
+
+/**
+ * @brief 函数签名
+ */
+struct FunctionSignature {
+    ValueType returnType;
+    std::vector<ValueType> parameterTypes;
+    const FunctionDeclaration* declaration;     // 定义；只有原型时为首个原型
+    bool defined;
+};
+
+/**
+ * @brief 语义分析器类，在生成IR之前检查名字和类型
+ *
+ * 分两步进行：
+ * 1. 串行收集所有函数签名，检查重复定义和顶层语句；
+ * 2. 各函数体互不依赖，只读共享签名表，按函数并行检查：
+ *    名字解析（块作用域）、表达式类型、调用参数个数、return与返回类型是否一致。
+ *
+ * 每个表达式的类型记录在Expression::getType()中，IRBuilder据此插入int与float之间的
+ * 隐式转换（赋值、传参、返回和混合运算）。
+ * 错误按源代码顺序排列，与并行度无关。
+ */
+class SemanticAnalyzer {
+public:
+    /**
+     * @brief 分析程序
+     * @param program AST程序
+     * @return 没有错误时返回true
+     */
+    bool analyze(Program* program);
+
+    /**
+     * @brief 设置并行检查函数体的线程数
+     * @param jobs 线程数，1表示串行检查
+     */
+    void setParallelJobs(unsigned jobs) { jobs_ = jobs; }
+
+    /**
+     * @brief 使用已有的线程池检查函数体，不再每次分析时创建线程
+     * @param pool 线程池，为nullptr时按需创建
+     */
+    void setThreadPool(ThreadPool* pool) { pool_ = pool; }
+
+    /**
+     * @brief 获取上一次分析发现的错误
+     * @return 错误列表，按源代码顺序排列
+     */
+    const std::vector<SemanticError>& getErrors() const { return errors_; }
+
+    /**
+     * @brief 查找函数签名（分析之后有效）
+     * @param name 函数名
+     * @return 签名，未声明时返回nullptr
+     */
+    const FunctionSignature* findFunction(const std::string& name) const;
+
+private:
+    unsigned jobs_ = 1;
+    ThreadPool* pool_ = nullptr;
+    std::unordered_map<std::string, FunctionSignature> functions_;
+    std::vector<SemanticError> errors_;
+
+    /**
+     * @brief 登记函数签名
+     * @param function 函数声明
+     * @param errors 错误输出
+     */
+    void declareFunction(const FunctionDeclaration* function, std::vector<SemanticError>& errors);
+};
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_SEMANTIC_ANALYZER_H
@@ -2,6 +2,18 @@
 
 namespace minicompiler {
 
+const char* valueTypeName(ValueType type) {
+    switch (type) {
+        case ValueType::UNKNOWN: return "<unknown>";
+        case ValueType::INT: return "int";
+        case ValueType::FLOAT: return "float";
+        case ValueType::VOID: return "void";
+        case ValueType::STRING: return "string";
+        case ValueType::ERROR: return "<error>";
+    }
+    return "<unknown>";
+}
+
 void IntegerLiteral::accept(ASTVisitor& visitor) {
     visitor.visit(this);
 }
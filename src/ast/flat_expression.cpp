@@ -0,0 +1,186 @@
+#include "ast/flat_expression.h"
+#include "ast/ast_walker.h"
+
+namespace minicompiler {
+
+/**
+ * @brief 按语句顺序收集表达式根，不进入表达式内部
+ *
+ * 顺序与IRBuilder求值的顺序一致：if/while先条件后分支。
+ */
+class FlatExpressionCollector : public ASTWalker<FlatExpressionCollector> {
+public:
+    using ASTWalker<FlatExpressionCollector>::visit;
+
+    explicit FlatExpressionCollector(FlatExpressionTable& table) : table_(table) {}
+
+    void visit(ExpressionStatement* node) {
+        table_.add(node->getExpression());
+    }
+
+    void visit(VarDeclaration* node) {
+        if (node->getInitializer()) {
+            table_.add(node->getInitializer());
+        }
+    }
+
+    void visit(IfStatement* node) {
+        table_.addCondition(node->getCondition());
+        walk(node->getThenBranch());
+        if (node->getElseBranch()) {
+            walk(node->getElseBranch());
+        }
+    }
+
+    void visit(WhileStatement* node) {
+        table_.addCondition(node->getCondition());
+        walk(node->getBody());
+    }
+
+    void visit(ReturnStatement* node) {
+        if (node->getValue()) {
+            table_.add(node->getValue());
+        }
+    }
+
+private:
+    FlatExpressionTable& table_;
+};
+
+void FlatExpressionTable::build(FunctionDeclaration* function) {
+    clear();
+    if (function->getBody()) {
+        FlatExpressionCollector collector(*this);
+        collector.walk(function->getBody());
+    }
+}
+
+void FlatExpressionTable::clear() {
+    nodes_.clear();
+    names_.clear();
+    symbols_.clear();
+    arguments_.clear();
+    ranges_.clear();
+    cursor_ = 0;
+    pending_.clear();
+}
+
+bool FlatExpressionTable::add(Expression* root) {
+    size_t nodeMark = nodes_.size();
+    size_t nameMark = names_.size();
+    size_t argumentMark = arguments_.size();
+
+    bool ok = true;
+    flatten(root, ok);
+    if (!ok) {
+        // 调用方对这个表达式回退到树遍历
+        nodes_.erase(nodes_.begin() + nodeMark, nodes_.end());
+        names_.resize(nameMark);
+        symbols_.resize(nameMark);
+        arguments_.resize(argumentMark);
+        pending_.clear();
+        return false;
+    }
+
+    ranges_.push_back({root, static_cast<uint32_t>(nodeMark), static_cast<uint32_t>(nodes_.size())});
+    return true;
+}
+
+void FlatExpressionTable::addCondition(Expression* condition) {
+    // 与IRBuilder::emitCondition的拆分方式一致
+    if (auto* binary = dynCast<BinaryExpression>(condition)) {
+        if (binary->getOperator() == TokenType::AND || binary->getOperator() == TokenType::OR) {
+            addCondition(binary->getLeft());
+            addCondition(binary->getRight());
+            return;
+        }
+    }
+    if (auto* unary = dynCast<UnaryExpression>(condition)) {
+        if (unary->getOperator() == TokenType::NOT) {
+            addCondition(unary->getOperand());
+            return;
+        }
+    }
+    add(condition);
+}
+
+uint32_t FlatExpressionTable::flatten(Expression* expr, bool& ok) {
+    FlatExpr node(expr->getKind());
+    node.type = expr->getType();
+
+    switch (expr->getKind()) {
+        case ASTNodeKind::IntegerLiteral:
+            node.intValue = static_cast<IntegerLiteral*>(expr)->getValue();
+            break;
+        case ASTNodeKind::FloatLiteral:
+            node.floatValue = static_cast<FloatLiteral*>(expr)->getValue();
+            break;
+        case ASTNodeKind::StringLiteral:
+            node.name = addName(static_cast<StringLiteral*>(expr)->getValue());
+            break;
+        case ASTNodeKind::VariableExpression:
+        {
+            auto* variable = static_cast<VariableExpression*>(expr);
+            node.name = addName(variable->getName(), variable->getSymbol());
+            break;
+        }
+        case ASTNodeKind::BinaryExpression: {
+            auto* binary = static_cast<BinaryExpression*>(expr);
+            node.op = binary->getOperator();
+            if (node.op == TokenType::AND || node.op == TokenType::OR) {
+                // 短路求值需要控制流，留给树遍历
+                ok = false;
+                return 0;
+            }
+            if (node.op == TokenType::ASSIGN) {
+                // 左侧是存储目标，不需要求值
+                auto* target = dynCast<VariableExpression>(binary->getLeft());
+                if (!target) {
+                    ok = false;
+                    return 0;
+                }
+                node.rhs = flatten(binary->getRight(), ok);
+                node.name = addName(target->getName(), target->getSymbol());
+            } else {
+                node.lhs = flatten(binary->getLeft(), ok);
+                node.rhs = flatten(binary->getRight(), ok);
+            }
+            break;
+        }
+        case ASTNodeKind::UnaryExpression: {
+            auto* unary = static_cast<UnaryExpression*>(expr);
+            node.op = unary->getOperator();
+            node.lhs = flatten(unary->getOperand(), ok);
+            break;
+        }
+        case ASTNodeKind::CallExpression: {
+            auto* call = static_cast<CallExpression*>(expr);
+            // 参数子树先按顺序展开（其中可能还有调用），参数根的下标暂存在pending_中，
+            // 最后连续放入参数表
+            size_t mark = pending_.size();
+            for (const auto& arg : call->getArguments()) {
+                pending_.push_back(flatten(arg.get(), ok));
+            }
+            node.lhs = static_cast<uint32_t>(arguments_.size());
+            node.rhs = static_cast<uint32_t>(pending_.size() - mark);
+            arguments_.insert(arguments_.end(), pending_.begin() + mark, pending_.end());
+            pending_.resize(mark);
+            node.name = addName(call->getCallee());
+            break;
+        }
+        default:
+            ok = false;
+            return 0;
+    }
+
+    nodes_.push_back(node);
+    return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+uint32_t FlatExpressionTable::addName(const std::string& name, Symbol symbol) {
+    names_.push_back(&name);
+    symbols_.push_back(symbol);
+    return static_cast<uint32_t>(names_.size() - 1);
+}
+
+} // namespace minicompiler
@@ -1,40 +1,44 @@
 #include "codegen/code_generator.h"
+#include "common/output_file.h"
+#include "common/thread_pool.h"
 #include <iostream>
-#include <fstream>
 #include <sstream>
+#include <algorithm>
+#include <cstdio>
 
 namespace minicompiler {
 
 CodeGenerator::CodeGenerator(const std::string& targetTriple)
-    : targetTriple_(targetTriple) {}
+    : targetTriple_(targetTriple), progress_(&std::cout) {}
 
 bool CodeGenerator::generate(std::shared_ptr<IRModule> module, const std::string& outputFile) {
-    std::cout << "Target triple: " << targetTriple_ << std::endl;
-    
-    // 寄存器分配
-    for (const auto& function : module->getFunctions()) {
-        allocateRegisters(function);
-    }
-    
-    // 指令选择
-    for (const auto& function : module->getFunctions()) {
-        selectInstructions(function);
+    if (progress_) {
+        *progress_ << "Target triple: " << targetTriple_ << std::endl;
     }
     
-    // 生成汇编代码
-    std::string assembly = generateAssembly(module);
-    
-    // 写入输出文件
-    std::ofstream outFile(outputFile);
-    if (!outFile) {
+    // 打开输出文件
+    OutputFile outFile(outputFile);
+    if (!outFile.isOpen()) {
         std::cerr << "Error: Could not open output file '" << outputFile << "'" << std::endl;
         return false;
     }
     
-    outFile << assembly;
-    outFile.close();
+    // 生成汇编代码并直接写入文件（寄存器分配和指令选择按函数进行，可以并行）
+    try {
+        emitAssembly(module, outFile.stream());
+    } catch (const CompilationCancelled&) {
+        outFile.close();
+        std::remove(outputFile.c_str());
+        throw;
+    }
+    if (!outFile.close()) {
+        std::cerr << "Error: Failed to write output file '" << outputFile << "'" << std::endl;
+        return false;
+    }
     
-    std::cout << "Assembly code written to " << outputFile << std::endl;
+    if (progress_) {
+        *progress_ << "Assembly code written to " << outputFile << std::endl;
+    }
     
     // TODO: 调用外部汇编器和链接器生成可执行文件
     
@@ -49,34 +53,62 @@ void CodeGenerator::selectInstructions(std::shared_ptr<IRFunction> function) {
     // TODO: 实现指令选择
 }
 
-std::string CodeGenerator::generateAssembly(std::shared_ptr<IRModule> module) {
+void CodeGenerator::emitAssembly(std::shared_ptr<IRModule> module, std::ostream& os) {
     // 简单地将IR转换为文本形式作为占位符
-    std::stringstream ss;
-    
-    ss << "; Generated assembly for module: " << module->getName() << "\n";
-    ss << "; Target triple: " << targetTriple_ << "\n\n";
+    os << "; Generated assembly for module: " << module->getName() << "\n";
+    os << "; Target triple: " << targetTriple_ << "\n\n";
     
     // 添加一些汇编代码的占位符
-    ss << ".text\n";
+    os << ".text\n";
     
-    for (const auto& function : module->getFunctions()) {
-        ss << ".global " << function->getName() << "\n";
-        ss << function->getName() << ":\n";
-        
-        // 函数序言
-        ss << "    push    %rbp\n";
-        ss << "    mov     %rsp, %rbp\n";
-        
-        // 函数体（简单占位符）
-        ss << "    ; Function body would be generated here\n";
-        
-        // 函数尾声
-        ss << "    mov     %rbp, %rsp\n";
-        ss << "    pop     %rbp\n";
-        ss << "    ret\n\n";
+    const auto& functions = module->getFunctions();
+    if (jobs_ <= 1 || functions.size() <= 1) {
+        for (const auto& function : functions) {
+            emitFunctionAssembly(function, os);
+        }
+        return;
     }
     
-    return ss.str();
+    // 按函数顺序切分为连续的分区并行生成，再按原顺序写出，输出与串行结果一致
+    size_t partitions = std::min<size_t>(jobs_, functions.size());
+    std::vector<std::stringstream> partitionText(partitions);
+    ThreadPool pool(static_cast<unsigned>(partitions));
+    pool.parallelFor(partitions, [&](size_t partition) {
+        size_t begin = functions.size() * partition / partitions;
+        size_t end = functions.size() * (partition + 1) / partitions;
+        for (size_t i = begin; i < end; ++i) {
+            emitFunctionAssembly(functions[i], partitionText[partition]);
+        }
+    });
+    
+    for (auto& text : partitionText) {
+        os << text.rdbuf();
+    }
+}
+
+void CodeGenerator::emitFunctionAssembly(std::shared_ptr<IRFunction> function, std::ostream& os) {
+    throwIfCancelled(cancellation_);
+    
+    // 寄存器分配
+    allocateRegisters(function);
+    
+    // 指令选择
+    selectInstructions(function);
+    
+    os << ".global " << function->getName() << "\n";
+    os << function->getName() << ":\n";
+    
+    // 函数序言
+    os << "    push    %rbp\n";
+    os << "    mov     %rsp, %rbp\n";
+    
+    // 函数体（简单占位符）
+    os << "    ; Function body would be generated here\n";
+    
+    // 函数尾声
+    os << "    mov     %rbp, %rsp\n";
+    os << "    pop     %rbp\n";
+    os << "    ret\n\n";
 }
 
-} // namespace minicompiler 
\ No newline at end of file
+} // namespace minicompiler
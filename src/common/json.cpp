@@ -0,0 +1,197 @@
+#include "common/json.h"
+#include <cstdlib>
+
+namespace minicompiler {
+
+/**
+ * @brief 递归下降的JSON读取器
+ */
+class JsonReader {
+public:
+    explicit JsonReader(const std::string& text) : text_(text) {}
+
+    JsonValue read() {
+        JsonValue value = readValue();
+        skipWhitespace();
+        if (current_ != text_.size()) {
+            throw JsonError("Trailing characters", current_);
+        }
+        return value;
+    }
+
+private:
+    const std::string& text_;
+    size_t current_ = 0;
+
+    void skipWhitespace() {
+        while (current_ < text_.size() &&
+               (text_[current_] == ' ' || text_[current_] == '\t' ||
+                text_[current_] == '\n' || text_[current_] == '\r')) {
+            current_++;
+        }
+    }
+
+    bool consume(char c) {
+        skipWhitespace();
+        if (current_ < text_.size() && text_[current_] == c) {
+            current_++;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) {
+            throw JsonError(std::string("Expected '") + c + "'", current_);
+        }
+    }
+
+    bool consumeWord(const char* word) {
+        size_t length = std::char_traits<char>::length(word);
+        if (text_.compare(current_, length, word) == 0) {
+            current_ += length;
+            return true;
+        }
+        return false;
+    }
+
+    JsonValue readValue() {
+        skipWhitespace();
+        if (current_ >= text_.size()) {
+            throw JsonError("Unexpected end of input", current_);
+        }
+
+        JsonValue value;
+        char c = text_[current_];
+        if (c == '{') {
+            current_++;
+            value.kind_ = JsonValue::Kind::Object;
+            if (!consume('}')) {
+                do {
+                    skipWhitespace();
+                    std::string key = readString();
+                    expect(':');
+                    value.object_[key] = readValue();
+                } while (consume(','));
+                expect('}');
+            }
+        } else if (c == '[') {
+            current_++;
+            value.kind_ = JsonValue::Kind::Array;
+            if (!consume(']')) {
+                do {
+                    value.array_.push_back(readValue());
+                } while (consume(','));
+                expect(']');
+            }
+        } else if (c == '"') {
+            value.kind_ = JsonValue::Kind::String;
+            value.string_ = readString();
+        } else if (consumeWord("true")) {
+            value.kind_ = JsonValue::Kind::Bool;
+            value.boolValue_ = true;
+        } else if (consumeWord("false")) {
+            value.kind_ = JsonValue::Kind::Bool;
+        } else if (consumeWord("null")) {
+            value.kind_ = JsonValue::Kind::Null;
+        } else {
+            const char* begin = text_.c_str() + current_;
+            char* end = nullptr;
+            value.number_ = std::strtod(begin, &end);
+            if (end == begin) {
+                throw JsonError("Unexpected character", current_);
+            }
+            value.kind_ = JsonValue::Kind::Number;
+            current_ += static_cast<size_t>(end - begin);
+        }
+        return value;
+    }
+
+    std::string readString() {
+        if (current_ >= text_.size() || text_[current_] != '"') {
+            throw JsonError("Expected string", current_);
+        }
+        current_++;
+
+        std::string result;
+        while (current_ < text_.size() && text_[current_] != '"') {
+            char c = text_[current_++];
+            if (c != '\\') {
+                result += c;
+                continue;
+            }
+            if (current_ >= text_.size()) {
+                break;
+            }
+            char escape = text_[current_++];
+            switch (escape) {
+                case 'n': result += '\n'; break;
+                case 't': result += '\t'; break;
+                case 'r': result += '\r'; break;
+                case 'b': result += '\b'; break;
+                case 'f': result += '\f'; break;
+                case 'u': {
+                    // 基准名称只含ASCII，非ASCII码点按UTF-8编码
+                    unsigned code = static_cast<unsigned>(
+                        std::strtoul(text_.substr(current_, 4).c_str(), nullptr, 16));
+                    current_ += 4;
+                    if (code < 0x80) {
+                        result += static_cast<char>(code);
+                    } else if (code < 0x800) {
+                        result += static_cast<char>(0xC0 | (code >> 6));
+                        result += static_cast<char>(0x80 | (code & 0x3F));
+                    } else {
+                        result += static_cast<char>(0xE0 | (code >> 12));
+                        result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                        result += static_cast<char>(0x80 | (code & 0x3F));
+                    }
+                    break;
+                }
+                default: result += escape; break;
+            }
+        }
+
+        if (current_ >= text_.size()) {
+            throw JsonError("Unterminated string", current_);
+        }
+        current_++;
+        return result;
+    }
+};
+
+JsonValue JsonValue::parse(const std::string& text) {
+    return JsonReader(text).read();
+}
+
+const JsonValue* JsonValue::find(const std::string& key) const {
+    auto it = object_.find(key);
+    return it == object_.end() ? nullptr : &it->second;
+}
+
+std::string jsonQuote(const std::string& text) {
+    std::string result = "\"";
+    for (char c : text) {
+        switch (c) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                // 其它控制字符必须写成\u转义
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    static const char digits[] = "0123456789abcdef";
+                    result += "\\u00";
+                    result += digits[(c >> 4) & 0xF];
+                    result += digits[c & 0xF];
+                } else {
+                    result += c;
+                }
+                break;
+        }
+    }
+    result += '"';
+    return result;
+}
+
+} // namespace minicompiler
@@ -0,0 +1,56 @@
+#include "common/output_file.h"
+#include <memory>
+
+namespace minicompiler {
+
+namespace {
+
+// 每个线程复用的写缓冲区
+struct ThreadBuffer {
+    std::unique_ptr<char[]> data;
+    bool inUse = false;
+};
+
+thread_local ThreadBuffer threadBuffer;
+
+} // namespace
+
+OutputFile::OutputFile(const std::string& path) {
+    if (!threadBuffer.inUse) {
+        if (!threadBuffer.data) {
+            threadBuffer.data.reset(new char[kBufferSize]);
+        }
+        threadBuffer.inUse = true;
+        buffer_ = threadBuffer.data.get();
+    } else {
+        buffer_ = new char[kBufferSize];
+        ownsBuffer_ = true;
+    }
+
+    // 缓冲区必须在打开文件之前设置
+    file_.rdbuf()->pubsetbuf(buffer_, kBufferSize);
+    file_.open(path, std::ios::out | std::ios::trunc | std::ios::binary);
+}
+
+OutputFile::~OutputFile() {
+    close();
+
+    if (ownsBuffer_) {
+        delete[] buffer_;
+    } else {
+        threadBuffer.inUse = false;
+    }
+}
+
+bool OutputFile::close() {
+    if (!file_.is_open()) {
+        return !file_.fail();
+    }
+
+    file_.flush();
+    bool ok = !file_.fail();
+    file_.close();
+    return ok && !file_.fail();
+}
+
+} // namespace minicompiler
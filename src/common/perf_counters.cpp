@@ -0,0 +1,176 @@
+#include "common/perf_counters.h"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace minicompiler {
+
+PerfCounterValues& PerfCounterValues::operator+=(const PerfCounterValues& other) {
+    for (size_t i = 0; i < kPerfCounterCount; ++i) {
+        available[i] = available[i] && other.available[i];
+        values[i] += other.values[i];
+    }
+    return *this;
+}
+
+const char* PerfCounters::name(PerfCounter counter) {
+    switch (counter) {
+        case PerfCounter::CYCLES: return "cycles";
+        case PerfCounter::INSTRUCTIONS: return "instructions";
+        case PerfCounter::BRANCH_MISSES: return "branch-misses";
+        case PerfCounter::L1D_MISSES: return "L1-dcache-load-misses";
+        case PerfCounter::LLC_MISSES: return "LLC-load-misses";
+        case PerfCounter::DTLB_MISSES: return "dTLB-load-misses";
+        default: return "unknown";
+    }
+}
+
+#ifdef __linux__
+
+namespace {
+
+uint64_t cacheConfig(uint64_t cache, uint64_t op, uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+}
+
+int openCounter(PerfCounter counter) {
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    switch (counter) {
+        case PerfCounter::CYCLES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PerfCounter::INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PerfCounter::BRANCH_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case PerfCounter::L1D_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                                      PERF_COUNT_HW_CACHE_RESULT_MISS);
+            break;
+        case PerfCounter::LLC_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cacheConfig(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ,
+                                      PERF_COUNT_HW_CACHE_RESULT_MISS);
+            break;
+        case PerfCounter::DTLB_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cacheConfig(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                                      PERF_COUNT_HW_CACHE_RESULT_MISS);
+            break;
+        default:
+            return -1;
+    }
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+} // namespace
+
+PerfCounters::PerfCounters() {
+    int lastErrno = 0;
+    for (size_t i = 0; i < kPerfCounterCount; ++i) {
+        fds_[i] = openCounter(static_cast<PerfCounter>(i));
+        if (fds_[i] < 0) {
+            lastErrno = errno;
+        }
+    }
+
+    if (!isAvailable()) {
+        error_ = std::string("perf_event_open failed: ") + std::strerror(lastErrno);
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+bool PerfCounters::isAvailable() const {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PerfCounters::start() {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+PerfCounterValues PerfCounters::stop() {
+    PerfCounterValues result;
+    for (size_t i = 0; i < kPerfCounterCount; ++i) {
+        if (fds_[i] < 0) {
+            continue;
+        }
+        ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+
+        // value, time_enabled, time_running
+        uint64_t data[3] = {0, 0, 0};
+        if (read(fds_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+            continue;
+        }
+
+        // 计数器数量超过硬件寄存器时内核会轮流调度，按实际运行时间比例换算
+        if (data[2] > 0 && data[2] < data[1]) {
+            data[0] = static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]);
+        } else if (data[2] == 0 && data[1] > 0) {
+            continue;
+        }
+
+        result.values[i] = data[0];
+        result.available[i] = true;
+    }
+    return result;
+}
+
+#else
+
+PerfCounters::PerfCounters() : error_("hardware counters are only supported on Linux") {
+    fds_.fill(-1);
+}
+
+PerfCounters::~PerfCounters() = default;
+
+bool PerfCounters::isAvailable() const {
+    return false;
+}
+
+void PerfCounters::start() {}
+
+PerfCounterValues PerfCounters::stop() {
+    return PerfCounterValues();
+}
+
+#endif
+
+} // namespace minicompiler
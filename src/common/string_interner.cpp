@@ -0,0 +1,69 @@
+#include "common/string_interner.h"
+#include <algorithm>
+
+namespace minicompiler {
+
+uint32_t StringInterner::hash(std::string_view text) {
+    // FNV-1a：标识符很短，逐字节计算足够快
+    uint32_t h = 2166136261u;
+    for (char c : text) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+StringInterner::Slot& StringInterner::probe(std::string_view text, uint32_t h) {
+    size_t mask = slots_.size() - 1;
+    for (size_t i = h & mask;; i = (i + 1) & mask) {
+        Slot& slot = slots_[i];
+        if (slot.symbol == kNoSymbol || (slot.hash == h && strings_[slot.symbol] == text)) {
+            return slot;
+        }
+    }
+}
+
+void StringInterner::grow() {
+    std::vector<Slot> old = std::move(slots_);
+    slots_.assign(old.empty() ? 64 : old.size() * 2, Slot{0, kNoSymbol});
+    size_t mask = slots_.size() - 1;
+    for (const Slot& slot : old) {
+        if (slot.symbol == kNoSymbol) {
+            continue;
+        }
+        size_t i = slot.hash & mask;
+        while (slots_[i].symbol != kNoSymbol) {
+            i = (i + 1) & mask;
+        }
+        slots_[i] = slot;
+    }
+}
+
+Symbol StringInterner::intern(std::string_view text) {
+    if ((strings_.size() + 1) * 2 > slots_.size()) {
+        grow();
+    }
+
+    uint32_t h = hash(text);
+    Slot& slot = probe(text, h);
+    if (slot.symbol == kNoSymbol) {
+        slot.hash = h;
+        slot.symbol = static_cast<Symbol>(strings_.size());
+        strings_.emplace_back(text);
+    }
+    return slot.symbol;
+}
+
+void StringInterner::clear() {
+    strings_.clear();
+    std::fill(slots_.begin(), slots_.end(), Slot{0, kNoSymbol});
+}
+
+Symbol StringInterner::find(std::string_view text) const {
+    if (slots_.empty()) {
+        return kNoSymbol;
+    }
+    return const_cast<StringInterner*>(this)->probe(text, hash(text)).symbol;
+}
+
+} // namespace minicompiler
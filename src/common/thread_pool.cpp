@@ -0,0 +1,113 @@
+#include "common/thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace minicompiler {
+
+namespace {
+
+// 当前线程是否是某个线程池的工作线程
+thread_local bool isWorkerThread = false;
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    workers_.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        workers_.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    condition_.notify_all();
+
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+
+    // 单任务、单线程或嵌套调用时直接串行执行
+    if (count == 1 || workers_.size() <= 1 || isWorkerThread) {
+        for (size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+
+    // 每个工作线程从共享计数器领取下一个下标，调用线程也参与执行
+    std::atomic<size_t> next{0};
+    std::exception_ptr firstError;
+    std::mutex errorMutex;
+
+    auto drain = [&]() {
+        size_t index;
+        while ((index = next.fetch_add(1)) < count) {
+            try {
+                body(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!firstError) {
+                    firstError = std::current_exception();
+                }
+            }
+        }
+    };
+
+    size_t helpers = std::min(count - 1, workers_.size());
+    std::vector<std::future<void>> pending;
+    pending.reserve(helpers);
+    for (size_t i = 0; i < helpers; ++i) {
+        pending.push_back(submit(drain));
+    }
+
+    drain();
+    for (auto& future : pending) {
+        future.wait();
+    }
+
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push(std::move(task));
+    }
+    condition_.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+    isWorkerThread = true;
+
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (stopping_ && tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop();
+        }
+        task();
+    }
+}
+
+} // namespace minicompiler
@@ -0,0 +1,146 @@
+#include "common/time_report.h"
+#include <cstdio>
+
+namespace minicompiler {
+
+TimeReport::Phase::Phase(TimeReport* report, std::string name)
+    : report_(report), name_(std::move(name)) {
+    if (report_) {
+        if (report_->counters_) {
+            report_->counters_->start();
+        }
+        start_ = std::chrono::steady_clock::now();
+    }
+}
+
+TimeReport::Phase::Phase(Phase&& other) noexcept
+    : report_(other.report_), name_(std::move(other.name_)), start_(other.start_) {
+    other.report_ = nullptr;
+}
+
+TimeReport::Phase::~Phase() {
+    if (!report_) {
+        return;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+    PerfCounterValues counters;
+    if (report_->counters_) {
+        counters = report_->counters_->stop();
+    }
+    report_->record(name_, elapsed.count(), counters);
+}
+
+TimeReport::TimeReport(bool enabled, bool hardwareCounters)
+    : enabled_(enabled), start_(std::chrono::steady_clock::now()) {
+    if (enabled_ && hardwareCounters) {
+        counters_ = std::make_unique<PerfCounters>();
+    }
+}
+
+void TimeReport::record(const std::string& name, double seconds, const PerfCounterValues& counters) {
+    for (auto& entry : entries_) {
+        if (entry.name == name) {
+            entry.seconds += seconds;
+            entry.count++;
+            entry.counters += counters;
+            return;
+        }
+    }
+
+    Entry entry;
+    entry.name = name;
+    entry.seconds = seconds;
+    entry.count = 1;
+    entry.counters = counters;
+    entries_.push_back(std::move(entry));
+}
+
+namespace {
+
+/**
+ * @brief 每千条指令的事件数，计数器不可用时输出"-"
+ */
+std::string perKiloInstructions(const PerfCounterValues& counters, PerfCounter counter) {
+    if (!counters.has(counter) || !counters.has(PerfCounter::INSTRUCTIONS) ||
+        counters.get(PerfCounter::INSTRUCTIONS) == 0) {
+        return "-";
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.2f",
+                  1000.0 * static_cast<double>(counters.get(counter)) /
+                      static_cast<double>(counters.get(PerfCounter::INSTRUCTIONS)));
+    return buffer;
+}
+
+std::string count(const PerfCounterValues& counters, PerfCounter counter) {
+    if (!counters.has(counter)) {
+        return "-";
+    }
+    return std::to_string(counters.get(counter));
+}
+
+std::string ipc(const PerfCounterValues& counters) {
+    if (!counters.has(PerfCounter::CYCLES) || !counters.has(PerfCounter::INSTRUCTIONS) ||
+        counters.get(PerfCounter::CYCLES) == 0) {
+        return "-";
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.2f",
+                  static_cast<double>(counters.get(PerfCounter::INSTRUCTIONS)) /
+                      static_cast<double>(counters.get(PerfCounter::CYCLES)));
+    return buffer;
+}
+
+} // namespace
+
+void TimeReport::print(std::ostream& os) const {
+    if (!enabled_) {
+        return;
+    }
+
+    std::chrono::duration<double> total = std::chrono::steady_clock::now() - start_;
+    bool hardware = counters_ && counters_->isAvailable();
+    char line[256];
+
+    os << "===-------------------------------------------------------------===\n"
+       << "                     Compilation time report\n"
+       << "===-------------------------------------------------------------===\n";
+
+    std::snprintf(line, sizeof(line), "  %-22s %10s %7s", "Phase", "Wall (s)", "%");
+    os << line;
+    if (hardware) {
+        // MPKI：每千条指令的缺失次数
+        std::snprintf(line, sizeof(line), " %14s %14s %6s %9s %9s %9s %9s", "Cycles", "Instructions",
+                      "IPC", "BrMPKI", "L1dMPKI", "LLCMPKI", "dTLBMPKI");
+        os << line;
+    }
+    os << '\n';
+
+    for (const auto& entry : entries_) {
+        std::snprintf(line, sizeof(line), "  %-22s %10.4f %6.1f%%", entry.name.c_str(), entry.seconds,
+                      total.count() > 0.0 ? 100.0 * entry.seconds / total.count() : 0.0);
+        os << line;
+        if (hardware) {
+            const PerfCounterValues& c = entry.counters;
+            std::snprintf(line, sizeof(line), " %14s %14s %6s %9s %9s %9s %9s",
+                          count(c, PerfCounter::CYCLES).c_str(),
+                          count(c, PerfCounter::INSTRUCTIONS).c_str(), ipc(c).c_str(),
+                          perKiloInstructions(c, PerfCounter::BRANCH_MISSES).c_str(),
+                          perKiloInstructions(c, PerfCounter::L1D_MISSES).c_str(),
+                          perKiloInstructions(c, PerfCounter::LLC_MISSES).c_str(),
+                          perKiloInstructions(c, PerfCounter::DTLB_MISSES).c_str());
+            os << line;
+        }
+        os << '\n';
+    }
+
+    std::snprintf(line, sizeof(line), "  %-22s %10.4f %6.1f%%\n", "Total", total.count(), 100.0);
+    os << line;
+
+    if (counters_ && !hardware) {
+        os << "  (hardware counters unavailable: " << counters_->getError() << ")\n";
+    }
+}
+
+} // namespace minicompiler
@@ -0,0 +1,215 @@
+#include "driver/batch_compiler.h"
+#include <condition_variable>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include "codegen/code_generator.h"
+#include "common/json.h"
+
+namespace minicompiler {
+
+namespace {
+
+/**
+ * @brief 把记录中的flags应用到编译选项上
+ * @param flags flags数组
+ * @param options 编译选项
+ * @param outputFile 输出："-o"指定的目标文件
+ */
+void applyFlags(const JsonValue& flags, CompileOptions& options, std::string& outputFile) {
+    if (!flags.isArray()) {
+        throw std::runtime_error("'flags' must be an array of strings");
+    }
+    const auto& values = flags.asArray();
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (!values[i].isString()) {
+            throw std::runtime_error("'flags' must be an array of strings");
+        }
+        const std::string& flag = values[i].asString();
+        if (flag == "-O0" || flag == "-O1" || flag == "-O2") {
+            options.optimizationLevel = flag[2] - '0';
+        } else if (flag == "--emit-ir") {
+            options.emitIR = true;
+        } else if (flag == "--from-ir") {
+            options.fromIR = true;
+        } else if (flag == "--lazy-functions") {
+            options.lazyFunctions = true;
+        } else if (flag.compare(0, 14, "--time-budget=") == 0 && std::atoi(flag.c_str() + 14) > 0) {
+            options.timeBudget = std::chrono::milliseconds(std::atoi(flag.c_str() + 14));
+        } else if (flag == "-o" && i + 1 < values.size() && values[i + 1].isString()) {
+            outputFile = values[++i].asString();
+        } else {
+            throw std::runtime_error("Unsupported flag '" + flag + "'");
+        }
+    }
+}
+
+/**
+ * @brief 读取下一个非空行
+ * @return 输入结束时返回false
+ */
+bool readRecord(std::istream& input, std::string& line) {
+    while (std::getline(input, line)) {
+        if (line.find_first_not_of(" \t\r") != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+BatchCompiler::BatchCompiler(BatchOptions options) : options_(std::move(options)) {
+    // 结果写到输出流中，进度信息和计时会混入结果
+    options_.defaults.progress = nullptr;
+    options_.defaults.timeReport = nullptr;
+}
+
+size_t BatchCompiler::run(std::istream& input, std::ostream& output) {
+    std::string line;
+    size_t failures = 0;
+
+    if (options_.jobs <= 1) {
+        CompilerContext context(1);
+        for (size_t index = 0; readRecord(input, line); ++index) {
+            bool failed = false;
+            output << compileRecord(context, index, line, failed) << std::endl;
+            failures += failed ? 1 : 0;
+        }
+        return failures;
+    }
+
+    // 调用线程读取记录放入有界队列，工作线程各用一个上下文编译；
+    // 有序输出时先完成的结果暂存，等前面的结果写出后再写
+    std::mutex mutex;
+    std::condition_variable queueNotEmpty;
+    std::condition_variable queueNotFull;
+    std::queue<std::pair<size_t, std::string>> queue;
+    const size_t capacity = static_cast<size_t>(options_.jobs) * 4;
+    bool finished = false;
+
+    std::mutex outputMutex;
+    std::map<size_t, std::string> pending;
+    size_t nextIndex = 0;
+
+    auto worker = [&]() {
+        CompilerContext context(1);
+        while (true) {
+            std::pair<size_t, std::string> record;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                queueNotEmpty.wait(lock, [&]() { return finished || !queue.empty(); });
+                if (queue.empty()) {
+                    return;
+                }
+                record = std::move(queue.front());
+                queue.pop();
+            }
+            queueNotFull.notify_one();
+
+            bool failed = false;
+            std::string result = compileRecord(context, record.first, record.second, failed);
+
+            std::lock_guard<std::mutex> lock(outputMutex);
+            failures += failed ? 1 : 0;
+            if (!options_.ordered) {
+                output << result << std::endl;
+                continue;
+            }
+            pending.emplace(record.first, std::move(result));
+            for (auto it = pending.begin(); it != pending.end() && it->first == nextIndex; it = pending.erase(it)) {
+                output << it->second << std::endl;
+                nextIndex++;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < options_.jobs; ++i) {
+        workers.emplace_back(worker);
+    }
+
+    for (size_t index = 0; readRecord(input, line); ++index) {
+        std::unique_lock<std::mutex> lock(mutex);
+        queueNotFull.wait(lock, [&]() { return queue.size() < capacity; });
+        queue.emplace(index, std::move(line));
+        lock.unlock();
+        queueNotEmpty.notify_one();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+    }
+    queueNotEmpty.notify_all();
+
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    return failures;
+}
+
+std::string BatchCompiler::compileRecord(CompilerContext& context, size_t index, const std::string& line,
+                                         bool& failed) {
+    std::string name;
+    std::vector<std::string> diagnostics;
+    CompileResult result;
+
+    try {
+        JsonValue record = JsonValue::parse(line);
+        if (!record.isObject()) {
+            throw std::runtime_error("Record must be a JSON object");
+        }
+        if (const JsonValue* value = record.find("name")) {
+            name = value->asString();
+        }
+        const JsonValue* source = record.find("source");
+        if (!source || !source->isString()) {
+            throw std::runtime_error("Record has no 'source' string");
+        }
+
+        CompileOptions options = options_.defaults;
+        options.moduleName = name.empty() ? "module" : name;
+        std::string outputFile;
+        if (const JsonValue* flags = record.find("flags")) {
+            applyFlags(*flags, options, outputFile);
+        }
+
+        result = context.compile(source->asString(), options);
+        for (const auto& diagnostic : result.diagnostics) {
+            diagnostics.push_back(diagnostic.toString());
+        }
+
+        if (result.success && !outputFile.empty()) {
+            CodeGenerator codeGen("x86_64-unknown-linux-gnu");
+            codeGen.setProgressStream(nullptr);
+            if (!codeGen.generate(result.module, outputFile)) {
+                result.success = false;
+                diagnostics.push_back("Error: Could not write '" + outputFile + "'");
+            }
+        }
+    } catch (const std::exception& e) {
+        // 格式错误的记录和IR文本错误只影响这一个记录
+        result.success = false;
+        diagnostics.push_back(std::string("Error: ") + e.what());
+    }
+
+    failed = !result.success;
+
+    std::string json = "{\"index\": " + std::to_string(index) + ", \"name\": " + jsonQuote(name) +
+                       ", \"success\": " + (result.success ? "true" : "false") + ", \"diagnostics\": [";
+    for (size_t i = 0; i < diagnostics.size(); ++i) {
+        json += (i > 0 ? ", " : "") + jsonQuote(diagnostics[i]);
+    }
+    json += "]";
+    if (result.success && !result.ir.empty()) {
+        json += ", \"ir\": " + jsonQuote(result.ir);
+    }
+    json += "}";
+    return json;
+}
+
+} // namespace minicompiler
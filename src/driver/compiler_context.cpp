@@ -0,0 +1,150 @@
+#include "driver/compiler_context.h"
+#include <sstream>
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+#include "semantic/semantic_analyzer.h"
+#include "ir/ir_builder.h"
+#include "ir/ir_parser.h"
+#include "optimizer/optimizer.h"
+
+namespace minicompiler {
+
+namespace {
+
+/**
+ * @brief 开始一个阶段：输出进度并计时
+ */
+TimeReport::Phase beginPhase(const CompileOptions& options, const char* name, const char* progress) {
+    if (options.progress) {
+        *options.progress << progress << std::endl;
+    }
+    return options.timeReport ? options.timeReport->phase(name) : TimeReport::Phase(nullptr, name);
+}
+
+} // namespace
+
+std::string Diagnostic::toString() const {
+    std::ostringstream oss;
+    oss << kind << ": " << message << " at line " << location.line << ", column " << location.column;
+    return oss.str();
+}
+
+CompilerContext::CompilerContext(unsigned jobs)
+    : pool_(jobs), interner_(std::make_shared<StringInterner>()) {}
+
+CompileResult CompilerContext::compile(const std::string& source, const CompileOptions& options) {
+    compileCount_++;
+    try {
+        return compileModule(source, options);
+    } catch (const CompilationCancelled&) {
+        CompileResult result;
+        result.cancelled = true;
+        return result;
+    }
+}
+
+std::future<CompileResult> CompilerContext::compileAsync(std::string source, CompileOptions options) {
+    return std::async(std::launch::async, [this, source = std::move(source), options = std::move(options)]() {
+        return compile(source, options);
+    });
+}
+
+CompileResult CompilerContext::compileModule(const std::string& source, const CompileOptions& options) {
+    CompileResult result;
+    const CancellationToken* cancellation = options.cancellation.get();
+    const auto start = std::chrono::steady_clock::now();
+
+    if (options.fromIR || source.compare(0, 11, "; ModuleID ") == 0) {
+        // 直接解析IR文本，跳过前端
+        auto phase = beginPhase(options, "IR parsing", "Parsing IR...");
+        IRParser irParser(source, options.moduleName);
+        result.module = irParser.parse();
+    } else {
+        result.module = buildModule(source, options, result.diagnostics);
+    }
+    if (!result.module) {
+        return result;
+    }
+
+    if (options.optimizationLevel > 0) {
+        std::ostringstream progress;
+        progress << "Optimizing IR (level " << options.optimizationLevel << ")...";
+        auto phase = beginPhase(options, "Optimization", progress.str().c_str());
+        Optimizer optimizer(options.optimizationLevel);
+        optimizer.setProgressStream(options.progress);
+        optimizer.setCancellationToken(cancellation);
+        if (options.timeBudget.count() > 0) {
+            optimizer.setDeadline(start + options.timeBudget);
+        }
+        result.module = optimizer.optimize(result.module);
+        result.skippedPasses = optimizer.getSkipped();
+    }
+
+    if (options.emitIR) {
+        auto phase = beginPhase(options, "IR emission", "Printing IR...");
+        std::ostringstream ir;
+        result.module->print(ir);
+        result.ir = ir.str();
+    }
+
+    result.success = true;
+    return result;
+}
+
+std::shared_ptr<IRModule> CompilerContext::buildModule(const std::string& source, const CompileOptions& options,
+                                                       std::vector<Diagnostic>& diagnostics) {
+    // 上一次编译的AST已经销毁，驻留表只有上下文持有时原地清空，否则换一个新的
+    if (interner_.use_count() == 1) {
+        interner_->clear();
+    } else {
+        interner_ = std::make_shared<StringInterner>();
+    }
+
+    std::vector<Token> tokens;
+    {
+        auto phase = beginPhase(options, "Lexical analysis", "Lexical analysis...");
+        Lexer lexer(source);
+        lexer.setCancellationToken(options.cancellation.get());
+        tokens = lexer.scanTokens();
+    }
+
+    std::unique_ptr<Program> ast;
+    {
+        auto phase = beginPhase(options, "Syntax analysis", "Syntax analysis...");
+        Parser parser(std::move(tokens));
+        parser.setParallelJobs(pool_.getThreadCount());
+        parser.setThreadPool(&pool_);
+        parser.setInterner(interner_);
+        parser.setLazyFunctionBodies(options.lazyFunctions);
+        parser.setCancellationToken(options.cancellation.get());
+        ast = parser.parse();
+        if (parser.hadError()) {
+            for (const auto& error : parser.getErrors()) {
+                diagnostics.push_back({"Parse error", error.what(), error.getLocation()});
+            }
+            return nullptr;
+        }
+    }
+
+    // 在生成IR之前报告所有名字和类型错误
+    throwIfCancelled(options.cancellation.get());
+    {
+        auto phase = beginPhase(options, "Semantic analysis", "Semantic analysis...");
+        SemanticAnalyzer analyzer;
+        analyzer.setParallelJobs(pool_.getThreadCount());
+        analyzer.setThreadPool(&pool_);
+        if (!analyzer.analyze(ast.get())) {
+            for (const auto& error : analyzer.getErrors()) {
+                diagnostics.push_back({"Semantic error", error.message, error.location});
+            }
+            return nullptr;
+        }
+    }
+
+    auto phase = beginPhase(options, "IR generation", "Generating IR...");
+    IRBuilder irBuilder(options.moduleName);
+    irBuilder.setCancellationToken(options.cancellation.get());
+    return irBuilder.build(ast.get());
+}
+
+} // namespace minicompiler
@@ -1,6 +1,7 @@
 #include "ir/ir.h"
 #include <sstream>
 #include <iomanip>
+#include <cstdlib>
 
 namespace minicompiler {
 
@@ -41,6 +42,7 @@ std::string irOpcodeToString(IROpcode opcode) {
         
         case IROpcode::JMP: return "jmp";
         case IROpcode::JMP_IF: return "jmp_if";
+        case IROpcode::BR: return "br";
         case IROpcode::CALL: return "call";
         case IROpcode::RET: return "ret";
         
@@ -62,93 +64,194 @@ std::string IRIntConstant::toString() const {
 std::string IRFloatConstant::toString() const {
     std::ostringstream oss;
     oss << std::fixed << std::setprecision(6) << value_;
+    
+    // 6位小数无法精确还原时改用完整精度，保证IR文本可以被重新解析
+    if (std::strtof(oss.str().c_str(), nullptr) != value_) {
+        oss.str("");
+        oss << std::defaultfloat << std::setprecision(9) << value_;
+    }
     return oss.str();
 }
 
+std::string IRStringConstant::toString() const {
+    static const char kHexDigits[] = "0123456789ABCDEF";
+    std::string text = "\"";
+    for (char c : value_) {
+        auto byte = static_cast<unsigned char>(c);
+        if (byte < 0x20 || byte >= 0x7F || c == '"' || c == '\\') {
+            text += '\\';
+            text += kHexDigits[byte >> 4];
+            text += kHexDigits[byte & 0xF];
+        } else {
+            text += c;
+        }
+    }
+    text += '"';
+    return text;
+}
+
 std::string IRIdentifier::toString() const {
     return "%" + name_;
 }
 
 std::string IRLabel::toString() const {
-    return name_ + ":";
+    return getName() + ":";
+}
+
+std::string IRFunctionRef::toString() const {
+    return "@" + name_;
+}
+
+std::string IRInstruction::getCallee() const {
+    if (opcode_ != IROpcode::CALL || operands_.empty()) {
+        return "";
+    }
+    if (auto* ref = dynamic_cast<IRFunctionRef*>(operands_[0].get())) {
+        return ref->getName();
+    }
+    return "";
 }
 
 std::string IRInstruction::toString() const {
     std::ostringstream oss;
-    
+    print(oss);
+    return oss.str();
+}
+
+void IRInstruction::print(std::ostream& os) const {
     // 输出结果
     if (result_) {
-        oss << result_->toString() << " = ";
+        result_->print(os);
+        os << " = ";
     }
     
     // 输出操作码
-    oss << irOpcodeToString(opcode_);
+    os << irOpcodeToString(opcode_);
     
-    // 输出操作数
-    if (!operands_.empty()) {
-        oss << " ";
-        for (size_t i = 0; i < operands_.size(); ++i) {
-            if (i > 0) {
-                oss << ", ";
-            }
-            oss << operands_[i]->toString();
-        }
+    // alloca 输出分配的类型
+    if (opcode_ == IROpcode::ALLOCA && result_) {
+        os << ' ' << irTypeToString(result_->getType());
     }
     
-    return oss.str();
+    // 输出操作数
+    for (size_t i = 0; i < operands_.size(); ++i) {
+        os << (i > 0 ? ", " : " ");
+        operands_[i]->print(os);
+    }
+}
+
+IRBasicBlock::~IRBasicBlock() {
+    // 跳转指令可能比基本块活得久，保留名字以便输出
+    if (label_) {
+        label_->name_ = name_;
+        label_->block_ = nullptr;
+    }
+}
+
+const std::shared_ptr<IRLabel>& IRBasicBlock::getLabel() {
+    if (!label_) {
+        label_ = std::shared_ptr<IRLabel>(new IRLabel(this));
+    }
+    return label_;
 }
 
 std::string IRBasicBlock::toString() const {
     std::ostringstream oss;
-    
+    print(oss);
+    return oss.str();
+}
+
+void IRBasicBlock::print(std::ostream& os) const {
     // 输出基本块标签
-    oss << name_ << ":\n";
+    os << name_ << ":\n";
     
     // 输出指令
     for (const auto& instruction : instructions_) {
-        oss << "  " << instruction->toString() << "\n";
+        os << "  ";
+        instruction->print(os);
+        os << '\n';
     }
-    
-    return oss.str();
 }
 
 std::string IRFunction::toString() const {
     std::ostringstream oss;
-    
+    print(oss);
+    return oss.str();
+}
+
+void IRFunction::print(std::ostream& os) const {
     // 输出函数签名
-    oss << "define " << irTypeToString(returnType_) << " @" << name_ << "(";
+    os << "define ";
+    printSignature(os);
+    os << " {\n";
+    
+    // 输出基本块
+    for (const auto& block : blocks_) {
+        block->print(os);
+    }
+    
+    os << "}\n";
+}
+
+void IRFunction::printDeclaration(std::ostream& os) const {
+    os << "declare ";
+    printSignature(os);
+    os << '\n';
+}
+
+void IRFunction::printSignature(std::ostream& os) const {
+    os << irTypeToString(returnType_) << " @" << name_ << "(";
     
     // 输出参数
     for (size_t i = 0; i < parameters_.size(); ++i) {
         if (i > 0) {
-            oss << ", ";
+            os << ", ";
         }
-        oss << irTypeToString(parameters_[i].type) << " %" << parameters_[i].name;
+        os << irTypeToString(parameters_[i].type) << " %" << parameters_[i].name;
     }
-    oss << ") {\n";
-    
-    // 输出基本块
+    os << ")";
+}
+
+size_t IRFunction::getInstructionCount() const {
+    size_t count = 0;
     for (const auto& block : blocks_) {
-        oss << block->toString();
+        count += block->getInstructions().size();
     }
-    
-    oss << "}\n";
-    
-    return oss.str();
+    return count;
+}
+
+std::shared_ptr<IRFunction> IRModule::getFunction(const std::string& name) const {
+    for (const auto& function : functions_) {
+        if (function->getName() == name) {
+            return function;
+        }
+    }
+    return nullptr;
 }
 
 std::string IRModule::toString() const {
     std::ostringstream oss;
-    
+    print(oss);
+    return oss.str();
+}
+
+void IRModule::print(std::ostream& os) const {
     // 输出模块名
-    oss << "; ModuleID = '" << name_ << "'\n\n";
+    os << "; ModuleID = '" << name_ << "'\n\n";
+    
+    // 输出外部函数声明
+    for (const auto& declaration : declarations_) {
+        declaration->printDeclaration(os);
+    }
+    if (!declarations_.empty()) {
+        os << '\n';
+    }
     
     // 输出函数
     for (const auto& function : functions_) {
-        oss << function->toString() << "\n";
+        function->print(os);
+        os << '\n';
     }
-    
-    return oss.str();
 }
 
-} // namespace minicompiler 
\ No newline at end of file
+} // namespace minicompiler
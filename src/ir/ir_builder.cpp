@@ -1,23 +1,87 @@
 #include "ir/ir_builder.h"
 #include <iostream>
 #include <sstream>
+#include <unordered_set>
 
 namespace minicompiler {
 
+namespace {
+
+/**
+ * @brief 二元运算符对应的IR操作码
+ * @return 不支持的运算符返回false
+ */
+bool binaryOpcode(TokenType op, IROpcode& opcode) {
+    switch (op) {
+        case TokenType::PLUS: opcode = IROpcode::ADD; return true;
+        case TokenType::MINUS: opcode = IROpcode::SUB; return true;
+        case TokenType::MULTIPLY: opcode = IROpcode::MUL; return true;
+        case TokenType::DIVIDE: opcode = IROpcode::DIV; return true;
+        case TokenType::MODULO: opcode = IROpcode::MOD; return true;
+        case TokenType::EQUAL: opcode = IROpcode::CMP_EQ; return true;
+        case TokenType::NOT_EQUAL: opcode = IROpcode::CMP_NE; return true;
+        case TokenType::LESS: opcode = IROpcode::CMP_LT; return true;
+        case TokenType::LESS_EQUAL: opcode = IROpcode::CMP_LE; return true;
+        case TokenType::GREATER: opcode = IROpcode::CMP_GT; return true;
+        case TokenType::GREATER_EQUAL: opcode = IROpcode::CMP_GE; return true;
+        default: return false;
+    }
+}
+
+/**
+ * @brief 一元运算符对应的IR操作码
+ * @return 不支持的运算符返回false
+ */
+bool unaryOpcode(TokenType op, IROpcode& opcode) {
+    switch (op) {
+        case TokenType::MINUS: opcode = IROpcode::NEG; return true;
+        case TokenType::NOT: opcode = IROpcode::NOT; return true;
+        default: return false;
+    }
+}
+
+} // namespace
+
 IRBuilder::IRBuilder(const std::string& moduleName)
     : module_(std::make_shared<IRModule>(moduleName)) {}
 
 std::shared_ptr<IRModule> IRBuilder::build(Program* program) {
     // 清空状态
-    symbolTable_.clear();
+    interner_ = program->getInterner();
+    if (!interner_) {
+        interner_ = std::make_shared<StringInterner>();
+    }
+    symbols_.clear();
+    functions_.clear();
+    for (const auto& stmt : program->getStatements()) {
+        if (auto* function = dynCast<FunctionDeclaration>(stmt.get())) {
+            functions_.emplace(function->getName(), function);
+        }
+    }
     while (!valueStack_.empty()) {
         valueStack_.pop();
     }
     labelCounter_ = 0;
     tempCounter_ = 0;
+    shadowCounter_ = 0;
     
     // 访问程序
-    program->accept(*this);
+    walk(program);
+    
+    // 只保留由其它模块定义的函数的声明，每个函数一条
+    if (!module_->getDeclarations().empty()) {
+        std::unordered_set<std::string> seen;
+        for (const auto& function : module_->getFunctions()) {
+            seen.insert(function->getName());
+        }
+        std::vector<std::shared_ptr<IRFunction>> external;
+        for (const auto& declaration : module_->getDeclarations()) {
+            if (seen.insert(declaration->getName()).second) {
+                external.push_back(declaration);
+            }
+        }
+        module_->setDeclarations(std::move(external));
+    }
     
     return module_;
 }
@@ -33,20 +97,16 @@ void IRBuilder::visit(FloatLiteral* node) {
 }
 
 void IRBuilder::visit(StringLiteral* node) {
-    // 字符串字面量暂不支持
-    std::cerr << "Warning: String literals are not supported in IR." << std::endl;
-    
-    // 使用整数0作为占位符
-    auto value = std::make_shared<IRIntConstant>(0);
-    valueStack_.push(value);
+    // 语义分析保证字符串只出现在print的实参中
+    valueStack_.push(std::make_shared<IRStringConstant>(node->getValue()));
 }
 
 void IRBuilder::visit(VariableExpression* node) {
     const std::string& name = node->getName();
     
     // 查找变量
-    auto it = symbolTable_.find(name);
-    if (it == symbolTable_.end()) {
+    auto var = lookupVariable(node->getSymbol(), name);
+    if (!var) {
         std::cerr << "Error: Variable '" << name << "' not found." << std::endl;
         // 使用整数0作为占位符
         auto value = std::make_shared<IRIntConstant>(0);
@@ -55,118 +115,68 @@ void IRBuilder::visit(VariableExpression* node) {
     }
     
     // 加载变量值
-    auto temp = createTemp(it->second->getType());
+    auto temp = createTemp(var->getType());
     auto loadInst = std::make_shared<IRInstruction>(
-        IROpcode::LOAD, temp, std::vector<std::shared_ptr<IRValue>>{it->second});
+        IROpcode::LOAD, temp, std::vector<std::shared_ptr<IRValue>>{var});
     addInstruction(loadInst);
     
     valueStack_.push(temp);
 }
 
 void IRBuilder::visit(BinaryExpression* node) {
-    // 访问左右操作数
-    node->getLeft()->accept(*this);
-    auto right = popValue();
-    auto left = popValue();
-    
-    // 根据操作符类型创建指令
-    IROpcode opcode;
-    switch (node->getOperator()) {
-        case TokenType::PLUS: opcode = IROpcode::ADD; break;
-        case TokenType::MINUS: opcode = IROpcode::SUB; break;
-        case TokenType::MULTIPLY: opcode = IROpcode::MUL; break;
-        case TokenType::DIVIDE: opcode = IROpcode::DIV; break;
-        case TokenType::MODULO: opcode = IROpcode::MOD; break;
-        case TokenType::EQUAL: opcode = IROpcode::CMP_EQ; break;
-        case TokenType::NOT_EQUAL: opcode = IROpcode::CMP_NE; break;
-        case TokenType::LESS: opcode = IROpcode::CMP_LT; break;
-        case TokenType::LESS_EQUAL: opcode = IROpcode::CMP_LE; break;
-        case TokenType::GREATER: opcode = IROpcode::CMP_GT; break;
-        case TokenType::GREATER_EQUAL: opcode = IROpcode::CMP_GE; break;
-        case TokenType::AND: opcode = IROpcode::AND; break;
-        case TokenType::OR: opcode = IROpcode::OR; break;
-        case TokenType::ASSIGN: {
-            // 特殊处理赋值操作
-            if (auto* varExpr = dynamic_cast<VariableExpression*>(node->getLeft())) {
-                const std::string& name = varExpr->getName();
-                auto it = symbolTable_.find(name);
-                if (it != symbolTable_.end()) {
-                    auto storeInst = std::make_shared<IRInstruction>(
-                        IROpcode::STORE, nullptr, std::vector<std::shared_ptr<IRValue>>{right, it->second});
-                    addInstruction(storeInst);
-                    valueStack_.push(right);
-                    return;
-                }
+    // 特殊处理赋值操作：左侧是存储目标，不需要求值
+    if (node->getOperator() == TokenType::ASSIGN) {
+        walk(node->getRight());
+        auto right = popValue();
+        
+        if (auto* varExpr = dynCast<VariableExpression>(node->getLeft())) {
+            if (auto var = lookupVariable(varExpr->getSymbol(), varExpr->getName())) {
+                valueStack_.push(emitStore(right, var));
+                return;
             }
-            std::cerr << "Error: Invalid assignment target." << std::endl;
-            valueStack_.push(right);
-            return;
         }
-        default:
-            std::cerr << "Error: Unsupported binary operator." << std::endl;
-            valueStack_.push(left);
-            return;
+        std::cerr << "Error: Invalid assignment target." << std::endl;
+        valueStack_.push(right);
+        return;
     }
     
-    // 创建临时变量存储结果
-    auto temp = createTemp(left->getType());
-    auto inst = std::make_shared<IRInstruction>(
-        opcode, temp, std::vector<std::shared_ptr<IRValue>>{left, right});
-    addInstruction(inst);
+    // 逻辑与/或短路求值，右侧只在需要时才求值
+    if (node->getOperator() == TokenType::AND || node->getOperator() == TokenType::OR) {
+        valueStack_.push(emitLogicalValue(node));
+        return;
+    }
     
-    valueStack_.push(temp);
+    // 访问左右操作数
+    walk(node->getLeft());
+    walk(node->getRight());
+    auto right = popValue();
+    auto left = popValue();
+    
+    valueStack_.push(emitBinary(node->getOperator(), node->getType(), std::move(left), std::move(right)));
 }
 
 void IRBuilder::visit(UnaryExpression* node) {
     // 访问操作数
-    node->getOperand()->accept(*this);
+    walk(node->getOperand());
     auto operand = popValue();
     
-    // 根据操作符类型创建指令
-    IROpcode opcode;
-    switch (node->getOperator()) {
-        case TokenType::MINUS: opcode = IROpcode::NEG; break;
-        case TokenType::NOT: opcode = IROpcode::NOT; break;
-        default:
-            std::cerr << "Error: Unsupported unary operator." << std::endl;
-            valueStack_.push(operand);
-            return;
-    }
-    
-    // 创建临时变量存储结果
-    auto temp = createTemp(operand->getType());
-    auto inst = std::make_shared<IRInstruction>(
-        opcode, temp, std::vector<std::shared_ptr<IRValue>>{operand});
-    addInstruction(inst);
-    
-    valueStack_.push(temp);
+    valueStack_.push(emitUnary(node->getOperator(), node->getType(), std::move(operand)));
 }
 
 void IRBuilder::visit(CallExpression* node) {
-    const std::string& callee = node->getCallee();
-    
-    // 处理参数
     std::vector<std::shared_ptr<IRValue>> args;
+    args.reserve(node->getArguments().size());
     for (const auto& arg : node->getArguments()) {
-        arg->accept(*this);
+        walk(arg.get());
         args.push_back(popValue());
     }
     
-    // 创建临时变量存储结果
-    auto temp = createTemp(IRType::INT32); // 假设所有函数返回整数
-    auto callInst = std::make_shared<IRInstruction>(
-        IROpcode::CALL, temp, args);
-    addInstruction(callInst);
-    
-    valueStack_.push(temp);
+    valueStack_.push(emitCall(node->getCallee(), node->getType(), std::move(args)));
 }
 
 void IRBuilder::visit(ExpressionStatement* node) {
-    node->getExpression()->accept(*this);
-    // 弹出表达式结果，因为表达式语句不需要返回值
-    if (!valueStack_.empty()) {
-        valueStack_.pop();
-    }
+    // 表达式语句不需要返回值
+    emitExpression(node->getExpression());
 }
 
 void IRBuilder::visit(VarDeclaration* node) {
@@ -174,8 +184,7 @@ void IRBuilder::visit(VarDeclaration* node) {
     IRType type = typeFromString(node->getType());
     
     // 创建变量
-    auto var = std::make_shared<IRIdentifier>(name, type);
-    symbolTable_[name] = var;
+    auto var = declareVariable(node->getSymbol(), name, type);
     
     // 分配栈空间
     auto allocaInst = std::make_shared<IRInstruction>(
@@ -184,142 +193,75 @@ void IRBuilder::visit(VarDeclaration* node) {
     
     // 初始化变量
     if (node->getInitializer()) {
-        node->getInitializer()->accept(*this);
-        auto initValue = popValue();
-        
-        auto storeInst = std::make_shared<IRInstruction>(
-            IROpcode::STORE, nullptr, std::vector<std::shared_ptr<IRValue>>{initValue, var});
-        addInstruction(storeInst);
+        emitStore(emitExpression(node->getInitializer()), var);
     }
 }
 
 void IRBuilder::visit(BlockStatement* node) {
+    symbols_.pushScope();
     for (const auto& stmt : node->getStatements()) {
-        stmt->accept(*this);
+        walk(stmt.get());
     }
+    symbols_.popScope();
 }
 
 void IRBuilder::visit(IfStatement* node) {
-    // 创建标签
-    std::string thenLabel = createLabel("then");
-    std::string elseLabel = createLabel("else");
-    std::string endLabel = createLabel("endif");
-    
-    // 生成条件表达式
-    node->getCondition()->accept(*this);
-    auto condition = popValue();
-    
-    // 条件跳转
-    auto jmpIfInst = std::make_shared<IRInstruction>(
-        IROpcode::JMP_IF, nullptr, 
-        std::vector<std::shared_ptr<IRValue>>{
-            condition, 
-            std::make_shared<IRLabel>(thenLabel)
-        });
-    addInstruction(jmpIfInst);
-    
-    // 无条件跳转到else分支
-    auto jmpElseInst = std::make_shared<IRInstruction>(
-        IROpcode::JMP, nullptr, 
-        std::vector<std::shared_ptr<IRValue>>{
-            std::make_shared<IRLabel>(elseLabel)
-        });
-    addInstruction(jmpElseInst);
+    // 创建基本块，先不加入函数，到达时再按顺序加入
+    // 没有else分支时不分配else标签，避免打印出的IR中出现空标签并打乱编号
+    auto thenBlock = createBlock(createLabel("then"));
+    std::shared_ptr<IRBasicBlock> elseBlock;
+    if (node->getElseBranch()) {
+        elseBlock = createBlock(createLabel("else"));
+    }
+    auto endBlock = createBlock(createLabel("endif"));
+    
+    // 条件为真跳到then，否则跳到else；没有else分支时直接跳到结束
+    emitCondition(node->getCondition(), thenBlock.get(),
+                  elseBlock ? elseBlock.get() : endBlock.get());
     
     // then分支
-    auto thenBlock = createBlock(thenLabel);
     setCurrentBlock(thenBlock);
-    node->getThenBranch()->accept(*this);
-    
-    // 跳转到结束
-    auto jmpEndInst = std::make_shared<IRInstruction>(
-        IROpcode::JMP, nullptr, 
-        std::vector<std::shared_ptr<IRValue>>{
-            std::make_shared<IRLabel>(endLabel)
-        });
-    addInstruction(jmpEndInst);
+    walk(node->getThenBranch());
+    emitJump(endBlock.get());
     
     // else分支
-    auto elseBlock = createBlock(elseLabel);
-    setCurrentBlock(elseBlock);
-    if (node->getElseBranch()) {
-        node->getElseBranch()->accept(*this);
+    if (elseBlock) {
+        setCurrentBlock(elseBlock);
+        walk(node->getElseBranch());
+        emitJump(endBlock.get());
     }
     
-    // 跳转到结束
-    auto jmpEndInst2 = std::make_shared<IRInstruction>(
-        IROpcode::JMP, nullptr, 
-        std::vector<std::shared_ptr<IRValue>>{
-            std::make_shared<IRLabel>(endLabel)
-        });
-    addInstruction(jmpEndInst2);
-    
-    // 结束标签
-    auto endBlock = createBlock(endLabel);
+    // 结束块
     setCurrentBlock(endBlock);
 }
 
 void IRBuilder::visit(WhileStatement* node) {
-    // 创建标签
-    std::string condLabel = createLabel("while.cond");
-    std::string bodyLabel = createLabel("while.body");
-    std::string endLabel = createLabel("while.end");
+    auto condBlock = createBlock(createLabel("while.cond"));
+    auto bodyBlock = createBlock(createLabel("while.body"));
+    auto endBlock = createBlock(createLabel("while.end"));
     
     // 跳转到条件
-    auto jmpCondInst = std::make_shared<IRInstruction>(
-        IROpcode::JMP, nullptr, 
-        std::vector<std::shared_ptr<IRValue>>{
-            std::make_shared<IRLabel>(condLabel)
-        });
-    addInstruction(jmpCondInst);
-    
-    // 条件块
-    auto condBlock = createBlock(condLabel);
+    emitJump(condBlock.get());
+    
+    // 条件为真进入循环体，否则跳到结束
     setCurrentBlock(condBlock);
+    emitCondition(node->getCondition(), bodyBlock.get(), endBlock.get());
     
-    // 生成条件表达式
-    node->getCondition()->accept(*this);
-    auto condition = popValue();
-    
-    // 条件跳转
-    auto jmpIfInst = std::make_shared<IRInstruction>(
-        IROpcode::JMP_IF, nullptr, 
-        std::vector<std::shared_ptr<IRValue>>{
-            condition, 
-            std::make_shared<IRLabel>(bodyLabel)
-        });
-    addInstruction(jmpIfInst);
-    
-    // 无条件跳转到结束
-    auto jmpEndInst = std::make_shared<IRInstruction>(
-        IROpcode::JMP, nullptr, 
-        std::vector<std::shared_ptr<IRValue>>{
-            std::make_shared<IRLabel>(endLabel)
-        });
-    addInstruction(jmpEndInst);
-    
-    // 循环体
-    auto bodyBlock = createBlock(bodyLabel);
+    // 循环体，结束后跳回条件
     setCurrentBlock(bodyBlock);
-    node->getBody()->accept(*this);
-    
-    // 跳回条件
-    auto jmpBackInst = std::make_shared<IRInstruction>(
-        IROpcode::JMP, nullptr, 
-        std::vector<std::shared_ptr<IRValue>>{
-            std::make_shared<IRLabel>(condLabel)
-        });
-    addInstruction(jmpBackInst);
-    
-    // 结束标签
-    auto endBlock = createBlock(endLabel);
+    walk(node->getBody());
+    emitJump(condBlock.get());
+    
+    // 结束块
     setCurrentBlock(endBlock);
 }
 
 void IRBuilder::visit(ReturnStatement* node) {
     if (node->getValue()) {
-        node->getValue()->accept(*this);
-        auto value = popValue();
+        auto value = emitExpression(node->getValue());
+        if (currentFunction_) {
+            value = convert(std::move(value), currentFunction_->getReturnType());
+        }
         
         auto retInst = std::make_shared<IRInstruction>(
             IROpcode::RET, nullptr, 
@@ -334,6 +276,7 @@ void IRBuilder::visit(ReturnStatement* node) {
 }
 
 void IRBuilder::visit(FunctionDeclaration* node) {
+    throwIfCancelled(cancellation_);
     const std::string& name = node->getName();
     IRType returnType = typeFromString(node->getReturnType());
     
@@ -344,21 +287,28 @@ void IRBuilder::visit(FunctionDeclaration* node) {
         params.emplace_back(param.name, paramType);
     }
     
+    // 原型只生成声明，本模块中也有定义的在build()结束时去掉
+    if (!node->getBody()) {
+        module_->addDeclaration(std::make_shared<IRFunction>(name, returnType, params));
+        return;
+    }
+    
     // 创建函数
     currentFunction_ = std::make_shared<IRFunction>(name, returnType, params);
     module_->addFunction(currentFunction_);
     
     // 创建入口基本块
-    auto entryBlock = createBlock("entry");
-    setCurrentBlock(entryBlock);
+    setCurrentBlock(createBlock("entry"));
     
-    // 清空符号表
-    symbolTable_.clear();
+    // 清空符号表，参数位于函数作用域，函数体语句块在其内层
+    symbols_.clear();
+    variableNames_.clear();
+    symbols_.pushScope();
     
     // 为参数分配栈空间
-    for (const auto& param : params) {
-        auto var = std::make_shared<IRIdentifier>(param.name, param.type);
-        symbolTable_[param.name] = var;
+    for (size_t i = 0; i < params.size(); ++i) {
+        const auto& param = params[i];
+        auto var = declareVariable(node->getParameters()[i].symbol, param.name, param.type);
         
         auto allocaInst = std::make_shared<IRInstruction>(
             IROpcode::ALLOCA, var, std::vector<std::shared_ptr<IRValue>>{});
@@ -373,7 +323,12 @@ void IRBuilder::visit(FunctionDeclaration* node) {
     }
     
     // 处理函数体
-    node->getBody()->accept(*this);
+    if (flattenExpressions_) {
+        flatExprs_.build(node);
+    }
+    walk(node->getBody());
+    flatExprs_.clear();
+    symbols_.popScope();
     
     // 如果没有显式的return语句，添加一个默认的return
     if (currentBlock_->getInstructions().empty() || 
@@ -393,20 +348,19 @@ void IRBuilder::visit(FunctionDeclaration* node) {
 
 void IRBuilder::visit(Program* node) {
     for (const auto& stmt : node->getStatements()) {
-        stmt->accept(*this);
+        walk(stmt.get());
     }
 }
 
 std::shared_ptr<IRBasicBlock> IRBuilder::createBlock(const std::string& name) {
-    auto block = std::make_shared<IRBasicBlock>(name);
-    if (currentFunction_) {
-        currentFunction_->addBlock(block);
-    }
-    return block;
+    return std::make_shared<IRBasicBlock>(name);
 }
 
 void IRBuilder::setCurrentBlock(std::shared_ptr<IRBasicBlock> block) {
-    currentBlock_ = block;
+    if (currentFunction_) {
+        currentFunction_->addBlock(block);
+    }
+    currentBlock_ = std::move(block);
 }
 
 void IRBuilder::addInstruction(std::shared_ptr<IRInstruction> instruction) {
@@ -437,6 +391,288 @@ IRType IRBuilder::typeFromString(const std::string& cType) {
     }
 }
 
+Symbol IRBuilder::symbolFor(Symbol symbol, const std::string& name) {
+    return symbol != kNoSymbol ? symbol : interner_->intern(name);
+}
+
+std::shared_ptr<IRIdentifier> IRBuilder::declareVariable(Symbol symbol, const std::string& name, IRType type) {
+    symbol = symbolFor(symbol, name);
+
+    // 函数中已有同名的alloca时换一个唯一的IR名字，不论先前的变量是否仍然可见
+    std::string irName = name;
+    while (!variableNames_.insert(irName).second) {
+        irName = name + "." + std::to_string(shadowCounter_++);
+    }
+
+    auto var = std::make_shared<IRIdentifier>(irName, type);
+    symbols_.declare(symbol, var);
+    return var;
+}
+
+std::shared_ptr<IRIdentifier> IRBuilder::lookupVariable(Symbol symbol, const std::string& name) {
+    const std::shared_ptr<IRIdentifier>* var = symbols_.lookup(symbolFor(symbol, name));
+    return var ? *var : nullptr;
+}
+
+IRType IRBuilder::irType(ValueType type, IRType fallback) {
+    switch (type) {
+        case ValueType::INT: return IRType::INT32;
+        case ValueType::FLOAT: return IRType::FLOAT32;
+        case ValueType::VOID: return IRType::VOID;
+        default: return fallback;
+    }
+}
+
+std::shared_ptr<IRValue> IRBuilder::convert(std::shared_ptr<IRValue> value, IRType type) {
+    IRType from = value->getType();
+    if (from == type) {
+        return value;
+    }
+
+    if (from == IRType::INT32 && type == IRType::FLOAT32) {
+        if (auto* constant = dynamic_cast<IRIntConstant*>(value.get())) {
+            return std::make_shared<IRFloatConstant>(static_cast<float>(constant->getValue()));
+        }
+        auto temp = createTemp(IRType::FLOAT32);
+        addInstruction(std::make_shared<IRInstruction>(
+            IROpcode::INT_TO_FLOAT, temp, std::vector<std::shared_ptr<IRValue>>{std::move(value)}));
+        return temp;
+    }
+
+    if (from == IRType::FLOAT32 && type == IRType::INT32) {
+        if (auto* constant = dynamic_cast<IRFloatConstant*>(value.get())) {
+            return std::make_shared<IRIntConstant>(static_cast<int>(constant->getValue()));
+        }
+        auto temp = createTemp(IRType::INT32);
+        addInstruction(std::make_shared<IRInstruction>(
+            IROpcode::FLOAT_TO_INT, temp, std::vector<std::shared_ptr<IRValue>>{std::move(value)}));
+        return temp;
+    }
+
+    return value;
+}
+
+std::shared_ptr<IRValue> IRBuilder::emitBinary(TokenType op, ValueType type,
+                                               std::shared_ptr<IRValue> left, std::shared_ptr<IRValue> right) {
+    IROpcode opcode;
+    if (!binaryOpcode(op, opcode)) {
+        std::cerr << "Error: Unsupported binary operator." << std::endl;
+        return left;
+    }
+
+    // 有一侧是float时在float上运算；比较的结果总是int
+    IRType operandType = left->getType() == IRType::FLOAT32 || right->getType() == IRType::FLOAT32
+        ? IRType::FLOAT32 : IRType::INT32;
+    IRType resultType = IRType::INT32;
+    if (opcode < IROpcode::CMP_EQ || opcode > IROpcode::CMP_GE) {
+        resultType = irType(type, operandType);
+        operandType = resultType;
+    }
+
+    left = convert(std::move(left), operandType);
+    right = convert(std::move(right), operandType);
+
+    auto temp = createTemp(resultType);
+    addInstruction(std::make_shared<IRInstruction>(
+        opcode, temp, std::vector<std::shared_ptr<IRValue>>{std::move(left), std::move(right)}));
+    return temp;
+}
+
+std::shared_ptr<IRValue> IRBuilder::emitUnary(TokenType op, ValueType type, std::shared_ptr<IRValue> operand) {
+    IROpcode opcode;
+    if (!unaryOpcode(op, opcode)) {
+        std::cerr << "Error: Unsupported unary operator." << std::endl;
+        return operand;
+    }
+
+    auto temp = createTemp(opcode == IROpcode::NOT ? IRType::INT32 : irType(type, operand->getType()));
+    addInstruction(std::make_shared<IRInstruction>(
+        opcode, temp, std::vector<std::shared_ptr<IRValue>>{std::move(operand)}));
+    return temp;
+}
+
+std::shared_ptr<IRValue> IRBuilder::emitCall(const std::string& callee, ValueType type,
+                                             std::vector<std::shared_ptr<IRValue>> args) {
+    // 已知的函数按形参类型转换实参，返回类型取自声明；print等内建函数原样传参
+    IRType returnType = IRType::INT32;
+    auto it = functions_.find(callee);
+    if (it != functions_.end()) {
+        const auto& params = it->second->getParameters();
+        for (size_t i = 0; i < args.size() && i < params.size(); ++i) {
+            args[i] = convert(std::move(args[i]), typeFromString(params[i].type));
+        }
+        returnType = typeFromString(it->second->getReturnType());
+    }
+    returnType = irType(type, returnType);
+
+    // 第一个操作数是被调用函数，其余是参数；void函数的结果仍占一个int临时变量
+    std::vector<std::shared_ptr<IRValue>> operands;
+    operands.reserve(args.size() + 1);
+    operands.push_back(std::make_shared<IRFunctionRef>(callee));
+    for (auto& arg : args) {
+        operands.push_back(std::move(arg));
+    }
+
+    auto temp = createTemp(returnType == IRType::VOID ? IRType::INT32 : returnType);
+    addInstruction(std::make_shared<IRInstruction>(IROpcode::CALL, temp, std::move(operands)));
+    return temp;
+}
+
+std::shared_ptr<IRValue> IRBuilder::emitStore(std::shared_ptr<IRValue> value,
+                                              const std::shared_ptr<IRIdentifier>& var) {
+    value = convert(std::move(value), var->getType());
+    addInstruction(std::make_shared<IRInstruction>(
+        IROpcode::STORE, nullptr, std::vector<std::shared_ptr<IRValue>>{value, var}));
+    return value;
+}
+
+std::shared_ptr<IRValue> IRBuilder::emitExpression(Expression* expr) {
+    if (const FlatExpressionTable::Range* range = flatExprs_.next(expr)) {
+        return emitFlat(*range);
+    }
+    walk(expr);
+    return popValue();
+}
+
+void IRBuilder::emitJump(IRBasicBlock* target) {
+    addInstruction(std::make_shared<IRInstruction>(
+        IROpcode::JMP, nullptr, std::vector<std::shared_ptr<IRValue>>{target->getLabel()}));
+}
+
+void IRBuilder::emitCondition(Expression* expr, IRBasicBlock* trueBlock, IRBasicBlock* falseBlock) {
+    if (auto* binary = dynCast<BinaryExpression>(expr)) {
+        // a && b：a为假直接跳到falseBlock，否则再判断b
+        if (binary->getOperator() == TokenType::AND) {
+            auto rhsBlock = createBlock(createLabel("and.rhs"));
+            emitCondition(binary->getLeft(), rhsBlock.get(), falseBlock);
+            setCurrentBlock(rhsBlock);
+            emitCondition(binary->getRight(), trueBlock, falseBlock);
+            return;
+        }
+        // a || b：a为真直接跳到trueBlock，否则再判断b
+        if (binary->getOperator() == TokenType::OR) {
+            auto rhsBlock = createBlock(createLabel("or.rhs"));
+            emitCondition(binary->getLeft(), trueBlock, rhsBlock.get());
+            setCurrentBlock(rhsBlock);
+            emitCondition(binary->getRight(), trueBlock, falseBlock);
+            return;
+        }
+    }
+    
+    // !a：交换两个目标，不生成not指令
+    if (auto* unary = dynCast<UnaryExpression>(expr)) {
+        if (unary->getOperator() == TokenType::NOT) {
+            emitCondition(unary->getOperand(), falseBlock, trueBlock);
+            return;
+        }
+    }
+    
+    // 比较结果直接作为br的条件，一次比较一次分支
+    auto condition = emitExpression(expr);
+    addInstruction(std::make_shared<IRInstruction>(
+        IROpcode::BR, nullptr,
+        std::vector<std::shared_ptr<IRValue>>{condition, trueBlock->getLabel(), falseBlock->getLabel()}));
+}
+
+std::shared_ptr<IRValue> IRBuilder::emitLogicalValue(BinaryExpression* node) {
+    // 两条路径分别把1/0写入栈槽，在汇合块中读出
+    auto slot = createTemp(IRType::INT32, "sc");
+    addInstruction(std::make_shared<IRInstruction>(
+        IROpcode::ALLOCA, slot, std::vector<std::shared_ptr<IRValue>>{}));
+    
+    auto trueBlock = createBlock(createLabel("sc.true"));
+    auto falseBlock = createBlock(createLabel("sc.false"));
+    auto endBlock = createBlock(createLabel("sc.end"));
+    emitCondition(node, trueBlock.get(), falseBlock.get());
+    
+    for (int value : {1, 0}) {
+        setCurrentBlock(value ? trueBlock : falseBlock);
+        addInstruction(std::make_shared<IRInstruction>(
+            IROpcode::STORE, nullptr,
+            std::vector<std::shared_ptr<IRValue>>{std::make_shared<IRIntConstant>(value), slot}));
+        emitJump(endBlock.get());
+    }
+    
+    setCurrentBlock(endBlock);
+    auto result = createTemp(IRType::INT32);
+    addInstruction(std::make_shared<IRInstruction>(
+        IROpcode::LOAD, result, std::vector<std::shared_ptr<IRValue>>{slot}));
+    return result;
+}
+
+std::shared_ptr<IRValue> IRBuilder::emitFlat(const FlatExpressionTable::Range& range) {
+    // flatValues_[i - range.begin]是节点i的结果；后序保证子节点已先求值
+    flatValues_.resize(range.end - range.begin);
+    auto valueOf = [&](uint32_t index) -> std::shared_ptr<IRValue>& {
+        return flatValues_[index - range.begin];
+    };
+
+    for (uint32_t i = range.begin; i < range.end; ++i) {
+        const FlatExpr& node = flatExprs_.node(i);
+        std::shared_ptr<IRValue>& result = valueOf(i);
+
+        switch (node.kind) {
+            case ASTNodeKind::IntegerLiteral:
+                result = std::make_shared<IRIntConstant>(node.intValue);
+                break;
+            case ASTNodeKind::FloatLiteral:
+                result = std::make_shared<IRFloatConstant>(node.floatValue);
+                break;
+            case ASTNodeKind::StringLiteral:
+                result = std::make_shared<IRStringConstant>(flatExprs_.name(node.name));
+                break;
+            case ASTNodeKind::VariableExpression: {
+                const std::string& name = flatExprs_.name(node.name);
+                auto var = lookupVariable(flatExprs_.symbol(node.name), name);
+                if (!var) {
+                    std::cerr << "Error: Variable '" << name << "' not found." << std::endl;
+                    result = std::make_shared<IRIntConstant>(0);
+                    break;
+                }
+                auto temp = createTemp(var->getType());
+                addInstruction(std::make_shared<IRInstruction>(
+                    IROpcode::LOAD, temp, std::vector<std::shared_ptr<IRValue>>{var}));
+                result = temp;
+                break;
+            }
+            case ASTNodeKind::BinaryExpression: {
+                if (node.op == TokenType::ASSIGN) {
+                    std::shared_ptr<IRValue> right = valueOf(node.rhs);
+                    auto var = lookupVariable(flatExprs_.symbol(node.name), flatExprs_.name(node.name));
+                    if (var) {
+                        result = emitStore(std::move(right), var);
+                    } else {
+                        std::cerr << "Error: Invalid assignment target." << std::endl;
+                        result = std::move(right);
+                    }
+                    break;
+                }
+                result = emitBinary(node.op, node.type, valueOf(node.lhs), valueOf(node.rhs));
+                break;
+            }
+            case ASTNodeKind::UnaryExpression:
+                result = emitUnary(node.op, node.type, valueOf(node.lhs));
+                break;
+            case ASTNodeKind::CallExpression: {
+                std::vector<std::shared_ptr<IRValue>> args;
+                args.reserve(node.rhs);
+                for (uint32_t a = 0; a < node.rhs; ++a) {
+                    args.push_back(valueOf(flatExprs_.argument(node.lhs + a)));
+                }
+                result = emitCall(flatExprs_.name(node.name), node.type, std::move(args));
+                break;
+            }
+            default:
+                result = std::make_shared<IRIntConstant>(0);
+                break;
+        }
+    }
+
+    std::shared_ptr<IRValue> value = std::move(flatValues_.back());
+    flatValues_.clear();
+    return value;
+}
+
 std::shared_ptr<IRValue> IRBuilder::popValue() {
     if (valueStack_.empty()) {
         std::cerr << "Error: Value stack is empty." << std::endl;
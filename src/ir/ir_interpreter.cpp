@@ -0,0 +1,455 @@
+#include "ir/ir_interpreter.h"
+#include <algorithm>
+#include "runtime/format.h"
+
+namespace minicompiler {
+
+namespace {
+
+// 调用深度上限，防止失控递归耗尽本机栈
+constexpr int kMaxCallDepth = 10000;
+
+// 内建函数和未定义函数的被调用者编号
+constexpr int kBuiltinPrint = -1;
+constexpr int kUndefinedFunction = -2;
+
+} // namespace
+
+/**
+ * @brief 运行时值，类型随值携带
+ */
+struct IRInterpreter::Value {
+    bool isFloat = false;
+    int32_t intValue = 0;
+    float floatValue = 0.0f;
+    const std::string* stringValue = nullptr;   // 字符串常量，指向模块中的IRStringConstant
+
+    static Value fromInt(int32_t value) {
+        Value result;
+        result.intValue = value;
+        return result;
+    }
+
+    static Value fromFloat(float value) {
+        Value result;
+        result.isFloat = true;
+        result.floatValue = value;
+        return result;
+    }
+
+    static Value fromString(const std::string& value) {
+        Value result;
+        result.stringValue = &value;
+        return result;
+    }
+
+    float asFloat() const { return isFloat ? floatValue : static_cast<float>(intValue); }
+    bool isTrue() const { return isFloat ? floatValue != 0.0f : intValue != 0; }
+};
+
+/**
+ * @brief 翻译后的函数
+ */
+struct IRInterpreter::Function {
+    // 操作数：slot >= 0 时读取栈帧槽位，否则是常量
+    struct Operand {
+        int slot = -1;
+        Value constant;
+    };
+
+    struct Instruction {
+        IROpcode opcode;
+        int result = -1;
+        int target = -1;
+        int elseTarget = -1;  // BR条件为假时的目标
+        int callee = kUndefinedFunction;
+        std::vector<Operand> operands;
+    };
+
+    std::string name;
+    std::vector<Instruction> code;
+    size_t slotCount = 0;
+    size_t parameterCount = 0;
+
+    // 未定义的被调用者名称，报错时使用
+    std::vector<std::string> undefinedCallees;
+};
+
+IRInterpreter::IRInterpreter(std::shared_ptr<IRModule> module, std::ostream& output)
+    : module_(std::move(module)), output_(output) {
+    const auto& functions = module_->getFunctions();
+    for (size_t i = 0; i < functions.size(); ++i) {
+        functionIndex_.emplace(functions[i]->getName(), i);
+    }
+    decoded_.resize(functions.size());
+}
+
+IRInterpreter::~IRInterpreter() = default;
+
+int IRInterpreter::run(const std::string& entry) {
+    auto it = functionIndex_.find(entry);
+    if (it == functionIndex_.end()) {
+        throw IRInterpreterError("Undefined entry function '" + entry + "'");
+    }
+
+    Value result = execute(it->second, {}, 0);
+    return result.isFloat ? static_cast<int>(result.floatValue) : result.intValue;
+}
+
+const IRInterpreter::Function& IRInterpreter::decode(size_t index) {
+    if (decoded_[index]) {
+        return *decoded_[index];
+    }
+
+    const IRFunction& source = *module_->getFunctions()[index];
+    auto function = std::make_unique<Function>();
+    function->name = source.getName();
+
+    // 变量的内存（alloca/load/store）和指令结果使用不同的槽位，避免同名冲突
+    std::unordered_map<std::string, int> registers;
+    std::unordered_map<std::string, int> memory;
+    auto slotFor = [&](std::unordered_map<std::string, int>& slots, const std::string& name) {
+        auto inserted = slots.emplace(name, static_cast<int>(function->slotCount));
+        if (inserted.second) {
+            function->slotCount++;
+        }
+        return inserted.first->second;
+    };
+
+    // 参数占用最前面的槽位
+    for (const auto& param : source.getParameters()) {
+        slotFor(registers, "param." + param.name);
+    }
+    function->parameterCount = source.getParameters().size();
+
+    // 基本块 -> 第一条指令的下标
+    std::unordered_map<const IRBasicBlock*, int> blockStart;
+    size_t offset = 0;
+    for (const auto& block : source.getBlocks()) {
+        blockStart.emplace(block.get(), static_cast<int>(offset));
+        offset += block->getInstructions().size();
+    }
+    function->code.reserve(offset);
+
+    auto operand = [&](const std::shared_ptr<IRValue>& value) {
+        Function::Operand result;
+        if (auto* ident = dynamic_cast<IRIdentifier*>(value.get())) {
+            result.slot = slotFor(registers, ident->getName());
+        } else if (auto* intConst = dynamic_cast<IRIntConstant*>(value.get())) {
+            result.constant = Value::fromInt(intConst->getValue());
+        } else if (auto* floatConst = dynamic_cast<IRFloatConstant*>(value.get())) {
+            result.constant = Value::fromFloat(floatConst->getValue());
+        } else if (auto* stringConst = dynamic_cast<IRStringConstant*>(value.get())) {
+            result.constant = Value::fromString(stringConst->getValue());
+        }
+        return result;
+    };
+
+    auto memorySlot = [&](const std::shared_ptr<IRValue>& value) {
+        auto* ident = dynamic_cast<IRIdentifier*>(value.get());
+        if (!ident) {
+            throw IRInterpreterError("Expected a variable in function '" + function->name + "'");
+        }
+        return slotFor(memory, ident->getName());
+    };
+
+    auto labelTarget = [&](const std::shared_ptr<IRValue>& value) {
+        auto* label = dynamic_cast<IRLabel*>(value.get());
+        auto it = label ? blockStart.find(label->getBlock()) : blockStart.end();
+        if (it == blockStart.end()) {
+            throw IRInterpreterError("Undefined label in function '" + function->name + "'");
+        }
+        return it->second;
+    };
+
+    for (const auto& block : source.getBlocks()) {
+        for (const auto& inst : block->getInstructions()) {
+            Function::Instruction decoded;
+            decoded.opcode = inst->getOpcode();
+            const auto& operands = inst->getOperands();
+
+            switch (inst->getOpcode()) {
+                case IROpcode::ALLOCA:
+                    decoded.result = memorySlot(inst->getResult());
+                    break;
+
+                case IROpcode::LOAD:
+                    decoded.result = slotFor(registers, inst->getResult()->getName());
+                    decoded.target = memorySlot(operands.at(0));
+                    break;
+
+                case IROpcode::STORE:
+                    decoded.operands.push_back(operand(operands.at(0)));
+                    decoded.target = memorySlot(operands.at(1));
+                    break;
+
+                case IROpcode::JMP:
+                case IROpcode::JMP_IF:
+                    if (inst->getOpcode() == IROpcode::JMP_IF) {
+                        decoded.operands.push_back(operand(operands.at(0)));
+                    }
+                    decoded.target = labelTarget(operands.back());
+                    break;
+
+                case IROpcode::BR:
+                    decoded.operands.push_back(operand(operands.at(0)));
+                    decoded.target = labelTarget(operands.at(1));
+                    decoded.elseTarget = labelTarget(operands.at(2));
+                    break;
+
+                case IROpcode::CALL: {
+                    std::string callee = inst->getCallee();
+                    auto it = functionIndex_.find(callee);
+                    if (it != functionIndex_.end()) {
+                        decoded.callee = static_cast<int>(it->second);
+                    } else if (callee == "print") {
+                        decoded.callee = kBuiltinPrint;
+                    } else {
+                        // 只有真正执行到时才报错
+                        decoded.target = static_cast<int>(function->undefinedCallees.size());
+                        function->undefinedCallees.push_back(callee);
+                    }
+                    for (size_t i = 1; i < operands.size(); ++i) {
+                        decoded.operands.push_back(operand(operands[i]));
+                    }
+                    if (inst->getResult()) {
+                        decoded.result = slotFor(registers, inst->getResult()->getName());
+                    }
+                    break;
+                }
+
+                case IROpcode::PHI:
+                    throw IRInterpreterError("PHI instructions are not supported by the interpreter");
+
+                default:
+                    for (const auto& value : operands) {
+                        decoded.operands.push_back(operand(value));
+                    }
+                    if (inst->getResult()) {
+                        decoded.result = slotFor(registers, inst->getResult()->getName());
+                    }
+                    break;
+            }
+
+            function->code.push_back(std::move(decoded));
+        }
+    }
+
+    decoded_[index] = std::move(function);
+    return *decoded_[index];
+}
+
+IRInterpreter::Value IRInterpreter::execute(size_t index, const std::vector<Value>& arguments, int depth) {
+    if (depth >= kMaxCallDepth) {
+        throw IRInterpreterError("Call stack overflow");
+    }
+
+    const Function& function = decode(index);
+    if (arguments.size() != function.parameterCount) {
+        throw IRInterpreterError("Wrong number of arguments to function '" + function.name + "'");
+    }
+
+    std::vector<Value> frame(function.slotCount);
+    std::copy(arguments.begin(), arguments.end(), frame.begin());
+
+    auto read = [&frame](const Function::Operand& operand) -> const Value& {
+        return operand.slot >= 0 ? frame[operand.slot] : operand.constant;
+    };
+
+    std::vector<Value> callArguments;
+    size_t pc = 0;
+    while (pc < function.code.size()) {
+        const Function::Instruction& inst = function.code[pc++];
+
+        if (instructionLimit_ != 0 && instructionCount_ >= instructionLimit_) {
+            throw IRInterpreterError("Instruction limit exceeded");
+        }
+        instructionCount_++;
+
+        switch (inst.opcode) {
+            case IROpcode::ALLOCA:
+                frame[inst.result] = Value();
+                break;
+
+            case IROpcode::LOAD:
+                frame[inst.result] = frame[inst.target];
+                break;
+
+            case IROpcode::STORE:
+                frame[inst.target] = read(inst.operands[0]);
+                break;
+
+            case IROpcode::ADD:
+            case IROpcode::SUB:
+            case IROpcode::MUL:
+            case IROpcode::DIV:
+            case IROpcode::MOD: {
+                const Value& left = read(inst.operands[0]);
+                const Value& right = read(inst.operands[1]);
+
+                if (left.isFloat || right.isFloat) {
+                    float a = left.asFloat();
+                    float b = right.asFloat();
+                    float value = 0.0f;
+                    switch (inst.opcode) {
+                        case IROpcode::ADD: value = a + b; break;
+                        case IROpcode::SUB: value = a - b; break;
+                        case IROpcode::MUL: value = a * b; break;
+                        case IROpcode::DIV: value = a / b; break;
+                        default:
+                            throw IRInterpreterError("Modulo of floating point values");
+                    }
+                    frame[inst.result] = Value::fromFloat(value);
+                    break;
+                }
+
+                // 按32位补码回绕，避免有符号溢出
+                uint32_t a = static_cast<uint32_t>(left.intValue);
+                uint32_t b = static_cast<uint32_t>(right.intValue);
+                int32_t value = 0;
+                switch (inst.opcode) {
+                    case IROpcode::ADD: value = static_cast<int32_t>(a + b); break;
+                    case IROpcode::SUB: value = static_cast<int32_t>(a - b); break;
+                    case IROpcode::MUL: value = static_cast<int32_t>(a * b); break;
+                    default:
+                        if (right.intValue == 0) {
+                            throw IRInterpreterError("Division by zero in function '" + function.name + "'");
+                        }
+                        if (left.intValue == INT32_MIN && right.intValue == -1) {
+                            value = inst.opcode == IROpcode::DIV ? INT32_MIN : 0;
+                        } else if (inst.opcode == IROpcode::DIV) {
+                            value = left.intValue / right.intValue;
+                        } else {
+                            value = left.intValue % right.intValue;
+                        }
+                        break;
+                }
+                frame[inst.result] = Value::fromInt(value);
+                break;
+            }
+
+            case IROpcode::NEG: {
+                const Value& operand = read(inst.operands[0]);
+                frame[inst.result] = operand.isFloat
+                    ? Value::fromFloat(-operand.floatValue)
+                    : Value::fromInt(static_cast<int32_t>(0u - static_cast<uint32_t>(operand.intValue)));
+                break;
+            }
+
+            case IROpcode::CMP_EQ:
+            case IROpcode::CMP_NE:
+            case IROpcode::CMP_LT:
+            case IROpcode::CMP_LE:
+            case IROpcode::CMP_GT:
+            case IROpcode::CMP_GE: {
+                const Value& left = read(inst.operands[0]);
+                const Value& right = read(inst.operands[1]);
+                bool isFloat = left.isFloat || right.isFloat;
+                float fa = left.asFloat(), fb = right.asFloat();
+                int32_t ia = left.intValue, ib = right.intValue;
+
+                bool value = false;
+                switch (inst.opcode) {
+                    case IROpcode::CMP_EQ: value = isFloat ? fa == fb : ia == ib; break;
+                    case IROpcode::CMP_NE: value = isFloat ? fa != fb : ia != ib; break;
+                    case IROpcode::CMP_LT: value = isFloat ? fa < fb : ia < ib; break;
+                    case IROpcode::CMP_LE: value = isFloat ? fa <= fb : ia <= ib; break;
+                    case IROpcode::CMP_GT: value = isFloat ? fa > fb : ia > ib; break;
+                    default: value = isFloat ? fa >= fb : ia >= ib; break;
+                }
+                frame[inst.result] = Value::fromInt(value ? 1 : 0);
+                break;
+            }
+
+            case IROpcode::AND:
+                frame[inst.result] = Value::fromInt(
+                    read(inst.operands[0]).isTrue() && read(inst.operands[1]).isTrue() ? 1 : 0);
+                break;
+
+            case IROpcode::OR:
+                frame[inst.result] = Value::fromInt(
+                    read(inst.operands[0]).isTrue() || read(inst.operands[1]).isTrue() ? 1 : 0);
+                break;
+
+            case IROpcode::NOT:
+                frame[inst.result] = Value::fromInt(read(inst.operands[0]).isTrue() ? 0 : 1);
+                break;
+
+            case IROpcode::JMP:
+                pc = static_cast<size_t>(inst.target);
+                break;
+
+            case IROpcode::JMP_IF:
+                if (read(inst.operands[0]).isTrue()) {
+                    pc = static_cast<size_t>(inst.target);
+                }
+                break;
+
+            case IROpcode::BR:
+                pc = static_cast<size_t>(read(inst.operands[0]).isTrue() ? inst.target : inst.elseTarget);
+                break;
+
+            case IROpcode::CALL: {
+                callCount_++;
+                callArguments.clear();
+                for (const auto& operand : inst.operands) {
+                    callArguments.push_back(read(operand));
+                }
+
+                Value result;
+                if (inst.callee >= 0) {
+                    result = execute(static_cast<size_t>(inst.callee), callArguments, depth + 1);
+                } else if (inst.callee == kBuiltinPrint) {
+                    // 与运行时库的mc_print_*格式相同
+                    for (const auto& argument : callArguments) {
+                        char text[kMaxFloatChars + 1];
+                        char* end;
+                        if (argument.stringValue) {
+                            output_.write(argument.stringValue->data(),
+                                          static_cast<std::streamsize>(argument.stringValue->size()));
+                            end = text;
+                        } else if (argument.isFloat) {
+                            end = formatFloat(argument.floatValue, text);
+                        } else {
+                            end = formatInt(argument.intValue, text);
+                        }
+                        *end++ = '\n';
+                        output_.write(text, end - text);
+                    }
+                } else {
+                    throw IRInterpreterError("Call to undefined function '" +
+                                             function.undefinedCallees[inst.target] + "'");
+                }
+
+                if (inst.result >= 0) {
+                    frame[inst.result] = result;
+                }
+                break;
+            }
+
+            case IROpcode::RET:
+                return inst.operands.empty() ? Value() : read(inst.operands[0]);
+
+            case IROpcode::INT_TO_FLOAT:
+                frame[inst.result] = Value::fromFloat(read(inst.operands[0]).asFloat());
+                break;
+
+            case IROpcode::FLOAT_TO_INT: {
+                const Value& operand = read(inst.operands[0]);
+                frame[inst.result] = operand.isFloat
+                    ? Value::fromInt(static_cast<int32_t>(operand.floatValue))
+                    : operand;
+                break;
+            }
+
+            default:
+                // 标签和注释不产生任何效果
+                break;
+        }
+    }
+
+    // 没有ret时落到函数末尾
+    return Value();
+}
+
+} // namespace minicompiler
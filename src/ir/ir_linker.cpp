@@ -0,0 +1,73 @@
+#include "ir/ir_linker.h"
+#include <stdexcept>
+
+namespace minicompiler {
+
+namespace {
+
+bool sameSignature(const IRFunction& a, const IRFunction& b) {
+    if (a.getReturnType() != b.getReturnType() || a.getParameters().size() != b.getParameters().size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.getParameters().size(); ++i) {
+        if (a.getParameters()[i].type != b.getParameters()[i].type) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+IRLinker::IRLinker(const std::string& moduleName)
+    : module_(std::make_shared<IRModule>(moduleName)) {}
+
+void IRLinker::link(std::shared_ptr<IRModule> module) {
+    for (const auto& function : module->getFunctions()) {
+        auto inserted = definedIn_.emplace(function->getName(), module->getName());
+        if (!inserted.second) {
+            throw std::runtime_error("Duplicate definition of function '" + function->getName() +
+                                     "' in '" + module->getName() + "' (first defined in '" +
+                                     inserted.first->second + "')");
+        }
+        module_->addFunction(function);
+    }
+    for (const auto& declaration : module->getDeclarations()) {
+        declarations_.emplace_back(declaration, module->getName());
+    }
+}
+
+void IRLinker::resolve() {
+    std::unordered_map<std::string, const IRFunction*> definitions;
+    for (const auto& function : module_->getFunctions()) {
+        definitions.emplace(function->getName(), function.get());
+    }
+
+    // 声明必须与定义的签名一致，否则调用点的实参和结果类型是错的
+    for (const auto& entry : declarations_) {
+        const IRFunction& declaration = *entry.first;
+        auto it = definitions.find(declaration.getName());
+        if (it != definitions.end() && !sameSignature(declaration, *it->second)) {
+            throw std::runtime_error("Conflicting declaration of function '" + declaration.getName() +
+                                     "' in '" + entry.second + "' (defined in '" +
+                                     definedIn_[declaration.getName()] + "')");
+        }
+    }
+
+    // 每个被调用的函数都必须有定义，print是运行时库提供的内建函数
+    for (const auto& function : module_->getFunctions()) {
+        for (const auto& block : function->getBlocks()) {
+            for (const auto& inst : block->getInstructions()) {
+                std::string callee = inst->getCallee();
+                if (!callee.empty() && callee != "print" && !definitions.count(callee)) {
+                    throw std::runtime_error("Undefined reference to function '" + callee + "' in '" +
+                                             definedIn_[function->getName()] + "'");
+                }
+            }
+        }
+    }
+
+    declarations_.clear();
+}
+
+} // namespace minicompiler
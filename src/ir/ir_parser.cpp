@@ -0,0 +1,560 @@
+#include "ir/ir_parser.h"
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+
+namespace minicompiler {
+
+namespace {
+
+// 操作码文本 -> 操作码，顺序与irOpcodeToString保持一致
+const std::unordered_map<std::string_view, IROpcode>& opcodeTable() {
+    static const std::unordered_map<std::string_view, IROpcode> table = {
+        {"alloca", IROpcode::ALLOCA},
+        {"load", IROpcode::LOAD},
+        {"store", IROpcode::STORE},
+        {"add", IROpcode::ADD},
+        {"sub", IROpcode::SUB},
+        {"mul", IROpcode::MUL},
+        {"div", IROpcode::DIV},
+        {"mod", IROpcode::MOD},
+        {"neg", IROpcode::NEG},
+        {"cmp_eq", IROpcode::CMP_EQ},
+        {"cmp_ne", IROpcode::CMP_NE},
+        {"cmp_lt", IROpcode::CMP_LT},
+        {"cmp_le", IROpcode::CMP_LE},
+        {"cmp_gt", IROpcode::CMP_GT},
+        {"cmp_ge", IROpcode::CMP_GE},
+        {"and", IROpcode::AND},
+        {"or", IROpcode::OR},
+        {"not", IROpcode::NOT},
+        {"jmp", IROpcode::JMP},
+        {"jmp_if", IROpcode::JMP_IF},
+        {"br", IROpcode::BR},
+        {"call", IROpcode::CALL},
+        {"ret", IROpcode::RET},
+        {"int_to_float", IROpcode::INT_TO_FLOAT},
+        {"float_to_int", IROpcode::FLOAT_TO_INT},
+        {"phi", IROpcode::PHI},
+        {"label", IROpcode::LABEL},
+        {"comment", IROpcode::COMMENT}
+    };
+    return table;
+}
+
+bool isNameChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.';
+}
+
+} // namespace
+
+IRParser::IRParser(std::string source, std::string moduleName)
+    : source_(std::move(source)), moduleName_(std::move(moduleName)) {}
+
+std::shared_ptr<IRModule> IRParser::parse() {
+    std::vector<std::shared_ptr<IRFunction>> functions;
+    std::vector<std::shared_ptr<IRFunction>> declarations;
+
+    collectReturnTypes();
+
+    while (true) {
+        skipSpaces();
+        if (isAtEnd()) {
+            break;
+        }
+
+        if (match('\n')) {
+            nextLine();
+            continue;
+        }
+
+        // 注释行，其中可能包含模块名
+        if (match(';')) {
+            skipSpaces();
+            if (matchWord("ModuleID")) {
+                skipSpaces();
+                expect('=', "Expect '=' after ModuleID.");
+                skipSpaces();
+                expect('\'', "Expect quoted module name.");
+                size_t start = current_;
+                while (!atLineEnd() && peek() != '\'') {
+                    current_++;
+                }
+                moduleName_ = source_.substr(start, current_ - start);
+            }
+            skipLine();
+            continue;
+        }
+
+        if (matchWord("define")) {
+            functions.push_back(parseFunction());
+            continue;
+        }
+
+        if (matchWord("declare")) {
+            declarations.push_back(parseDeclaration());
+            continue;
+        }
+
+        throw error("Expect 'define', 'declare' or comment at top level.");
+    }
+
+    auto module = std::make_shared<IRModule>(moduleName_);
+    for (auto& function : functions) {
+        module->addFunction(std::move(function));
+    }
+    module->setDeclarations(std::move(declarations));
+    return module;
+}
+
+void IRParser::collectReturnTypes() {
+    // 调用可以出现在被调用函数的定义之前，先扫描每行开头的签名；
+    // 签名中的错误留给正式解析按正确的行号报告
+    returnTypes_.clear();
+    size_t line = 0;
+    while (line < source_.size()) {
+        current_ = line;
+        skipSpaces();
+        if (matchWord("define") || matchWord("declare")) {
+            try {
+                auto signature = parseSignature();
+                returnTypes_.emplace(signature->getName(), signature->getReturnType());
+            } catch (const IRParseError&) {
+            }
+        }
+        line = source_.find('\n', line);
+        if (line == std::string::npos) {
+            break;
+        }
+        line++;
+    }
+    current_ = 0;
+}
+
+std::shared_ptr<IRFunction> IRParser::parseSignature() {
+    skipSpaces();
+    IRType returnType = parseType();
+    skipSpaces();
+    expect('@', "Expect '@' before function name.");
+    std::string name(scanName());
+    skipSpaces();
+    expect('(', "Expect '(' after function name.");
+
+    std::vector<IRFunctionParameter> params;
+    skipSpaces();
+    if (!match(')')) {
+        do {
+            skipSpaces();
+            IRType paramType = parseType();
+            skipSpaces();
+            expect('%', "Expect '%' before parameter name.");
+            params.emplace_back(std::string(scanName()), paramType);
+            skipSpaces();
+        } while (match(','));
+        expect(')', "Expect ')' after parameters.");
+    }
+
+    return std::make_shared<IRFunction>(name, returnType, std::move(params));
+}
+
+std::shared_ptr<IRFunction> IRParser::parseDeclaration() {
+    auto declaration = parseSignature();
+    skipSpaces();
+    if (!atLineEnd()) {
+        throw error("Unexpected trailing characters after declaration.");
+    }
+    skipLine();
+    return declaration;
+}
+
+std::shared_ptr<IRFunction> IRParser::parseFunction() {
+    identifiers_.clear();
+    blocks_.clear();
+    inferred_.clear();
+    forwardReferences_ = false;
+
+    auto function = parseSignature();
+
+    skipSpaces();
+    expect('{', "Expect '{' before function body.");
+    skipLine();
+
+    parameters_ = &function->getParameters();
+
+    // 函数体：顶格的"name:"开始新基本块，缩进的行是指令
+    std::shared_ptr<IRBasicBlock> block;
+    while (true) {
+        if (isAtEnd()) {
+            throw error("Unterminated function body, expect '}'.");
+        }
+
+        bool indented = peek() == ' ' || peek() == '\t';
+        skipSpaces();
+
+        if (match('\n')) {
+            nextLine();
+            continue;
+        }
+
+        if (!indented && match('}')) {
+            skipLine();
+            break;
+        }
+
+        if (!indented) {
+            std::string_view blockName = scanName();
+            if (blockName.empty()) {
+                throw error("Expect basic block label.");
+            }
+            expect(':', "Expect ':' after basic block label.");
+            BlockEntry& entry = blockFor(blockName);
+            if (entry.defined) {
+                throw error("Duplicate basic block label '" + std::string(blockName) + "'.");
+            }
+            entry.defined = true;
+            block = entry.block;
+            function->addBlock(block);
+            skipLine();
+            continue;
+        }
+
+        if (!block) {
+            throw error("Instruction outside of basic block.");
+        }
+        block->addInstruction(parseInstruction());
+        skipLine();
+    }
+
+    resolveForwardReferences();
+
+    // 只被引用、没有定义的基本块在这里释放，指向它们的标签只保留名字
+    blocks_.clear();
+    return function;
+}
+
+std::shared_ptr<IRInstruction> IRParser::parseInstruction() {
+    // 可选的结果 "%name = "
+    std::string_view resultName;
+    if (match('%')) {
+        resultName = scanName();
+        skipSpaces();
+        expect('=', "Expect '=' after instruction result.");
+        skipSpaces();
+    }
+
+    std::string_view opcodeText = scanName();
+    auto opIt = opcodeTable().find(opcodeText);
+    if (opIt == opcodeTable().end()) {
+        throw error("Unknown opcode '" + std::string(opcodeText) + "'.");
+    }
+    IROpcode opcode = opIt->second;
+    skipSpaces();
+
+    // alloca 后面跟随分配的类型
+    IRType allocaType = IRType::INT32;
+    std::vector<std::shared_ptr<IRValue>> operands;
+    if (opcode == IROpcode::ALLOCA) {
+        if (!atLineEnd()) {
+            allocaType = parseType();
+        }
+    } else if (!atLineEnd()) {
+        do {
+            skipSpaces();
+            operands.push_back(parseOperand());
+            skipSpaces();
+        } while (match(','));
+    }
+
+    skipSpaces();
+    if (!atLineEnd()) {
+        throw error("Unexpected trailing characters after instruction.");
+    }
+
+    std::shared_ptr<IRIdentifier> result;
+    if (!resultName.empty()) {
+        IRType resultType = opcode == IROpcode::ALLOCA ? allocaType : inferResultType(opcode, operands);
+        result = defineIdentifier(resultName, resultType);
+    }
+
+    auto inst = std::make_shared<IRInstruction>(opcode, result, std::move(operands));
+    if (result && opcode != IROpcode::ALLOCA) {
+        inferred_.push_back(inst.get());
+    }
+    return inst;
+}
+
+std::shared_ptr<IRValue> IRParser::parseOperand() {
+    if (match('%')) {
+        return lookupIdentifier(scanName());
+    }
+
+    if (match('@')) {
+        std::string_view callee = scanName();
+        if (callee.empty()) {
+            throw error("Expect function name after '@'.");
+        }
+        return std::make_shared<IRFunctionRef>(std::string(callee));
+    }
+
+    if (match('"')) {
+        return parseString();
+    }
+
+    char c = peek();
+    if (std::isdigit(static_cast<unsigned char>(c)) || c == '-' || c == '+') {
+        const char* begin = source_.c_str() + current_;
+        char* end = nullptr;
+        
+        // 带符号的inf/nan，IRFloatConstant打印负无穷和负NaN时会生成
+        if ((c == '-' || c == '+') && std::isalpha(static_cast<unsigned char>(begin[1]))) {
+            current_++;
+            std::string_view name = scanName();
+            if (name != "inf" && name != "nan") {
+                throw error("Invalid numeric constant.");
+            }
+            float floatValue = std::strtof(begin, nullptr);
+            return std::make_shared<IRFloatConstant>(floatValue);
+        }
+        
+        errno = 0;
+        long intValue = std::strtol(begin, &end, 10);
+        if (end == begin) {
+            throw error("Invalid numeric constant.");
+        }
+        if (*end == '.' || *end == 'e' || *end == 'E') {
+            float floatValue = std::strtof(begin, &end);
+            current_ += end - begin;
+            return std::make_shared<IRFloatConstant>(floatValue);
+        }
+        if (errno == ERANGE || intValue < std::numeric_limits<int>::min() ||
+            intValue > std::numeric_limits<int>::max()) {
+            throw error("Integer constant out of range.");
+        }
+        current_ += end - begin;
+        return std::make_shared<IRIntConstant>(static_cast<int>(intValue));
+    }
+
+    std::string_view name = scanName();
+    if (name.empty()) {
+        throw error("Expect operand.");
+    }
+
+    if (match(':')) {
+        return blockFor(name).block->getLabel();
+    }
+
+    if (name == "nan" || name == "inf") {
+        return std::make_shared<IRFloatConstant>(std::strtof(std::string(name).c_str(), nullptr));
+    }
+
+    throw error("Unexpected operand '" + std::string(name) + "'.");
+}
+
+std::shared_ptr<IRValue> IRParser::parseString() {
+    auto hexValue = [](char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    };
+
+    std::string value;
+    while (!match('"')) {
+        if (atLineEnd()) {
+            throw error("Unterminated string constant.");
+        }
+        char c = source_[current_++];
+        if (c != '\\') {
+            value += c;
+            continue;
+        }
+        int high = current_ < source_.size() ? hexValue(source_[current_]) : -1;
+        int low = current_ + 1 < source_.size() ? hexValue(source_[current_ + 1]) : -1;
+        if (high < 0 || low < 0) {
+            throw error("Invalid escape in string constant.");
+        }
+        value += static_cast<char>(high * 16 + low);
+        current_ += 2;
+    }
+    return std::make_shared<IRStringConstant>(std::move(value));
+}
+
+IRParser::BlockEntry& IRParser::blockFor(std::string_view name) {
+    BlockEntry& entry = blocks_[name];
+    if (!entry.block) {
+        entry.block = std::make_shared<IRBasicBlock>(std::string(name));
+    }
+    return entry;
+}
+
+IRType IRParser::parseType() {
+    std::string_view text = scanName();
+    if (text == "i32") return IRType::INT32;
+    if (text == "f32") return IRType::FLOAT32;
+    if (text == "void") return IRType::VOID;
+    if (text == "ptr") return IRType::POINTER;
+    if (text == "label") return IRType::LABEL;
+    throw error("Unknown type '" + std::string(text) + "'.");
+}
+
+std::shared_ptr<IRIdentifier> IRParser::lookupIdentifier(std::string_view name) {
+    if (name.empty()) {
+        throw error("Expect identifier name after '%'.");
+    }
+
+    auto it = identifiers_.find(name);
+    if (it != identifiers_.end()) {
+        return it->second.ident;
+    }
+
+    // 参数在函数体中以%param.<name>的形式出现，类型取自函数签名
+    if (parameters_ && name.substr(0, 6) == "param.") {
+        for (const auto& param : *parameters_) {
+            if (name.substr(6) == param.name) {
+                auto ident = std::make_shared<IRIdentifier>(std::string(name), param.type);
+                identifiers_.emplace(name, IdentifierEntry{ident, true});
+                return ident;
+            }
+        }
+    }
+
+    // 先于定义的引用，类型在定义时确定
+    auto ident = std::make_shared<IRIdentifier>(std::string(name), IRType::INT32);
+    identifiers_.emplace(name, IdentifierEntry{ident, false});
+    return ident;
+}
+
+std::shared_ptr<IRIdentifier> IRParser::defineIdentifier(std::string_view name, IRType type) {
+    if (name.empty()) {
+        throw error("Expect identifier name after '%'.");
+    }
+
+    IdentifierEntry& entry = identifiers_[name];
+    if (entry.defined) {
+        // 同名的两个定义会共用一个标识符，第二个定义的类型会丢失
+        throw error("Duplicate definition of '%" + std::string(name) + "'.");
+    }
+    entry.defined = true;
+    if (entry.ident) {
+        if (entry.ident->getType() != type) {
+            entry.ident->setType(type);
+            forwardReferences_ = true;
+        }
+        return entry.ident;
+    }
+    entry.ident = std::make_shared<IRIdentifier>(std::string(name), type);
+    return entry.ident;
+}
+
+void IRParser::resolveForwardReferences() {
+    // 引用处推导出的类型可能用了尚未定义的操作数的暂定类型，重新推导直到不再变化
+    bool changed = forwardReferences_;
+    while (changed) {
+        changed = false;
+        for (IRInstruction* inst : inferred_) {
+            IRType type = inferResultType(inst->getOpcode(), inst->getOperands());
+            if (type != inst->getResult()->getType()) {
+                inst->getResult()->setType(type);
+                changed = true;
+            }
+        }
+    }
+    inferred_.clear();
+    forwardReferences_ = false;
+}
+
+IRType IRParser::inferResultType(IROpcode opcode,
+                                 const std::vector<std::shared_ptr<IRValue>>& operands) const {
+    switch (opcode) {
+        case IROpcode::CALL: {
+            // 与IRBuilder相同：结果取被调用函数的返回类型，void函数和未知函数的结果占一个i32
+            auto* callee = operands.empty() ? nullptr : dynamic_cast<IRFunctionRef*>(operands[0].get());
+            auto it = callee ? returnTypes_.find(callee->getName()) : returnTypes_.end();
+            if (it == returnTypes_.end() || it->second == IRType::VOID) {
+                return IRType::INT32;
+            }
+            return it->second;
+        }
+        case IROpcode::CMP_EQ:
+        case IROpcode::CMP_NE:
+        case IROpcode::CMP_LT:
+        case IROpcode::CMP_LE:
+        case IROpcode::CMP_GT:
+        case IROpcode::CMP_GE:
+        case IROpcode::AND:
+        case IROpcode::OR:
+        case IROpcode::NOT:
+        case IROpcode::FLOAT_TO_INT:
+            return IRType::INT32;
+        case IROpcode::INT_TO_FLOAT:
+            return IRType::FLOAT32;
+        default:
+            return operands.empty() ? IRType::INT32 : operands[0]->getType();
+    }
+}
+
+void IRParser::skipSpaces() {
+    while (!isAtEnd() && (source_[current_] == ' ' || source_[current_] == '\t' ||
+                          source_[current_] == '\r')) {
+        current_++;
+    }
+}
+
+void IRParser::skipLine() {
+    while (!atLineEnd()) {
+        current_++;
+    }
+    if (!isAtEnd()) {
+        current_++;
+        nextLine();
+    }
+}
+
+void IRParser::nextLine() {
+    line_++;
+    lineStart_ = current_;
+}
+
+bool IRParser::match(char expected) {
+    if (peek() != expected || isAtEnd()) {
+        return false;
+    }
+    current_++;
+    return true;
+}
+
+void IRParser::expect(char expected, const std::string& message) {
+    if (!match(expected)) {
+        throw error(message);
+    }
+}
+
+bool IRParser::matchWord(std::string_view word) {
+    if (source_.compare(current_, word.size(), word) != 0) {
+        return false;
+    }
+    size_t next = current_ + word.size();
+    if (next < source_.size() && isNameChar(source_[next])) {
+        return false;
+    }
+    current_ = next;
+    return true;
+}
+
+std::string_view IRParser::scanName() {
+    size_t start = current_;
+    while (!isAtEnd() && isNameChar(source_[current_])) {
+        current_++;
+    }
+    return std::string_view(source_).substr(start, current_ - start);
+}
+
+IRParseError IRParser::error(const std::string& message) const {
+    std::ostringstream oss;
+    oss << "IR parse error at line " << line_ << ": " << message;
+    return IRParseError(oss.str(), SourceLocation(line_, static_cast<int>(current_ - lineStart_) + 1));
+}
+
+} // namespace minicompiler
@@ -20,6 +20,9 @@ Lexer::Lexer(std::string source) : source_(std::move(source)) {}
 
 std::vector<Token> Lexer::scanTokens() {
     while (!isAtEnd()) {
+        if (tokens_.size() % kCancellationInterval == 0) {
+            throwIfCancelled(cancellation_);
+        }
         start_ = current_;
         tokens_.push_back(scanToken());
     }
@@ -139,7 +142,7 @@ char Lexer::advance() {
     return source_[current_++];
 }
 
-char Lexer::peek(size_t offset) const {
+char Lexer::peekChar(size_t offset) const {
     if (current_ + offset >= source_.length()) {
         return '\0';
     }
@@ -158,7 +161,7 @@ bool Lexer::match(char expected) {
 
 void Lexer::skipWhitespace() {
     while (!isAtEnd()) {
-        char c = peek();
+        char c = peekChar();
         
         switch (c) {
             case ' ':
@@ -172,18 +175,18 @@ void Lexer::skipWhitespace() {
                 advance();
                 break;
             case '/':
-                if (peek(1) == '/') {
+                if (peekChar(1) == '/') {
                     // 单行注释
-                    while (peek() != '\n' && !isAtEnd()) {
+                    while (peekChar() != '\n' && !isAtEnd()) {
                         advance();
                     }
-                } else if (peek(1) == '*') {
+                } else if (peekChar(1) == '*') {
                     // 多行注释
                     advance(); // 消费 '/'
                     advance(); // 消费 '*'
                     
-                    while (!isAtEnd() && !(peek() == '*' && peek(1) == '/')) {
-                        if (peek() == '\n') {
+                    while (!isAtEnd() && !(peekChar() == '*' && peekChar(1) == '/')) {
+                        if (peekChar() == '\n') {
                             line_++;
                             column_ = 1;
                         }
@@ -205,7 +208,7 @@ void Lexer::skipWhitespace() {
 }
 
 Token Lexer::scanIdentifier() {
-    while (std::isalnum(peek()) || peek() == '_') {
+    while (std::isalnum(peekChar()) || peekChar() == '_') {
         advance();
     }
     
@@ -224,16 +227,16 @@ Token Lexer::scanIdentifier() {
 Token Lexer::scanNumber() {
     bool isFloat = false;
     
-    while (std::isdigit(peek())) {
+    while (std::isdigit(peekChar())) {
         advance();
     }
     
     // 小数部分
-    if (peek() == '.' && std::isdigit(peek(1))) {
+    if (peekChar() == '.' && std::isdigit(peekChar(1))) {
         isFloat = true;
         advance(); // 消费 '.'
         
-        while (std::isdigit(peek())) {
+        while (std::isdigit(peekChar())) {
             advance();
         }
     }
@@ -247,8 +250,8 @@ Token Lexer::scanNumber() {
 Token Lexer::scanString() {
     // 跳过开始的引号
     
-    while (peek() != '"' && !isAtEnd()) {
-        if (peek() == '\n') {
+    while (peekChar() != '"' && !isAtEnd()) {
+        if (peekChar() == '\n') {
             line_++;
             column_ = 1;
         }
@@ -5,55 +5,137 @@
 #include <vector>
 #include <memory>
 #include <cstring>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 
-#include "lexer/lexer.h"
-#include "parser/parser.h"
-#include "ir/ir_builder.h"
+#include "driver/batch_compiler.h"
+#include "driver/compiler_context.h"
+#include "ir/ir_linker.h"
 #include "optimizer/optimizer.h"
 #include "codegen/code_generator.h"
+#include "common/output_file.h"
+#include "common/time_report.h"
 
 using namespace minicompiler;
 
 void printUsage(const char* programName) {
-    std::cerr << "Usage: " << programName << " [options] <input_file>" << std::endl;
+    std::cerr << "Usage: " << programName << " [options] <input_file>..." << std::endl;
     std::cerr << "Options:" << std::endl;
     std::cerr << "  -o <output_file>   Specify output file (default: a.out)" << std::endl;
     std::cerr << "  --emit-ir          Output LLVM IR instead of executable" << std::endl;
+    std::cerr << "  --from-ir          Treat input file as IR text (as written by --emit-ir)" << std::endl;
+    std::cerr << "  -c                 Compile each input separately without linking" << std::endl;
+    std::cerr << "  -flto              Emit IR objects with -c; link and optimize the whole program" << std::endl;
+    std::cerr << "  -flto-jobs=<n>     Number of parallel code generation partitions for -flto" << std::endl;
     std::cerr << "  -O0                No optimizations" << std::endl;
     std::cerr << "  -O1                Basic optimizations" << std::endl;
     std::cerr << "  -O2                More aggressive optimizations" << std::endl;
+    std::cerr << "  --time-budget=<ms> Skip inlining and IPCP once compilation has taken this long" << std::endl;
+    std::cerr << "  --lazy-functions   Only parse and compile functions reachable from main (single input)" << std::endl;
+    std::cerr << "  --batch            Compile NDJSON records {name, source, flags} from stdin to stdout" << std::endl;
+    std::cerr << "  --batch-jobs=<n>   Number of records compiled in parallel with --batch" << std::endl;
+    std::cerr << "  --batch-unordered  Write --batch results as they complete instead of in input order" << std::endl;
+    std::cerr << "  --time-report      Print the time spent in each compilation phase" << std::endl;
+    std::cerr << "  --perf-counters    Add hardware counters (perf_event_open) to --time-report" << std::endl;
     std::cerr << "  -h, --help         Display this help message" << std::endl;
 }
 
 std::string readFile(const std::string& filename) {
-    std::ifstream file(filename);
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
     if (!file) {
         std::cerr << "Error: Could not open file '" << filename << "'" << std::endl;
         return "";
     }
     
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
+    // 按文件大小一次性读入，避免经过stringstream再复制一次
+    file.seekg(0, std::ios::end);
+    std::string content(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0, std::ios::beg);
+    file.read(&content[0], static_cast<std::streamsize>(content.size()));
+    return content;
 }
 
-bool writeFile(const std::string& filename, const std::string& content) {
-    std::ofstream file(filename);
-    if (!file) {
+bool writeIR(const std::string& filename, const IRModule& module) {
+    OutputFile file(filename);
+    if (!file.isOpen()) {
         std::cerr << "Error: Could not open file '" << filename << "' for writing" << std::endl;
         return false;
     }
     
-    file << content;
+    // 直接流式写入文件，不构造完整的IR字符串
+    module.print(file.stream());
+    if (!file.close()) {
+        std::cerr << "Error: Failed to write file '" << filename << "'" << std::endl;
+        return false;
+    }
     return true;
 }
 
+/**
+ * @brief 读取一个输入文件并生成IR模块
+ *
+ * 以ModuleID注释开头的文件是-flto -c生成的IR对象，直接解析IR文本。
+ * lazyFunctions为true时只解析从main可达的函数体，其它模块中的调用者看不到被跳过的函数，
+ * 因此只用于单个输入的完整编译。
+ */
+std::shared_ptr<IRModule> loadModule(CompilerContext& context, const std::string& inputFile, bool fromIR,
+                                     bool lazyFunctions, TimeReport& timeReport) {
+    std::string source;
+    {
+        auto phase = timeReport.phase("Read input");
+        source = readFile(inputFile);
+    }
+    if (source.empty()) {
+        return nullptr;
+    }
+    
+    CompileOptions options;
+    options.moduleName = inputFile;
+    options.fromIR = fromIR;
+    options.lazyFunctions = lazyFunctions;
+    options.timeReport = &timeReport;
+    options.progress = &std::cout;
+    
+    CompileResult result = context.compile(source, options);
+    for (const auto& diagnostic : result.diagnostics) {
+        std::cerr << diagnostic.toString() << std::endl;
+    }
+    return result.module;
+}
+
+/**
+ * @brief 计算-c模式下单个输入对应的输出文件名（去掉目录和扩展名后加上.o）
+ */
+std::string objectFileName(const std::string& inputFile) {
+    std::string name = inputFile.substr(inputFile.find_last_of("/\\") + 1);
+    size_t dot = name.rfind('.');
+    if (dot != std::string::npos && dot > 0) {
+        name.erase(dot);
+    }
+    return name + ".o";
+}
+
 int main(int argc, char* argv[]) {
+    // 编译时间预算从进程启动时开始计算
+    const auto startTime = std::chrono::steady_clock::now();
+    
     // 解析命令行参数
-    std::string inputFile;
-    std::string outputFile = "a.out";
+    std::vector<std::string> inputFiles;
+    std::string outputFile;
     bool emitIR = false;
+    bool fromIR = false;
+    bool compileOnly = false;
+    bool lto = false;
+    unsigned ltoJobs = std::max(1u, std::thread::hardware_concurrency());
     int optimizationLevel = 0;
+    bool timeReportEnabled = false;
+    bool perfCounters = false;
+    bool lazyFunctions = false;
+    std::chrono::milliseconds timeBudget{0};
+    bool batch = false;
+    BatchOptions batchOptions;
     
     for (int i = 1; i < argc; ++i) {
         if (strcmp(argv[i], "-o") == 0) {
@@ -65,12 +147,50 @@ int main(int argc, char* argv[]) {
             }
         } else if (strcmp(argv[i], "--emit-ir") == 0) {
             emitIR = true;
+        } else if (strcmp(argv[i], "--from-ir") == 0) {
+            fromIR = true;
+        } else if (strcmp(argv[i], "-c") == 0) {
+            compileOnly = true;
+        } else if (strcmp(argv[i], "-flto") == 0) {
+            lto = true;
+        } else if (strncmp(argv[i], "-flto-jobs=", 11) == 0) {
+            int jobs = std::atoi(argv[i] + 11);
+            if (jobs <= 0) {
+                std::cerr << "Error: Invalid value for -flto-jobs" << std::endl;
+                return 1;
+            }
+            ltoJobs = static_cast<unsigned>(jobs);
         } else if (strcmp(argv[i], "-O0") == 0) {
             optimizationLevel = 0;
         } else if (strcmp(argv[i], "-O1") == 0) {
             optimizationLevel = 1;
         } else if (strcmp(argv[i], "-O2") == 0) {
             optimizationLevel = 2;
+        } else if (strncmp(argv[i], "--time-budget=", 14) == 0) {
+            int budget = std::atoi(argv[i] + 14);
+            if (budget <= 0) {
+                std::cerr << "Error: Invalid value for --time-budget" << std::endl;
+                return 1;
+            }
+            timeBudget = std::chrono::milliseconds(budget);
+        } else if (strcmp(argv[i], "--lazy-functions") == 0) {
+            lazyFunctions = true;
+        } else if (strcmp(argv[i], "--batch") == 0) {
+            batch = true;
+        } else if (strncmp(argv[i], "--batch-jobs=", 13) == 0) {
+            int jobs = std::atoi(argv[i] + 13);
+            if (jobs <= 0) {
+                std::cerr << "Error: Invalid value for --batch-jobs" << std::endl;
+                return 1;
+            }
+            batchOptions.jobs = static_cast<unsigned>(jobs);
+        } else if (strcmp(argv[i], "--batch-unordered") == 0) {
+            batchOptions.ordered = false;
+        } else if (strcmp(argv[i], "--time-report") == 0) {
+            timeReportEnabled = true;
+        } else if (strcmp(argv[i], "--perf-counters") == 0) {
+            timeReportEnabled = true;
+            perfCounters = true;
         } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             printUsage(argv[0]);
             return 0;
@@ -79,58 +199,150 @@ int main(int argc, char* argv[]) {
             printUsage(argv[0]);
             return 1;
         } else {
-            inputFile = argv[i];
+            inputFiles.push_back(argv[i]);
+        }
+    }
+    
+    // 批量编译：命令行上的优化级别等选项作为每个记录的默认值
+    if (batch) {
+        if (!inputFiles.empty()) {
+            std::cerr << "Error: --batch reads records from stdin and takes no input files" << std::endl;
+            return 1;
         }
+        batchOptions.defaults.optimizationLevel = optimizationLevel;
+        batchOptions.defaults.emitIR = emitIR;
+        batchOptions.defaults.fromIR = fromIR;
+        batchOptions.defaults.lazyFunctions = lazyFunctions;
+        batchOptions.defaults.timeBudget = timeBudget;
+        std::ios::sync_with_stdio(false);
+        BatchCompiler compiler(batchOptions);
+        return compiler.run(std::cin, std::cout) == 0 ? 0 : 1;
     }
     
-    if (inputFile.empty()) {
+    if (inputFiles.empty()) {
         std::cerr << "Error: No input file specified" << std::endl;
         printUsage(argv[0]);
         return 1;
     }
     
-    // 读取源文件
-    std::string source = readFile(inputFile);
-    if (source.empty()) {
+    if (compileOnly && inputFiles.size() > 1 && !outputFile.empty()) {
+        std::cerr << "Error: -o cannot be used with -c and multiple input files" << std::endl;
         return 1;
     }
     
+    TimeReport timeReport(timeReportEnabled, perfCounters);
+    
+    // 超过截止时间后优化器跳过昂贵的pass
+    auto deadline = timeBudget.count() > 0 ? startTime + timeBudget : std::chrono::steady_clock::time_point::max();
+    
+    // 所有输入共用一个编译上下文，线程池只创建一次
+    CompilerContext context;
+    
+    // 报告在所有阶段结束后输出到stderr，出错返回时也输出
+    struct ReportOnExit {
+        TimeReport& report;
+        ~ReportOnExit() { report.print(std::cerr); }
+    } reportOnExit{timeReport};
+    
     try {
-        // 词法分析
-        std::cout << "Lexical analysis..." << std::endl;
-        Lexer lexer(source);
-        std::vector<Token> tokens = lexer.scanTokens();
-        
-        // 语法分析
-        std::cout << "Syntax analysis..." << std::endl;
-        Parser parser(tokens);
-        std::unique_ptr<Program> ast = parser.parse();
+        // 分别编译：每个输入生成一个目标文件，-flto时为IR对象
+        if (compileOnly) {
+            for (const auto& inputFile : inputFiles) {
+                std::shared_ptr<IRModule> irModule = loadModule(context, inputFile, fromIR, false, timeReport);
+                if (!irModule) {
+                    return 1;
+                }
+                
+                if (optimizationLevel > 0) {
+                    std::cout << "Optimizing IR (level " << optimizationLevel << ")..." << std::endl;
+                    auto phase = timeReport.phase("Optimization");
+                    Optimizer optimizer(optimizationLevel);
+                    optimizer.setDeadline(deadline);
+                    irModule = optimizer.optimize(irModule);
+                }
+                
+                std::string objectFile = outputFile.empty() ? objectFileName(inputFile) : outputFile;
+                if (lto || emitIR) {
+                    auto phase = timeReport.phase("IR emission");
+                    if (!writeIR(objectFile, *irModule)) {
+                        return 1;
+                    }
+                    std::cout << "IR object written to " << objectFile << std::endl;
+                } else {
+                    auto phase = timeReport.phase("Code generation");
+                    CodeGenerator codeGen("x86_64-unknown-linux-gnu"); // 默认目标平台
+                    if (!codeGen.generate(irModule, objectFile)) {
+                        return 1;
+                    }
+                }
+            }
+            
+            std::cout << "Compilation successful!" << std::endl;
+            return 0;
+        }
         
-        // 生成IR
-        std::cout << "Generating IR..." << std::endl;
-        IRBuilder irBuilder(inputFile);
-        std::shared_ptr<IRModule> irModule = irBuilder.build(ast.get());
+        if (outputFile.empty()) {
+            outputFile = "a.out";
+        }
         
-        // 输出IR
-        if (emitIR) {
-            std::string irCode = irModule->toString();
-            if (!writeFile(outputFile, irCode)) {
+        // 读取并链接所有输入；单个输入也要检查原型声明的函数是否有定义
+        std::shared_ptr<IRModule> irModule;
+        if (inputFiles.size() == 1) {
+            irModule = loadModule(context, inputFiles[0], fromIR, lazyFunctions, timeReport);
+            if (!irModule) {
                 return 1;
             }
-            std::cout << "IR code written to " << outputFile << std::endl;
-            return 0;
+            auto phase = timeReport.phase("Linking");
+            IRLinker linker(irModule->getName());
+            linker.link(irModule);
+            linker.resolve();
+            irModule = linker.getModule();
+        } else {
+            IRLinker linker(outputFile);
+            for (const auto& inputFile : inputFiles) {
+                std::shared_ptr<IRModule> inputModule = loadModule(context, inputFile, fromIR, false, timeReport);
+                if (!inputModule) {
+                    return 1;
+                }
+                auto phase = timeReport.phase("Linking");
+                linker.link(inputModule);
+            }
+            {
+                auto phase = timeReport.phase("Linking");
+                linker.resolve();
+            }
+            std::cout << "Linked " << inputFiles.size() << " modules" << std::endl;
+            irModule = linker.getModule();
         }
         
         // 优化IR
         if (optimizationLevel > 0) {
-            std::cout << "Optimizing IR (level " << optimizationLevel << ")..." << std::endl;
+            std::cout << "Optimizing IR (level " << optimizationLevel
+                      << (lto ? ", whole program" : "") << ")..." << std::endl;
+            auto phase = timeReport.phase("Optimization");
             Optimizer optimizer(optimizationLevel);
+            optimizer.setWholeProgram(lto);
+            optimizer.setDeadline(deadline);
             irModule = optimizer.optimize(irModule);
         }
         
+        // 输出IR（优化之后，便于逐个pass对比）
+        if (emitIR) {
+            auto phase = timeReport.phase("IR emission");
+            if (!writeIR(outputFile, *irModule)) {
+                return 1;
+            }
+            std::cout << "IR code written to " << outputFile << std::endl;
+            return 0;
+        }
+        
         // 生成目标代码
         std::cout << "Generating target code..." << std::endl;
+        auto phase = timeReport.phase("Code generation");
         CodeGenerator codeGen("x86_64-unknown-linux-gnu"); // 默认目标平台
+        if (lto) {
+            codeGen.setParallelJobs(ltoJobs);
+        }
         if (!codeGen.generate(irModule, outputFile)) {
             return 1;
         }
@@ -143,4 +355,4 @@ int main(int argc, char* argv[]) {
     }
     
     return 0;
-} 
\ No newline at end of file
+}
@@ -1,35 +1,160 @@
 #include "optimizer/optimizer.h"
 #include <iostream>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace minicompiler {
 
-Optimizer::Optimizer(int level) : level_(level) {}
+namespace {
+
+// 指令数不超过该阈值的函数才会被内联
+constexpr size_t kInlineThreshold = 64;
+
+// 找到模块中已使用的最大内联后缀".i<N>"，保证重复优化时生成的名称不冲突
+int nextInlineIndex(const IRModule& module) {
+    int next = 0;
+    for (const auto& function : module.getFunctions()) {
+        for (const auto& block : function->getBlocks()) {
+            const std::string& name = block->getName();
+            size_t dot = name.rfind(".i");
+            if (dot == std::string::npos || dot + 2 >= name.size()) {
+                continue;
+            }
+            int index = 0;
+            bool digits = true;
+            for (size_t i = dot + 2; i < name.size(); ++i) {
+                if (name[i] < '0' || name[i] > '9') {
+                    digits = false;
+                    break;
+                }
+                index = index * 10 + (name[i] - '0');
+            }
+            if (digits && index >= next) {
+                next = index + 1;
+            }
+        }
+    }
+    return next;
+}
+
+bool sameConstant(const IRValue* a, const IRValue* b) {
+    if (auto* ia = dynamic_cast<const IRIntConstant*>(a)) {
+        auto* ib = dynamic_cast<const IRIntConstant*>(b);
+        return ib && ia->getValue() == ib->getValue();
+    }
+    if (auto* fa = dynamic_cast<const IRFloatConstant*>(a)) {
+        auto* fb = dynamic_cast<const IRFloatConstant*>(b);
+        return fb && fa->getValue() == fb->getValue();
+    }
+    return false;
+}
+
+} // namespace
+
+Optimizer::Optimizer(int level) : level_(level), progress_(&std::cout) {}
+
+void Optimizer::beginPass(const char* pass) {
+    throwIfCancelled(cancellation_);
+    if (progress_) {
+        *progress_ << "Performing " << pass << "..." << std::endl;
+    }
+}
+
+bool Optimizer::beginOptionalPass(const char* pass, const char* name) {
+    if (std::chrono::steady_clock::now() < deadline_) {
+        beginPass(pass);
+        return true;
+    }
+    if (progress_) {
+        *progress_ << "Skipping " << pass << " (time budget exceeded)" << std::endl;
+    }
+    skipped_.push_back(name);
+    return false;
+}
 
 std::shared_ptr<IRModule> Optimizer::optimize(std::shared_ptr<IRModule> module) {
     if (level_ <= 0) {
         return module;
     }
-    
-    std::cout << "Performing constant folding..." << std::endl;
+
+    beginPass("constant folding");
     constantFolding(module);
-    
-    std::cout << "Performing dead code elimination..." << std::endl;
+
+    beginPass("dead code elimination");
     deadCodeElimination(module);
-    
+
+    // 死函数消除只遍历一次调用图，不受时间预算限制；先删掉不可达的函数，后面的pass处理得更少
+    if (wholeProgram_) {
+        beginPass("dead function elimination");
+        deadFunctionElimination(module);
+    }
+
+    // CSE和LICM还没有实现，跳过它们省不下时间，因此不受时间预算限制
     if (level_ >= 2) {
-        std::cout << "Performing common subexpression elimination..." << std::endl;
+        beginPass("common subexpression elimination");
         commonSubexpressionElimination(module);
-        
-        std::cout << "Performing loop invariant code motion..." << std::endl;
+
+        beginPass("loop invariant code motion");
         loopInvariantCodeMotion(module);
-        
-        std::cout << "Performing function inlining..." << std::endl;
+    }
+
+    // 整程序模式下即使是-O1也做内联，跨文件的小函数由此得以展开
+    bool inlined = false;
+    if ((level_ >= 2 || wholeProgram_) && beginOptionalPass("function inlining", "inline")) {
         functionInlining(module);
+        inlined = true;
+    }
+
+    if (wholeProgram_) {
+        if (beginOptionalPass("interprocedural constant propagation", "ipcp")) {
+            interproceduralConstantPropagation(module);
+        }
+
+        // 所有调用点都被内联的函数这时才变得不可达
+        if (inlined) {
+            beginPass("dead function elimination");
+            deadFunctionElimination(module);
+        }
     }
-    
+
     return module;
 }
 
+const std::vector<std::string>& Optimizer::getPassNames() {
+    static const std::vector<std::string> names = {
+        "constant-folding",
+        "dce",
+        "cse",
+        "licm",
+        "inline",
+        "ipcp",
+        "dead-function-elimination"
+    };
+    return names;
+}
+
+bool Optimizer::runPass(const std::string& name, std::shared_ptr<IRModule> module) {
+    if (name == "constant-folding") {
+        constantFolding(module);
+    } else if (name == "dce") {
+        deadCodeElimination(module);
+    } else if (name == "cse") {
+        commonSubexpressionElimination(module);
+    } else if (name == "licm") {
+        loopInvariantCodeMotion(module);
+    } else if (name == "inline") {
+        functionInlining(module);
+    } else if (name == "ipcp") {
+        interproceduralConstantPropagation(module);
+    } else if (name == "dead-function-elimination") {
+        deadFunctionElimination(module);
+    } else {
+        return false;
+    }
+    return true;
+}
+
 void Optimizer::constantFolding(std::shared_ptr<IRModule> module) {
     // TODO: 实现常量折叠
 }
@@ -47,7 +172,294 @@ void Optimizer::loopInvariantCodeMotion(std::shared_ptr<IRModule> module) {
 }
 
 void Optimizer::functionInlining(std::shared_ptr<IRModule> module) {
-    // TODO: 实现函数内联
+    std::unordered_map<std::string, std::shared_ptr<IRFunction>> functions;
+    for (const auto& function : module->getFunctions()) {
+        functions[function->getName()] = function;
+    }
+
+    inlineCounter_ = nextInlineIndex(*module);
+
+    // 按已处理的指令估计每条指令的耗时，预计处理下一个调用者会超过截止时间时跳过它
+    using Clock = std::chrono::steady_clock;
+    const bool budgeted = deadline_ != Clock::time_point::max();
+    const Clock::time_point start = Clock::now();
+    Clock::rep processed = 0;
+
+    for (const auto& caller : module->getFunctions()) {
+        throwIfCancelled(cancellation_);
+        if (budgeted) {
+            Clock::time_point now = Clock::now();
+            auto size = static_cast<Clock::rep>(caller->getInstructionCount());
+            Clock::duration estimate = processed == 0 ? Clock::duration::zero()
+                                                      : (now - start) * size / processed;
+            if (now + estimate >= deadline_) {
+                skipped_.push_back("inline:" + caller->getName());
+                continue;
+            }
+            processed += size;
+        }
+
+        std::vector<std::shared_ptr<IRBasicBlock>> blocks;
+        std::vector<std::shared_ptr<IRInstruction>> allocas;
+        bool changed = false;
+
+        for (const auto& original : caller->getBlocks()) {
+            std::vector<std::shared_ptr<IRInstruction>> instructions = original->getInstructions();
+            original->setInstructions({});
+
+            // 内联后原基本块在调用点被拆开，后续指令进入新的延续块
+            std::shared_ptr<IRBasicBlock> block = original;
+            blocks.push_back(block);
+
+            for (const auto& inst : instructions) {
+                auto it = functions.find(inst->getCallee());
+                if (it == functions.end() || !shouldInline(*caller, *it->second) ||
+                    inst->getOperands().size() != it->second->getParameters().size() + 1) {
+                    block->addInstruction(inst);
+                    continue;
+                }
+
+                inlineCall(inst, *it->second, block, blocks, allocas);
+                changed = true;
+            }
+        }
+
+        if (changed) {
+            // 内联产生的alloca放在入口块开头，调用点在循环中时也只分配一次
+            const auto& entry = blocks.front();
+            allocas.insert(allocas.end(), entry->getInstructions().begin(), entry->getInstructions().end());
+            entry->setInstructions(std::move(allocas));
+            caller->setBlocks(std::move(blocks));
+        }
+    }
+}
+
+bool Optimizer::shouldInline(const IRFunction& caller, const IRFunction& callee) const {
+    if (&caller == &callee || callee.getBlocks().empty() ||
+        callee.getInstructionCount() > kInlineThreshold) {
+        return false;
+    }
+
+    // 不内联直接递归的函数
+    for (const auto& block : callee.getBlocks()) {
+        for (const auto& inst : block->getInstructions()) {
+            if (inst->getCallee() == callee.getName()) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void Optimizer::inlineCall(const std::shared_ptr<IRInstruction>& call, const IRFunction& callee,
+                           std::shared_ptr<IRBasicBlock>& block,
+                           std::vector<std::shared_ptr<IRBasicBlock>>& blocks,
+                           std::vector<std::shared_ptr<IRInstruction>>& allocas) {
+    std::string suffix = ".i" + std::to_string(inlineCounter_++);
+    std::string prefix = callee.getName() + ".";
+
+    // 形参 -> 实参
+    std::unordered_map<std::string, std::shared_ptr<IRValue>> arguments;
+    const auto& params = callee.getParameters();
+    for (size_t i = 0; i < params.size(); ++i) {
+        arguments["param." + params[i].name] = call->getOperands()[i + 1];
+    }
+
+    // 被调用者的基本块加上前后缀复制到调用者中，跳转改为指向复制出的基本块
+    std::unordered_map<const IRBasicBlock*, std::shared_ptr<IRBasicBlock>> clones;
+    for (const auto& calleeBlock : callee.getBlocks()) {
+        clones[calleeBlock.get()] = std::make_shared<IRBasicBlock>(prefix + calleeBlock->getName() + suffix);
+    }
+
+    // 被调用者的标识符加上后缀后复制到调用者中
+    std::unordered_map<const IRIdentifier*, std::shared_ptr<IRIdentifier>> renamed;
+    auto mapValue = [&](const std::shared_ptr<IRValue>& value) -> std::shared_ptr<IRValue> {
+        if (auto* ident = dynamic_cast<IRIdentifier*>(value.get())) {
+            auto arg = arguments.find(ident->getName());
+            if (arg != arguments.end()) {
+                return arg->second;
+            }
+            auto& copy = renamed[ident];
+            if (!copy) {
+                copy = std::make_shared<IRIdentifier>(ident->getName() + suffix, ident->getType());
+            }
+            return copy;
+        }
+        if (auto* label = dynamic_cast<IRLabel*>(value.get())) {
+            auto it = clones.find(label->getBlock());
+            if (it != clones.end()) {
+                return it->second->getLabel();
+            }
+            return std::make_shared<IRLabel>(prefix + label->getName() + suffix);
+        }
+        return value;
+    };
+
+    // 返回值通过栈槽传回调用点
+    std::shared_ptr<IRIdentifier> result = call->getResult();
+    std::shared_ptr<IRIdentifier> slot;
+    if (result) {
+        slot = std::make_shared<IRIdentifier>(result->getName() + ".slot" + suffix, result->getType());
+        allocas.push_back(std::make_shared<IRInstruction>(IROpcode::ALLOCA, slot));
+    }
+
+    auto continuation = std::make_shared<IRBasicBlock>(prefix + "ret" + suffix);
+    std::shared_ptr<IRValue> continuationLabel = continuation->getLabel();
+
+    block->addInstruction(std::make_shared<IRInstruction>(
+        IROpcode::JMP, nullptr,
+        std::vector<std::shared_ptr<IRValue>>{clones[callee.getBlocks().front().get()]->getLabel()}));
+
+    for (const auto& calleeBlock : callee.getBlocks()) {
+        const auto& clone = clones[calleeBlock.get()];
+
+        for (const auto& inst : calleeBlock->getInstructions()) {
+            if (inst->getOpcode() == IROpcode::RET) {
+                if (slot && !inst->getOperands().empty()) {
+                    clone->addInstruction(std::make_shared<IRInstruction>(
+                        IROpcode::STORE, nullptr,
+                        std::vector<std::shared_ptr<IRValue>>{mapValue(inst->getOperands()[0]), slot}));
+                }
+                clone->addInstruction(std::make_shared<IRInstruction>(
+                    IROpcode::JMP, nullptr, std::vector<std::shared_ptr<IRValue>>{continuationLabel}));
+                continue;
+            }
+
+            std::vector<std::shared_ptr<IRValue>> operands;
+            operands.reserve(inst->getOperands().size());
+            for (const auto& operand : inst->getOperands()) {
+                operands.push_back(mapValue(operand));
+            }
+
+            std::shared_ptr<IRIdentifier> cloneResult;
+            if (inst->getResult()) {
+                cloneResult = std::static_pointer_cast<IRIdentifier>(mapValue(inst->getResult()));
+            }
+
+            auto cloneInst = std::make_shared<IRInstruction>(inst->getOpcode(), cloneResult, std::move(operands));
+            if (inst->getOpcode() == IROpcode::ALLOCA) {
+                allocas.push_back(std::move(cloneInst));
+            } else {
+                clone->addInstruction(std::move(cloneInst));
+            }
+        }
+
+        blocks.push_back(clone);
+    }
+
+    if (result) {
+        continuation->addInstruction(std::make_shared<IRInstruction>(
+            IROpcode::LOAD, result, std::vector<std::shared_ptr<IRValue>>{slot}));
+    }
+
+    blocks.push_back(continuation);
+    block = continuation;
+}
+
+void Optimizer::interproceduralConstantPropagation(std::shared_ptr<IRModule> module) {
+    // 收集每个函数的所有调用点
+    std::unordered_map<std::string, std::vector<std::shared_ptr<IRInstruction>>> callSites;
+    for (const auto& function : module->getFunctions()) {
+        for (const auto& block : function->getBlocks()) {
+            for (const auto& inst : block->getInstructions()) {
+                std::string callee = inst->getCallee();
+                if (!callee.empty()) {
+                    callSites[callee].push_back(inst);
+                }
+            }
+        }
+    }
+
+    for (const auto& function : module->getFunctions()) {
+        auto it = callSites.find(function->getName());
+        if (function->getName() == "main" || it == callSites.end()) {
+            continue;
+        }
+
+        const auto& params = function->getParameters();
+        const auto& calls = it->second;
+
+        // 所有调用点都传入同一个常量的参数可以直接替换为该常量
+        std::unordered_map<std::string, std::shared_ptr<IRValue>> constants;
+        for (size_t i = 0; i < params.size(); ++i) {
+            std::shared_ptr<IRValue> value;
+            for (const auto& call : calls) {
+                if (call->getOperands().size() != params.size() + 1) {
+                    value = nullptr;
+                    break;
+                }
+                const auto& arg = call->getOperands()[i + 1];
+                if (!value) {
+                    value = arg;
+                }
+                if (!sameConstant(value.get(), arg.get())) {
+                    value = nullptr;
+                    break;
+                }
+            }
+            if (value) {
+                constants["param." + params[i].name] = value;
+            }
+        }
+
+        if (constants.empty()) {
+            continue;
+        }
+
+        for (const auto& block : function->getBlocks()) {
+            for (const auto& inst : block->getInstructions()) {
+                for (size_t i = 0; i < inst->getOperands().size(); ++i) {
+                    auto* ident = dynamic_cast<IRIdentifier*>(inst->getOperands()[i].get());
+                    if (!ident) {
+                        continue;
+                    }
+                    auto constant = constants.find(ident->getName());
+                    if (constant != constants.end()) {
+                        inst->setOperand(i, constant->second);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void Optimizer::deadFunctionElimination(std::shared_ptr<IRModule> module) {
+    auto main = module->getFunction("main");
+    if (!main) {
+        // 没有入口函数时无法判断可达性，保留全部函数
+        return;
+    }
+
+    std::unordered_map<std::string, std::shared_ptr<IRFunction>> functions;
+    for (const auto& function : module->getFunctions()) {
+        functions[function->getName()] = function;
+    }
+
+    // 从main出发沿调用图标记可达函数
+    std::unordered_set<std::string> reachable{main->getName()};
+    std::queue<std::shared_ptr<IRFunction>> worklist;
+    worklist.push(main);
+    while (!worklist.empty()) {
+        auto function = worklist.front();
+        worklist.pop();
+        for (const auto& block : function->getBlocks()) {
+            for (const auto& inst : block->getInstructions()) {
+                auto it = functions.find(inst->getCallee());
+                if (it != functions.end() && reachable.insert(it->first).second) {
+                    worklist.push(it->second);
+                }
+            }
+        }
+    }
+
+    std::vector<std::shared_ptr<IRFunction>> live;
+    for (const auto& function : module->getFunctions()) {
+        if (reachable.count(function->getName())) {
+            live.push_back(function);
+        }
+    }
+    module->setFunctions(std::move(live));
 }
 
-} // namespace minicompiler 
\ No newline at end of file
+} // namespace minicompiler
@@ -1,30 +1,356 @@
 #include "parser/parser.h"
-#include <iostream>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <iterator>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include "ast/ast_walker.h"
+#include "common/thread_pool.h"
 
 namespace minicompiler {
 
-Parser::Parser(std::vector<Token> tokens) : tokens_(std::move(tokens)) {}
+namespace {
+
+// 表达式的最大嵌套深度，超过时报错而不是耗尽栈空间；
+// 同时限制解析时的递归深度和表达式树的高度，后续递归遍历AST的pass因此不会栈溢出
+constexpr int kMaxExpressionDepth = 256;
+
+constexpr size_t kTokenTypeCount = static_cast<size_t>(TokenType::UNKNOWN) + 1;
+
+/**
+ * @brief 二元运算符的优先级表，按TokenType索引；0表示不是二元运算符，数值越大结合越紧
+ */
+constexpr std::array<uint8_t, kTokenTypeCount> makePrecedenceTable() {
+    std::array<uint8_t, kTokenTypeCount> table{};
+    table[static_cast<size_t>(TokenType::OR)] = 1;
+    table[static_cast<size_t>(TokenType::AND)] = 2;
+    table[static_cast<size_t>(TokenType::EQUAL)] = 3;
+    table[static_cast<size_t>(TokenType::NOT_EQUAL)] = 3;
+    table[static_cast<size_t>(TokenType::LESS)] = 4;
+    table[static_cast<size_t>(TokenType::LESS_EQUAL)] = 4;
+    table[static_cast<size_t>(TokenType::GREATER)] = 4;
+    table[static_cast<size_t>(TokenType::GREATER_EQUAL)] = 4;
+    table[static_cast<size_t>(TokenType::PLUS)] = 5;
+    table[static_cast<size_t>(TokenType::MINUS)] = 5;
+    table[static_cast<size_t>(TokenType::MULTIPLY)] = 6;
+    table[static_cast<size_t>(TokenType::DIVIDE)] = 6;
+    table[static_cast<size_t>(TokenType::MODULO)] = 6;
+    return table;
+}
+
+constexpr std::array<uint8_t, kTokenTypeCount> kPrecedence = makePrecedenceTable();
+
+inline int precedenceOf(TokenType type) {
+    return kPrecedence[static_cast<size_t>(type)];
+}
+
+// 并行解析时每段包含的顶层函数数，太小时线程调度和合并的开销超过解析本身
+constexpr size_t kFunctionsPerSegment = 32;
+
+bool isTypeKeyword(TokenType type) {
+    return type == TokenType::INT || type == TokenType::FLOAT || type == TokenType::VOID;
+}
+
+/**
+ * @brief 把分段驻留表中的符号编号改写为全局驻留表中的编号
+ */
+class SymbolRemapper : public ASTWalker<SymbolRemapper> {
+public:
+    using ASTWalker<SymbolRemapper>::visit;
+    
+    explicit SymbolRemapper(const std::vector<Symbol>& remap) : remap_(remap) {}
+    
+    void visit(VariableExpression* node) {
+        node->setSymbol(remap_[node->getSymbol()]);
+    }
+    
+    void visit(VarDeclaration* node) {
+        node->setSymbol(remap_[node->getSymbol()]);
+        ASTWalker<SymbolRemapper>::visit(node);
+    }
+    
+    void visit(FunctionDeclaration* node) {
+        for (size_t i = 0; i < node->getParameters().size(); ++i) {
+            node->setParameterSymbol(i, remap_[node->getParameters()[i].symbol]);
+        }
+        ASTWalker<SymbolRemapper>::visit(node);
+    }
+    
+private:
+    const std::vector<Symbol>& remap_;
+};
+
+/**
+ * @brief 收集函数体中调用的函数名
+ */
+class CallCollector : public ASTWalker<CallCollector> {
+public:
+    using ASTWalker<CallCollector>::visit;
+    
+    void visit(CallExpression* node) {
+        callees.push_back(&node->getCallee());
+        ASTWalker<CallCollector>::visit(node);
+    }
+    
+    std::vector<const std::string*> callees;
+};
+
+/**
+ * @brief 一个分段的解析结果
+ */
+struct Segment {
+    size_t begin;
+    size_t end;
+    std::vector<std::unique_ptr<Statement>> statements;
+    std::vector<ParseError> errors;
+    std::shared_ptr<StringInterner> interner;
+    bool crossedEnd = false;
+};
+
+} // namespace
+
+Parser::Parser(std::vector<Token> tokens)
+    : ownedTokens_(std::move(tokens)), tokens_(ownedTokens_.data()), end_(ownedTokens_.size() - 1),
+      interner_(std::make_shared<StringInterner>()) {}
+
+Parser::Parser(const Token* tokens, size_t begin, size_t end)
+    : tokens_(tokens), end_(end), interner_(std::make_shared<StringInterner>()), current_(begin) {}
 
 std::unique_ptr<Program> Parser::parse() {
     std::vector<std::unique_ptr<Statement>> statements;
+    errors_.clear();
+    pendingBodies_.clear();
     
-    try {
-        while (!isAtEnd()) {
+    if (lazyBodies_ || jobs_ <= 1 || !parseParallel(statements)) {
+        parseDeclarations(statements);
+    }
+    if (lazyBodies_) {
+        parseReachableBodies(statements);
+    }
+    
+    auto program = std::make_unique<Program>(std::move(statements));
+    program->setInterner(interner_);
+    return program;
+}
+
+void Parser::parseDeclarations(std::vector<std::unique_ptr<Statement>>& statements) {
+    while (current_ < end_ && !isAtEnd()) {
+        throwIfCancelled(cancellation_);
+        size_t start = current_;
+        try {
             statements.push_back(declaration());
+        } catch (ParseError& e) {
+            // 出错的声明整个丢弃，跳到下一个顶层声明
+            report(std::move(e));
+            expressionDepth_ = 0;
+            if (current_ == start) {
+                advance();
+            }
+            synchronizeDeclaration();
+        }
+    }
+}
+
+bool Parser::parseParallel(std::vector<std::unique_ptr<Statement>>& statements) {
+    std::vector<size_t> starts = findFunctionStarts();
+    if (starts.size() < 2 * kFunctionsPerSegment) {
+        return false;
+    }
+    
+    // 第一段从头开始，包含第一个函数之前的顶层声明；每段在某个顶层函数的开头结束
+    std::vector<Segment> segments;
+    for (size_t i = 0; i < starts.size(); i += kFunctionsPerSegment) {
+        Segment segment;
+        segment.begin = segments.empty() ? current_ : starts[i];
+        segment.end = i + kFunctionsPerSegment < starts.size() ? starts[i + kFunctionsPerSegment] : end_;
+        segments.push_back(std::move(segment));
+    }
+    
+    std::unique_ptr<ThreadPool> ownedPool;
+    ThreadPool* pool = pool_;
+    if (!pool) {
+        ownedPool = std::make_unique<ThreadPool>(std::min<unsigned>(jobs_, static_cast<unsigned>(segments.size())));
+        pool = ownedPool.get();
+    }
+    pool->parallelFor(segments.size(), [&](size_t i) {
+        Segment& segment = segments[i];
+        Parser parser(tokens_, segment.begin, segment.end);
+        parser.cancellation_ = cancellation_;
+        parser.parseDeclarations(segment.statements);
+        segment.errors = std::move(parser.errors_);
+        segment.interner = std::move(parser.interner_);
+        segment.crossedEnd = parser.crossedEnd_;
+    });
+    
+    for (const Segment& segment : segments) {
+        if (segment.crossedEnd) {
+            return false;
+        }
+    }
+    
+    // 按段的顺序驻留各段的名字，编号与串行解析按首次出现的顺序分配的相同
+    std::vector<std::vector<Symbol>> remaps(segments.size());
+    for (size_t i = 0; i < segments.size(); ++i) {
+        const StringInterner& local = *segments[i].interner;
+        remaps[i].resize(local.size());
+        for (Symbol symbol = 0; symbol < local.size(); ++symbol) {
+            remaps[i][symbol] = interner_->intern(local.str(symbol));
         }
-    } catch (const ParseError& e) {
-        std::cerr << "Parse error: " << e.what() 
-                  << " at line " << e.getLocation().line 
-                  << ", column " << e.getLocation().column << std::endl;
-        synchronize();
     }
     
-    return std::make_unique<Program>(std::move(statements));
+    pool->parallelFor(segments.size(), [&](size_t i) {
+        SymbolRemapper remapper(remaps[i]);
+        for (auto& stmt : segments[i].statements) {
+            remapper.walk(stmt.get());
+        }
+    });
+    
+    for (Segment& segment : segments) {
+        std::move(segment.statements.begin(), segment.statements.end(), std::back_inserter(statements));
+        for (auto& error : segment.errors) {
+            report(std::move(error));
+        }
+    }
+    current_ = end_;
+    return true;
+}
+
+void Parser::parseReachableBodies(std::vector<std::unique_ptr<Statement>>& statements) {
+    std::unordered_map<std::string, std::vector<size_t>> byName;
+    for (size_t i = 0; i < pendingBodies_.size(); ++i) {
+        byName[pendingBodies_[i].function->getName()].push_back(i);
+    }
+    
+    // 同名函数一起解析，重复定义仍由语义分析报告
+    std::vector<bool> queued(pendingBodies_.size(), false);
+    std::vector<size_t> worklist;
+    auto enqueue = [&](const std::string& name) {
+        auto it = byName.find(name);
+        if (it == byName.end()) {
+            return;
+        }
+        for (size_t index : it->second) {
+            if (!queued[index]) {
+                queued[index] = true;
+                worklist.push_back(index);
+            }
+        }
+    };
+    
+    if (byName.count("main")) {
+        enqueue("main");
+    } else {
+        for (const auto& entry : byName) {
+            enqueue(entry.first);
+        }
+    }
+    
+    // 函数体中嵌套的函数声明（语义分析会报错）照常解析
+    size_t resume = current_;
+    lazyBodies_ = false;
+    while (!worklist.empty()) {
+        throwIfCancelled(cancellation_);
+        PendingBody pending = pendingBodies_[worklist.back()];
+        worklist.pop_back();
+        
+        current_ = pending.begin;
+        expressionDepth_ = 0;
+        try {
+            pending.function->setBody(block());
+        } catch (ParseError& e) {
+            // 与完整解析一样，函数体出错的函数整个丢弃
+            report(std::move(e));
+            continue;
+        }
+        
+        CallCollector collector;
+        collector.walk(pending.function->getBody());
+        for (const std::string* callee : collector.callees) {
+            enqueue(*callee);
+        }
+    }
+    current_ = resume;
+    lazyBodies_ = true;
+    
+    // 删除不可达或解析失败的函数（仍然没有函数体），原型本来就没有函数体，保留
+    std::unordered_set<const Statement*> skipped;
+    for (const PendingBody& pending : pendingBodies_) {
+        if (!pending.function->getBody()) {
+            skipped.insert(pending.function);
+        }
+    }
+    statements.erase(std::remove_if(statements.begin(), statements.end(),
+                                    [&skipped](const std::unique_ptr<Statement>& stmt) {
+                                        return skipped.count(stmt.get()) != 0;
+                                    }),
+                     statements.end());
+    
+    // 函数体按调用关系解析，错误重新按源代码顺序排列
+    std::stable_sort(errors_.begin(), errors_.end(), [](const ParseError& a, const ParseError& b) {
+        SourceLocation left = a.getLocation();
+        SourceLocation right = b.getLocation();
+        return left.line != right.line ? left.line < right.line : left.column < right.column;
+    });
+}
+
+void Parser::skipBlock() {
+    int depth = 1;
+    while (depth > 0) {
+        if (isAtEnd()) {
+            throw error(peek(), "Expect '}' after block.");
+        }
+        TokenType type = advance().getType();
+        if (type == TokenType::LEFT_BRACE) {
+            depth++;
+        } else if (type == TokenType::RIGHT_BRACE) {
+            depth--;
+        }
+    }
+}
+
+std::vector<size_t> Parser::findFunctionStarts() const {
+    std::vector<size_t> starts;
+    int braces = 0;
+    int parens = 0;
+    for (size_t i = current_; i < end_; ++i) {
+        switch (tokens_[i].getType()) {
+            case TokenType::LEFT_BRACE: braces++; break;
+            case TokenType::RIGHT_BRACE: braces--; break;
+            case TokenType::LEFT_PAREN: parens++; break;
+            case TokenType::RIGHT_PAREN: parens--; break;
+            case TokenType::INT:
+            case TokenType::FLOAT:
+            case TokenType::VOID:
+                if (braces == 0 && parens == 0 && i + 2 < end_ &&
+                    tokens_[i + 1].getType() == TokenType::IDENTIFIER &&
+                    tokens_[i + 2].getType() == TokenType::LEFT_PAREN) {
+                    starts.push_back(i);
+                }
+                break;
+            default:
+                break;
+        }
+        if (braces < 0 || parens < 0) {
+            return {};
+        }
+    }
+    if (braces != 0 || parens != 0) {
+        return {};
+    }
+    return starts;
 }
 
 bool Parser::isAtEnd() const {
-    return peek().getType() == TokenType::END_OF_FILE;
+    if (current_ < end_) {
+        return tokens_[current_].getType() == TokenType::END_OF_FILE;
+    }
+    // 分段解析到达段边界：串行解析在这里会继续查看下一段的标记
+    if (tokens_[current_].getType() != TokenType::END_OF_FILE) {
+        crossedEnd_ = true;
+    }
+    return true;
 }
 
 const Token& Parser::peek() const {
@@ -35,7 +361,7 @@ const Token& Parser::previous() const {
     return tokens_[current_ - 1];
 }
 
-Token Parser::advance() {
+const Token& Parser::advance() {
     if (!isAtEnd()) {
         current_++;
     }
@@ -57,16 +383,7 @@ bool Parser::match(TokenType type) {
     return false;
 }
 
-bool Parser::match(std::initializer_list<TokenType> types) {
-    for (TokenType type : types) {
-        if (match(type)) {
-            return true;
-        }
-    }
-    return false;
-}
-
-Token Parser::consume(TokenType type, const std::string& message) {
+const Token& Parser::consume(TokenType type, const std::string& message) {
     if (check(type)) {
         return advance();
     }
@@ -75,32 +392,27 @@ Token Parser::consume(TokenType type, const std::string& message) {
 }
 
 std::unique_ptr<Statement> Parser::declaration() {
-    try {
-        if (match(TokenType::INT) || match(TokenType::FLOAT)) {
-            // 检查是否是函数声明
-            if (check(TokenType::IDENTIFIER) && 
-                tokens_[current_ + 1].getType() == TokenType::LEFT_PAREN) {
-                return functionDeclaration();
-            } else {
-                return varDeclaration();
-            }
-        }
-        
-        if (match(TokenType::VOID)) {
+    if (match(TokenType::INT) || match(TokenType::FLOAT)) {
+        // 检查是否是函数声明
+        if (check(TokenType::IDENTIFIER) && 
+            tokens_[current_ + 1].getType() == TokenType::LEFT_PAREN) {
             return functionDeclaration();
+        } else {
+            return varDeclaration();
         }
-        
-        return statement();
-    } catch (const ParseError& e) {
-        synchronize();
-        return nullptr;
     }
+    
+    if (match(TokenType::VOID)) {
+        return functionDeclaration();
+    }
+    
+    return statement();
 }
 
 std::unique_ptr<Statement> Parser::varDeclaration() {
     std::string type = previous().getLexeme();
     
-    Token name = consume(TokenType::IDENTIFIER, "Expect variable name.");
+    const Token& name = consume(TokenType::IDENTIFIER, "Expect variable name.");
     
     std::unique_ptr<Expression> initializer = nullptr;
     if (match(TokenType::ASSIGN)) {
@@ -109,22 +421,24 @@ std::unique_ptr<Statement> Parser::varDeclaration() {
     
     consume(TokenType::SEMICOLON, "Expect ';' after variable declaration.");
     
-    return std::make_unique<VarDeclaration>(
+    auto declaration = std::make_unique<VarDeclaration>(
         type, name.getLexeme(), std::move(initializer), name.getLocation());
+    declaration->setSymbol(interner_->intern(name.getLexeme()));
+    return declaration;
 }
 
 std::unique_ptr<FunctionDeclaration> Parser::functionDeclaration() {
     std::string returnType = previous().getLexeme();
     
-    Token name = consume(TokenType::IDENTIFIER, "Expect function name.");
+    const Token& name = consume(TokenType::IDENTIFIER, "Expect function name.");
     
     consume(TokenType::LEFT_PAREN, "Expect '(' after function name.");
     
     std::vector<FunctionParameter> parameters;
     if (!check(TokenType::RIGHT_PAREN)) {
         do {
-            if (parameters.size() >= 255) {
-                error(peek(), "Cannot have more than 255 parameters.");
+            if (parameters.size() == 255) {
+                report(error(peek(), "Cannot have more than 255 parameters."));
             }
             
             std::string paramType;
@@ -136,15 +450,33 @@ std::unique_ptr<FunctionDeclaration> Parser::functionDeclaration() {
                 throw error(peek(), "Expect parameter type.");
             }
             
-            Token paramName = consume(TokenType::IDENTIFIER, "Expect parameter name.");
+            const Token& paramName = consume(TokenType::IDENTIFIER, "Expect parameter name.");
             
             parameters.emplace_back(paramType, paramName.getLexeme(), paramName.getLocation());
+            parameters.back().symbol = interner_->intern(paramName.getLexeme());
         } while (match(TokenType::COMMA));
     }
     
     consume(TokenType::RIGHT_PAREN, "Expect ')' after parameters.");
     
+    // 函数原型：只有签名，定义在本文件后面或者在链接的其它模块中
+    if (match(TokenType::SEMICOLON)) {
+        return std::make_unique<FunctionDeclaration>(
+            returnType, name.getLexeme(), std::move(parameters), nullptr, name.getLocation());
+    }
+    
     consume(TokenType::LEFT_BRACE, "Expect '{' before function body.");
+    
+    if (lazyBodies_) {
+        // 只记下函数体的位置，可达时再解析
+        size_t begin = current_;
+        skipBlock();
+        auto function = std::make_unique<FunctionDeclaration>(
+            returnType, name.getLexeme(), std::move(parameters), nullptr, name.getLocation());
+        pendingBodies_.push_back(PendingBody{function.get(), begin});
+        return function;
+    }
+    
     std::unique_ptr<BlockStatement> body = block();
     
     return std::make_unique<FunctionDeclaration>(
@@ -205,7 +537,7 @@ std::unique_ptr<Statement> Parser::whileStatement() {
 }
 
 std::unique_ptr<Statement> Parser::returnStatement() {
-    Token keyword = previous();
+    const Token& keyword = previous();
     std::unique_ptr<Expression> value = nullptr;
     
     if (!check(TokenType::SEMICOLON)) {
@@ -222,7 +554,18 @@ std::unique_ptr<BlockStatement> Parser::block() {
     SourceLocation location = previous().getLocation();
     
     while (!check(TokenType::RIGHT_BRACE) && !isAtEnd()) {
-        statements.push_back(declaration());
+        size_t start = current_;
+        try {
+            statements.push_back(declaration());
+        } catch (ParseError& e) {
+            // 出错的语句整个丢弃，块中其余语句照常解析
+            report(std::move(e));
+            expressionDepth_ = 0;
+            if (current_ == start) {
+                advance();
+            }
+            synchronize();
+        }
     }
     
     consume(TokenType::RIGHT_BRACE, "Expect '}' after block.");
@@ -231,113 +574,83 @@ std::unique_ptr<BlockStatement> Parser::block() {
 }
 
 std::unique_ptr<Expression> Parser::expression() {
-    return assignment();
+    // 出错时异常直接抛到语句级的恢复点，在那里把深度清零
+    if (expressionDepth_ >= kMaxExpressionDepth) {
+        throw error(peek(), "Expression nested too deeply.");
+    }
+    expressionDepth_++;
+    std::unique_ptr<Expression> expr = assignment();
+    expressionDepth_--;
+    return expr;
 }
 
 std::unique_ptr<Expression> Parser::assignment() {
-    std::unique_ptr<Expression> expr = logicalOr();
+    std::unique_ptr<Expression> expr = binary(1);
     
     if (match(TokenType::ASSIGN)) {
-        Token equals = previous();
-        std::unique_ptr<Expression> value = assignment();
+        const Token& equals = previous();
+        // 右结合，经过expression()计入嵌套深度
+        int height = expressionHeight_;
+        std::unique_ptr<Expression> value = expression();
         
-        if (auto* varExpr = dynamic_cast<VariableExpression*>(expr.get())) {
+        if (isa<VariableExpression>(expr.get())) {
+            checkExpressionHeight(std::max(height, expressionHeight_) + 1);
             return std::make_unique<BinaryExpression>(
                 std::move(expr), TokenType::ASSIGN, std::move(value), equals.getLocation());
         }
         
-        error(equals, "Invalid assignment target.");
+        // 不需要恢复，报告后保留左侧表达式继续解析
+        report(error(equals, "Invalid assignment target."));
+        expressionHeight_ = height;
     }
     
     return expr;
 }
 
-std::unique_ptr<Expression> Parser::logicalOr() {
-    std::unique_ptr<Expression> expr = logicalAnd();
-    
-    while (match(TokenType::OR)) {
-        Token op = previous();
-        std::unique_ptr<Expression> right = logicalAnd();
-        expr = std::make_unique<BinaryExpression>(
-            std::move(expr), op.getType(), std::move(right), op.getLocation());
+void Parser::checkExpressionHeight(int height) {
+    expressionHeight_ = height;
+    if (height > kMaxExpressionDepth) {
+        throw error(peek(), "Expression nested too deeply.");
     }
-    
-    return expr;
-}
-
-std::unique_ptr<Expression> Parser::logicalAnd() {
-    std::unique_ptr<Expression> expr = equality();
-    
-    while (match(TokenType::AND)) {
-        Token op = previous();
-        std::unique_ptr<Expression> right = equality();
-        expr = std::make_unique<BinaryExpression>(
-            std::move(expr), op.getType(), std::move(right), op.getLocation());
-    }
-    
-    return expr;
 }
 
-std::unique_ptr<Expression> Parser::equality() {
-    std::unique_ptr<Expression> expr = comparison();
-    
-    while (match({TokenType::EQUAL, TokenType::NOT_EQUAL})) {
-        Token op = previous();
-        std::unique_ptr<Expression> right = comparison();
-        expr = std::make_unique<BinaryExpression>(
-            std::move(expr), op.getType(), std::move(right), op.getLocation());
-    }
-    
-    return expr;
-}
-
-std::unique_ptr<Expression> Parser::comparison() {
-    std::unique_ptr<Expression> expr = term();
-    
-    while (match({TokenType::LESS, TokenType::LESS_EQUAL, TokenType::GREATER, TokenType::GREATER_EQUAL})) {
-        Token op = previous();
-        std::unique_ptr<Expression> right = term();
-        expr = std::make_unique<BinaryExpression>(
-            std::move(expr), op.getType(), std::move(right), op.getLocation());
-    }
-    
-    return expr;
-}
-
-std::unique_ptr<Expression> Parser::term() {
-    std::unique_ptr<Expression> expr = factor();
-    
-    while (match({TokenType::PLUS, TokenType::MINUS})) {
-        Token op = previous();
-        std::unique_ptr<Expression> right = factor();
-        expr = std::make_unique<BinaryExpression>(
-            std::move(expr), op.getType(), std::move(right), op.getLocation());
-    }
-    
-    return expr;
-}
-
-std::unique_ptr<Expression> Parser::factor() {
+std::unique_ptr<Expression> Parser::binary(int minPrecedence) {
     std::unique_ptr<Expression> expr = unary();
+    int height = expressionHeight_;
     
-    while (match({TokenType::MULTIPLY, TokenType::DIVIDE, TokenType::MODULO})) {
-        Token op = previous();
-        std::unique_ptr<Expression> right = unary();
-        expr = std::make_unique<BinaryExpression>(
-            std::move(expr), op.getType(), std::move(right), op.getLocation());
+    while (true) {
+        TokenType op = peek().getType();
+        int precedence = precedenceOf(op);
+        if (precedence < minPrecedence) {
+            expressionHeight_ = height;
+            return expr;
+        }
+        SourceLocation location = advance().getLocation();
+        
+        // 所有运算符都是左结合的，右操作数只吸收优先级更高的运算符；
+        // 长运算符链不递归解析，但每个运算符都让左侧的树加深一层
+        std::unique_ptr<Expression> right = binary(precedence + 1);
+        checkExpressionHeight(std::max(height, expressionHeight_) + 1);
+        height = expressionHeight_;
+        expr = std::make_unique<BinaryExpression>(std::move(expr), op, std::move(right), location);
     }
-    
-    return expr;
 }
 
 std::unique_ptr<Expression> Parser::unary() {
-    if (match({TokenType::MINUS, TokenType::NOT})) {
-        Token op = previous();
-        std::unique_ptr<Expression> right = unary();
-        return std::make_unique<UnaryExpression>(op.getType(), std::move(right), op.getLocation());
+    // 前缀运算符循环跳过，解析完操作数后从最内层开始包装，不为每个运算符递归
+    size_t first = current_;
+    while (check(TokenType::MINUS) || check(TokenType::NOT)) {
+        advance();
     }
+    size_t last = current_;
     
-    return call();
+    std::unique_ptr<Expression> expr = call();
+    checkExpressionHeight(expressionHeight_ + static_cast<int>(last - first));
+    for (size_t i = last; i > first; --i) {
+        const Token& op = tokens_[i - 1];
+        expr = std::make_unique<UnaryExpression>(op.getType(), std::move(expr), op.getLocation());
+    }
+    return expr;
 }
 
 std::unique_ptr<Expression> Parser::call() {
@@ -356,20 +669,23 @@ std::unique_ptr<Expression> Parser::call() {
 
 std::unique_ptr<Expression> Parser::finishCall(std::unique_ptr<Expression> callee) {
     std::vector<std::unique_ptr<Expression>> arguments;
+    int height = 0;
     
     if (!check(TokenType::RIGHT_PAREN)) {
         do {
-            if (arguments.size() >= 255) {
-                error(peek(), "Cannot have more than 255 arguments.");
+            if (arguments.size() == 255) {
+                report(error(peek(), "Cannot have more than 255 arguments."));
             }
             arguments.push_back(expression());
+            height = std::max(height, expressionHeight_);
         } while (match(TokenType::COMMA));
     }
     
-    Token paren = consume(TokenType::RIGHT_PAREN, "Expect ')' after arguments.");
+    const Token& paren = consume(TokenType::RIGHT_PAREN, "Expect ')' after arguments.");
+    checkExpressionHeight(height + 1);
     
     // 只支持变量作为函数调用
-    if (auto* varExpr = dynamic_cast<VariableExpression*>(callee.get())) {
+    if (auto* varExpr = dynCast<VariableExpression>(callee.get())) {
         return std::make_unique<CallExpression>(
             varExpr->getName(), std::move(arguments), paren.getLocation());
     }
@@ -379,21 +695,38 @@ std::unique_ptr<Expression> Parser::finishCall(std::unique_ptr<Expression> calle
 
 std::unique_ptr<Expression> Parser::primary() {
     if (match(TokenType::INTEGER_LITERAL)) {
-        int value = std::stoi(previous().getLexeme());
+        // from_chars不抛异常，超出int范围的字面量按语法错误报告，错误恢复照常进行
+        const std::string& lexeme = previous().getLexeme();
+        int value = 0;
+        auto [end, ec] = std::from_chars(lexeme.data(), lexeme.data() + lexeme.size(), value);
+        if (ec != std::errc() || end != lexeme.data() + lexeme.size()) {
+            throw error(previous(), "Integer literal out of range.");
+        }
+        expressionHeight_ = 1;
         return std::make_unique<IntegerLiteral>(value, previous().getLocation());
     }
     
     if (match(TokenType::FLOAT_LITERAL)) {
-        float value = std::stof(previous().getLexeme());
+        const std::string& lexeme = previous().getLexeme();
+        float value = 0.0f;
+        auto [end, ec] = std::from_chars(lexeme.data(), lexeme.data() + lexeme.size(), value);
+        if (ec != std::errc() || end != lexeme.data() + lexeme.size()) {
+            throw error(previous(), "Float literal out of range.");
+        }
+        expressionHeight_ = 1;
         return std::make_unique<FloatLiteral>(value, previous().getLocation());
     }
     
     if (match(TokenType::STRING_LITERAL)) {
+        expressionHeight_ = 1;
         return std::make_unique<StringLiteral>(previous().getLexeme(), previous().getLocation());
     }
     
     if (match(TokenType::IDENTIFIER)) {
-        return std::make_unique<VariableExpression>(previous().getLexeme(), previous().getLocation());
+        auto variable = std::make_unique<VariableExpression>(previous().getLexeme(), previous().getLocation());
+        variable->setSymbol(interner_->intern(previous().getLexeme()));
+        expressionHeight_ = 1;
+        return variable;
     }
     
     if (match(TokenType::LEFT_PAREN)) {
@@ -406,19 +739,20 @@ std::unique_ptr<Expression> Parser::primary() {
 }
 
 void Parser::synchronize() {
-    advance();
-    
     while (!isAtEnd()) {
-        if (previous().getType() == TokenType::SEMICOLON) {
+        if (current_ > 0 && previous().getType() == TokenType::SEMICOLON) {
             return;
         }
         
         switch (peek().getType()) {
             case TokenType::INT:
             case TokenType::FLOAT:
+            case TokenType::VOID:
             case TokenType::IF:
             case TokenType::WHILE:
             case TokenType::RETURN:
+            case TokenType::LEFT_BRACE:
+            case TokenType::RIGHT_BRACE:
                 return;
             default:
                 break;
@@ -428,6 +762,49 @@ void Parser::synchronize() {
     }
 }
 
+void Parser::synchronizeDeclaration() {
+    // 出错位置可能在函数头中，函数体里的类型关键字不能作为恢复点
+    int depth = 0;
+    while (true) {
+        // 段边界是花括号之外的类型关键字，串行解析也会停在这里
+        if (current_ >= end_ && depth == 0 && isTypeKeyword(peek().getType())) {
+            return;
+        }
+        if (isAtEnd()) {
+            return;
+        }
+        switch (peek().getType()) {
+            case TokenType::LEFT_BRACE:
+                depth++;
+                break;
+            case TokenType::RIGHT_BRACE:
+                depth = depth > 0 ? depth - 1 : 0;
+                break;
+            case TokenType::INT:
+            case TokenType::FLOAT:
+            case TokenType::VOID:
+                if (depth == 0) {
+                    return;
+                }
+                break;
+            default:
+                break;
+        }
+        advance();
+    }
+}
+
+void Parser::report(ParseError error) {
+    // 未闭合的块在文件末尾会被每一层嵌套各报告一次，同一位置只保留第一个错误
+    if (!errors_.empty()) {
+        SourceLocation last = errors_.back().getLocation();
+        if (last.line == error.getLocation().line && last.column == error.getLocation().column) {
+            return;
+        }
+    }
+    errors_.push_back(std::move(error));
+}
+
 ParseError Parser::error(const std::string& message) {
     return error(peek(), message);
 }
@@ -0,0 +1,128 @@
+#include "runtime/runtime.h"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include "runtime/format.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace minicompiler {
+
+namespace {
+
+// 每个线程的输出缓冲区大小
+constexpr size_t kBufferSize = 64 * 1024;
+
+std::atomic<int> outputFd{1};
+
+/**
+ * @brief 把整块数据写到输出，处理部分写入和被信号中断
+ */
+void writeAll(const char* data, size_t size) {
+    int fd = outputFd.load(std::memory_order_relaxed);
+    while (size > 0) {
+#ifdef _WIN32
+        long written = _write(fd, data, static_cast<unsigned>(size));
+#else
+        ssize_t written = ::write(fd, data, size);
+#endif
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // 输出已经关闭（如管道的读端退出），丢弃剩余内容
+            return;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+/**
+ * @brief 线程的输出缓冲区，线程结束时写出剩余内容
+ */
+class OutputBuffer {
+public:
+    OutputBuffer() : data_(new char[kBufferSize]) {}
+
+    ~OutputBuffer() { flush(); }
+
+    /**
+     * @brief 保证缓冲区至少还有size个字节，不够时先写出
+     * @return 可以写入的位置
+     */
+    char* reserve(size_t size) {
+        if (kBufferSize - size_ < size) {
+            flush();
+        }
+        return data_.get() + size_;
+    }
+
+    /**
+     * @brief 提交reserve之后写入的内容
+     * @param end 写入的最后一个字符之后的位置
+     */
+    void commit(const char* end) { size_ = static_cast<size_t>(end - data_.get()); }
+
+    void append(const char* text, size_t length) {
+        if (length >= kBufferSize) {
+            // 超过缓冲区的字符串直接写出，不再拷贝
+            flush();
+            writeAll(text, length);
+            return;
+        }
+        char* out = reserve(length);
+        std::memcpy(out, text, length);
+        commit(out + length);
+    }
+
+    void flush() {
+        writeAll(data_.get(), size_);
+        size_ = 0;
+    }
+
+private:
+    std::unique_ptr<char[]> data_;
+    size_t size_ = 0;
+};
+
+thread_local OutputBuffer threadBuffer;
+
+} // namespace
+
+} // namespace minicompiler
+
+using minicompiler::threadBuffer;
+
+extern "C" void mc_print_i32(int32_t value) {
+    char* out = threadBuffer.reserve(minicompiler::kMaxIntChars + 1);
+    out = minicompiler::formatInt(value, out);
+    *out++ = '\n';
+    threadBuffer.commit(out);
+}
+
+extern "C" void mc_print_f32(float value) {
+    char* out = threadBuffer.reserve(minicompiler::kMaxFloatChars + 1);
+    out = minicompiler::formatFloat(value, out);
+    *out++ = '\n';
+    threadBuffer.commit(out);
+}
+
+extern "C" void mc_print_str(const char* text, size_t length) {
+    threadBuffer.append(text, length);
+    threadBuffer.append("\n", 1);
+}
+
+extern "C" void mc_flush(void) {
+    threadBuffer.flush();
+}
+
+extern "C" void mc_set_output_fd(int fd) {
+    threadBuffer.flush();
+    minicompiler::outputFd.store(fd, std::memory_order_relaxed);
+}
@@ -0,0 +1,432 @@
+#include "semantic/semantic_analyzer.h"
+#include <algorithm>
+#include <iterator>
+#include "ast/ast_walker.h"
+#include "common/scoped_symbol_table.h"
+#include "common/thread_pool.h"
+
+namespace minicompiler {
+
+namespace {
+
+// 每个并行任务至少检查的函数数，函数太少时线程调度的开销比检查本身还大
+constexpr size_t kFunctionsPerTask = 32;
+
+ValueType typeFromString(const std::string& name) {
+    if (name == "int") {
+        return ValueType::INT;
+    } else if (name == "float") {
+        return ValueType::FLOAT;
+    } else if (name == "void") {
+        return ValueType::VOID;
+    }
+    return ValueType::ERROR;
+}
+
+bool isNumeric(ValueType type) {
+    return type == ValueType::INT || type == ValueType::FLOAT;
+}
+
+const char* operatorSpelling(TokenType op) {
+    switch (op) {
+        case TokenType::PLUS: return "+";
+        case TokenType::MINUS: return "-";
+        case TokenType::MULTIPLY: return "*";
+        case TokenType::DIVIDE: return "/";
+        case TokenType::MODULO: return "%";
+        case TokenType::ASSIGN: return "=";
+        case TokenType::EQUAL: return "==";
+        case TokenType::NOT_EQUAL: return "!=";
+        case TokenType::LESS: return "<";
+        case TokenType::LESS_EQUAL: return "<=";
+        case TokenType::GREATER: return ">";
+        case TokenType::GREATER_EQUAL: return ">=";
+        case TokenType::AND: return "&&";
+        case TokenType::OR: return "||";
+        case TokenType::NOT: return "!";
+        default: return "?";
+    }
+}
+
+/**
+ * @brief 检查一个函数体
+ *
+ * 每个线程一个实例，符号表和错误输出都不共享；签名表和驻留表只读。
+ */
+class FunctionChecker : public ASTWalker<FunctionChecker> {
+public:
+    using ASTWalker<FunctionChecker>::visit;
+
+    FunctionChecker(const SemanticAnalyzer& analyzer, const StringInterner* interner)
+        : analyzer_(analyzer), interner_(interner), base_(interner ? interner->size() : 0) {}
+
+    /**
+     * @brief 检查函数体，错误追加到errors
+     */
+    void check(FunctionDeclaration* function, std::vector<SemanticError>& errors) {
+        function_ = function;
+        returnType_ = typeFromString(function->getReturnType());
+        errors_ = &errors;
+
+        // 参数与函数体最外层语句同属一个作用域，和C一致
+        symbols_.clear();
+        symbols_.pushScope();
+        for (const auto& param : function->getParameters()) {
+            declare(param.symbol, param.name, typeFromString(param.type), param.location);
+        }
+        for (const auto& stmt : function->getBody()->getStatements()) {
+            if (stmt) {
+                walk(stmt.get());
+            }
+        }
+        symbols_.popScope();
+    }
+
+    void visit(ExpressionStatement* node) {
+        typeOf(node->getExpression());
+    }
+
+    void visit(VarDeclaration* node) {
+        ValueType type = typeFromString(node->getType());
+        // 与IRBuilder一致，先声明再求初始值
+        declare(node->getSymbol(), node->getName(), type, node->getLocation());
+        if (node->getInitializer()) {
+            convert(typeOf(node->getInitializer()), type, node->getInitializer()->getLocation(),
+                    "initialization of '" + node->getName() + "'");
+        }
+    }
+
+    void visit(BlockStatement* node) {
+        symbols_.pushScope();
+        for (const auto& stmt : node->getStatements()) {
+            if (stmt) {
+                walk(stmt.get());
+            }
+        }
+        symbols_.popScope();
+    }
+
+    void visit(IfStatement* node) {
+        condition(node->getCondition());
+        walk(node->getThenBranch());
+        if (node->getElseBranch()) {
+            walk(node->getElseBranch());
+        }
+    }
+
+    void visit(WhileStatement* node) {
+        condition(node->getCondition());
+        walk(node->getBody());
+    }
+
+    void visit(ReturnStatement* node) {
+        const std::string& name = function_->getName();
+        if (!node->getValue()) {
+            if (returnType_ != ValueType::VOID && returnType_ != ValueType::ERROR) {
+                error("Non-void function '" + name + "' should return a value", node->getLocation());
+            }
+            return;
+        }
+
+        ValueType type = typeOf(node->getValue());
+        if (returnType_ == ValueType::VOID) {
+            error("Void function '" + name + "' should not return a value", node->getLocation());
+            return;
+        }
+        convert(type, returnType_, node->getValue()->getLocation(), "return from '" + name + "'");
+    }
+
+    void visit(FunctionDeclaration* node) {
+        error("Function '" + node->getName() + "' must be declared at top level", node->getLocation());
+    }
+
+private:
+    const SemanticAnalyzer& analyzer_;
+    const StringInterner* interner_;
+
+    // AST中没有驻留编号的名字（手工构造的AST）在本地驻留，编号排在共享驻留表之后
+    StringInterner local_;
+    Symbol base_;
+
+    ScopedSymbolTable<ValueType> symbols_;
+    FunctionDeclaration* function_ = nullptr;
+    ValueType returnType_ = ValueType::VOID;
+    std::vector<SemanticError>* errors_ = nullptr;
+
+    void error(std::string message, SourceLocation location) {
+        errors_->push_back(SemanticError{std::move(message), location});
+    }
+
+    Symbol symbolFor(Symbol symbol, const std::string& name) {
+        if (symbol != kNoSymbol) {
+            return symbol;
+        }
+        if (interner_) {
+            Symbol shared = interner_->find(name);
+            if (shared != kNoSymbol) {
+                return shared;
+            }
+        }
+        return base_ + local_.intern(name);
+    }
+
+    void declare(Symbol symbol, const std::string& name, ValueType type, SourceLocation location) {
+        symbol = symbolFor(symbol, name);
+        if (symbols_.isDeclaredInCurrentScope(symbol)) {
+            error("Redeclaration of '" + name + "'", location);
+        }
+        symbols_.declare(symbol, type);
+    }
+
+    /**
+     * @brief 检查from能否隐式转换为to，int与float之间可以互相转换
+     */
+    void convert(ValueType from, ValueType to, SourceLocation location, const std::string& context) {
+        if (from == to || from == ValueType::ERROR || to == ValueType::ERROR) {
+            return;
+        }
+        if (isNumeric(from) && isNumeric(to)) {
+            return;
+        }
+        error(std::string("Cannot convert '") + valueTypeName(from) + "' to '" + valueTypeName(to) +
+                  "' in " + context,
+              location);
+    }
+
+    void condition(Expression* expr) {
+        ValueType type = typeOf(expr);
+        if (!isNumeric(type) && type != ValueType::ERROR) {
+            error(std::string("Condition has type '") + valueTypeName(type) + "'", expr->getLocation());
+        }
+    }
+
+    /**
+     * @brief 运算符的操作数必须是数值
+     */
+    bool operand(ValueType type, TokenType op, SourceLocation location) {
+        if (isNumeric(type)) {
+            return true;
+        }
+        if (type != ValueType::ERROR) {
+            error(std::string("Invalid operand of type '") + valueTypeName(type) + "' to operator '" +
+                      operatorSpelling(op) + "'",
+                  location);
+        }
+        return false;
+    }
+
+    /**
+     * @brief 计算表达式的类型并记录在节点上
+     */
+    ValueType typeOf(Expression* expr) {
+        ValueType type = resolve(expr);
+        expr->setType(type);
+        return type;
+    }
+
+    ValueType resolve(Expression* expr) {
+        switch (expr->getKind()) {
+            case ASTNodeKind::IntegerLiteral:
+                return ValueType::INT;
+            case ASTNodeKind::FloatLiteral:
+                return ValueType::FLOAT;
+            case ASTNodeKind::StringLiteral:
+                return ValueType::STRING;
+            case ASTNodeKind::VariableExpression: {
+                auto* variable = static_cast<VariableExpression*>(expr);
+                if (const ValueType* type = symbols_.lookup(symbolFor(variable->getSymbol(), variable->getName()))) {
+                    return *type;
+                }
+                error("Undeclared variable '" + variable->getName() + "'", variable->getLocation());
+                return ValueType::ERROR;
+            }
+            case ASTNodeKind::BinaryExpression:
+                return binaryType(static_cast<BinaryExpression*>(expr));
+            case ASTNodeKind::UnaryExpression: {
+                auto* unary = static_cast<UnaryExpression*>(expr);
+                ValueType type = typeOf(unary->getOperand());
+                if (!operand(type, unary->getOperator(), unary->getLocation())) {
+                    return ValueType::ERROR;
+                }
+                return unary->getOperator() == TokenType::NOT ? ValueType::INT : type;
+            }
+            case ASTNodeKind::CallExpression:
+                return callType(static_cast<CallExpression*>(expr));
+            default:
+                return ValueType::ERROR;
+        }
+    }
+
+    ValueType binaryType(BinaryExpression* node) {
+        TokenType op = node->getOperator();
+
+        if (op == TokenType::ASSIGN) {
+            ValueType value = typeOf(node->getRight());
+            auto* target = dynCast<VariableExpression>(node->getLeft());
+            if (!target) {
+                error("Invalid assignment target", node->getLeft()->getLocation());
+                return ValueType::ERROR;
+            }
+            ValueType type = typeOf(target);
+            convert(value, type, node->getRight()->getLocation(), "assignment to '" + target->getName() + "'");
+            return type;
+        }
+
+        ValueType left = typeOf(node->getLeft());
+        ValueType right = typeOf(node->getRight());
+        bool ok = operand(left, op, node->getLeft()->getLocation());
+        ok = operand(right, op, node->getRight()->getLocation()) && ok;
+        if (!ok) {
+            return ValueType::ERROR;
+        }
+
+        switch (op) {
+            case TokenType::PLUS:
+            case TokenType::MINUS:
+            case TokenType::MULTIPLY:
+            case TokenType::DIVIDE:
+                // 混合运算时int隐式转换为float
+                return left == ValueType::FLOAT || right == ValueType::FLOAT ? ValueType::FLOAT : ValueType::INT;
+            case TokenType::MODULO:
+                if (left != ValueType::INT || right != ValueType::INT) {
+                    error("Operator '%' requires int operands", node->getLocation());
+                    return ValueType::ERROR;
+                }
+                return ValueType::INT;
+            default:
+                // 比较和逻辑运算的结果为0或1
+                return ValueType::INT;
+        }
+    }
+
+    ValueType callType(CallExpression* node) {
+        const std::string& name = node->getCallee();
+        const auto& arguments = node->getArguments();
+        const FunctionSignature* signature = analyzer_.findFunction(name);
+
+        if (!signature) {
+            bool builtin = name == "print";
+            if (!builtin) {
+                error("Call to undeclared function '" + name + "'", node->getLocation());
+            }
+            // print接受任意个数的int、float或字符串参数
+            for (const auto& arg : arguments) {
+                ValueType type = typeOf(arg.get());
+                if (builtin && type == ValueType::VOID) {
+                    error("Cannot print a value of type 'void'", arg->getLocation());
+                }
+            }
+            return builtin ? ValueType::VOID : ValueType::ERROR;
+        }
+
+        const auto& parameters = signature->parameterTypes;
+        if (arguments.size() != parameters.size()) {
+            error("Function '" + name + "' expects " + std::to_string(parameters.size()) + " argument" +
+                      (parameters.size() == 1 ? "" : "s") + ", got " + std::to_string(arguments.size()),
+                  node->getLocation());
+        }
+        for (size_t i = 0; i < arguments.size(); ++i) {
+            ValueType type = typeOf(arguments[i].get());
+            if (i < parameters.size()) {
+                convert(type, parameters[i], arguments[i]->getLocation(),
+                        "argument " + std::to_string(i + 1) + " of '" + name + "'");
+            }
+        }
+        return signature->returnType;
+    }
+};
+
+} // namespace
+
+bool SemanticAnalyzer::analyze(Program* program) {
+    errors_.clear();
+    functions_.clear();
+
+    // 每条顶层语句一组错误，最后按顺序合并，结果与并行度无关
+    const auto& statements = program->getStatements();
+    std::vector<std::vector<SemanticError>> errors(statements.size());
+    std::vector<size_t> bodies;
+
+    // 第一步：串行收集签名
+    for (size_t i = 0; i < statements.size(); ++i) {
+        Statement* stmt = statements[i].get();
+        if (!stmt) {
+            continue;
+        }
+        if (auto* function = dynCast<FunctionDeclaration>(stmt)) {
+            declareFunction(function, errors[i]);
+            if (function->getBody()) {
+                bodies.push_back(i);
+            }
+        } else if (auto* variable = dynCast<VarDeclaration>(stmt)) {
+            errors[i].push_back({"Global variable '" + variable->getName() + "' is not supported",
+                                 variable->getLocation()});
+        } else {
+            errors[i].push_back({"Statement outside of a function", stmt->getLocation()});
+        }
+    }
+
+    // 第二步：按连续分区并行检查函数体
+    const StringInterner* interner = program->getInterner().get();
+    size_t partitions = std::min<size_t>(std::max(jobs_, 1u),
+                                         (bodies.size() + kFunctionsPerTask - 1) / kFunctionsPerTask);
+    auto checkPartition = [&](size_t partition) {
+        FunctionChecker checker(*this, interner);
+        size_t begin = bodies.size() * partition / partitions;
+        size_t end = bodies.size() * (partition + 1) / partitions;
+        for (size_t i = begin; i < end; ++i) {
+            size_t index = bodies[i];
+            checker.check(static_cast<FunctionDeclaration*>(statements[index].get()), errors[index]);
+        }
+    };
+
+    if (partitions <= 1) {
+        partitions = 1;
+        checkPartition(0);
+    } else if (pool_) {
+        pool_->parallelFor(partitions, checkPartition);
+    } else {
+        ThreadPool pool(static_cast<unsigned>(partitions));
+        pool.parallelFor(partitions, checkPartition);
+    }
+
+    for (auto& group : errors) {
+        std::move(group.begin(), group.end(), std::back_inserter(errors_));
+    }
+    return errors_.empty();
+}
+
+const FunctionSignature* SemanticAnalyzer::findFunction(const std::string& name) const {
+    auto it = functions_.find(name);
+    return it != functions_.end() ? &it->second : nullptr;
+}
+
+void SemanticAnalyzer::declareFunction(const FunctionDeclaration* function, std::vector<SemanticError>& errors) {
+    FunctionSignature signature{typeFromString(function->getReturnType()), {}, function, function->getBody() != nullptr};
+    for (const auto& param : function->getParameters()) {
+        ValueType type = typeFromString(param.type);
+        if (!isNumeric(type)) {
+            errors.push_back({"Parameter '" + param.name + "' has invalid type '" + param.type + "'", param.location});
+        }
+        signature.parameterTypes.push_back(type);
+    }
+
+    auto inserted = functions_.emplace(function->getName(), signature);
+    if (inserted.second) {
+        return;
+    }
+
+    // 原型与定义可以多次出现，但签名必须一致且只能定义一次
+    FunctionSignature& existing = inserted.first->second;
+    if (existing.returnType != signature.returnType || existing.parameterTypes != signature.parameterTypes) {
+        errors.push_back({"Conflicting declaration of function '" + function->getName() + "'",
+                          function->getLocation()});
+    } else if (existing.defined && signature.defined) {
+        errors.push_back({"Redefinition of function '" + function->getName() + "'", function->getLocation()});
+    } else if (signature.defined) {
+        existing.declaration = function;
+        existing.defined = true;
+    }
+}
+
+} // namespace minicompiler
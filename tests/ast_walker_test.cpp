@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "ast/ast_walker.h"
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+
+using namespace minicompiler;
+
+namespace {
+
+std::unique_ptr<Program> parse(const std::string& source) {
+    Lexer lexer(source);
+    Parser parser(lexer.scanTokens());
+    return parser.parse();
+}
+
+/**
+ * @brief 只处理调用表达式，其余节点走默认遍历
+ */
+class CallCollector : public ASTWalker<CallCollector> {
+public:
+    using ASTWalker<CallCollector>::visit;
+
+    std::vector<std::string> callees;
+
+    void visit(CallExpression* node) {
+        callees.push_back(node->getCallee());
+        ASTWalker<CallCollector>::visit(node);
+    }
+};
+
+/**
+ * @brief 覆盖walk，按遍历顺序记录每个节点的种类
+ */
+class KindRecorder : public ASTWalker<KindRecorder> {
+public:
+    std::vector<ASTNodeKind> kinds;
+
+    void walk(ASTNode* node) {
+        kinds.push_back(node->getKind());
+        ASTWalker<KindRecorder>::walk(node);
+    }
+};
+
+} // namespace
+
+TEST(ASTWalkerTest, NodeKindsAndCasts) {
+    auto program = parse("int x = 1 + 2;");
+    ASSERT_NE(nullptr, program);
+    ASSERT_EQ(1, program->getStatements().size());
+
+    ASTNode* decl = program->getStatements()[0].get();
+    EXPECT_EQ(ASTNodeKind::VarDeclaration, decl->getKind());
+    EXPECT_TRUE(isa<Statement>(decl));
+    EXPECT_FALSE(isa<Expression>(decl));
+    EXPECT_EQ(nullptr, dynCast<BinaryExpression>(decl));
+
+    auto* varDecl = dynCast<VarDeclaration>(decl);
+    ASSERT_NE(nullptr, varDecl);
+    auto* sum = dynCast<BinaryExpression>(varDecl->getInitializer());
+    ASSERT_NE(nullptr, sum);
+    EXPECT_TRUE(isa<Expression>(sum));
+    EXPECT_FALSE(isa<Literal>(sum));
+    EXPECT_TRUE(isa<Literal>(sum->getLeft()));
+    EXPECT_TRUE(isa<IntegerLiteral>(sum->getRight()));
+    EXPECT_FALSE(isa<Statement>(sum->getRight()));
+    EXPECT_FALSE(isa<IntegerLiteral>(static_cast<ASTNode*>(nullptr)));
+}
+
+TEST(ASTWalkerTest, DefaultTraversalReachesNestedNodes) {
+    auto program = parse(
+        "int f(int a) { return a; }\n"
+        "int main() {\n"
+        "    int i = 0;\n"
+        "    while (i < 3) {\n"
+        "        if (i == 1) { f(f(i)); } else { i = g(i); }\n"
+        "        i = i + 1;\n"
+        "    }\n"
+        "    return f(-i);\n"
+        "}\n");
+    ASSERT_NE(nullptr, program);
+
+    CallCollector collector;
+    collector.walk(program.get());
+    EXPECT_EQ((std::vector<std::string>{"f", "f", "g", "f"}), collector.callees);
+}
+
+TEST(ASTWalkerTest, WalkHookSeesNodesInPreOrder) {
+    auto program = parse("int x = -(1 * y);");
+    ASSERT_NE(nullptr, program);
+
+    KindRecorder recorder;
+    recorder.walk(program.get());
+    EXPECT_EQ((std::vector<ASTNodeKind>{
+                  ASTNodeKind::Program,
+                  ASTNodeKind::VarDeclaration,
+                  ASTNodeKind::UnaryExpression,
+                  ASTNodeKind::BinaryExpression,
+                  ASTNodeKind::IntegerLiteral,
+                  ASTNodeKind::VariableExpression,
+              }),
+              recorder.kinds);
+}
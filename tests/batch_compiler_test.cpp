@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "common/json.h"
+#include "driver/batch_compiler.h"
+
+using namespace minicompiler;
+
+namespace {
+
+/**
+ * @brief 生成批量编译的输入：有效程序之间夹着语法错误、语义错误和格式错误的记录
+ */
+std::string makeInput() {
+    std::string input;
+    for (int i = 0; i < 12; ++i) {
+        std::string source = "int main() { return " + std::to_string(i) + " * 2; }\n";
+        if (i % 4 == 1) {
+            source = "int main() { return " + std::to_string(i) + " +; }";
+        } else if (i % 4 == 2) {
+            source = "int main() { return missing; }";
+        }
+        input += "{\"name\": \"p" + std::to_string(i) + ".mc\", \"source\": " + jsonQuote(source) +
+                 ", \"flags\": [\"-O1\", \"--emit-ir\"]}\n";
+        if (i == 5) {
+            input += "\n{\"name\": \"bad\", \"flags\": [\"--emit-ir\"]}\n";
+        }
+    }
+    return input;
+}
+
+std::vector<std::string> runBatch(const std::string& input, unsigned jobs, bool ordered, size_t& failures) {
+    BatchOptions options;
+    options.jobs = jobs;
+    options.ordered = ordered;
+    std::istringstream in(input);
+    std::ostringstream out;
+    failures = BatchCompiler(options).run(in, out);
+
+    std::vector<std::string> lines;
+    std::istringstream results(out.str());
+    for (std::string line; std::getline(results, line);) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+} // namespace
+
+TEST(BatchCompilerTest, CompilesEveryRecord) {
+    size_t failures = 0;
+    std::vector<std::string> lines = runBatch(makeInput(), 1, true, failures);
+    ASSERT_EQ(13u, lines.size());
+    EXPECT_EQ(7u, failures);
+
+    JsonValue first = JsonValue::parse(lines[0]);
+    EXPECT_EQ(0, first.find("index")->asNumber());
+    EXPECT_EQ("p0.mc", first.find("name")->asString());
+    EXPECT_TRUE(first.find("success")->asBool());
+    EXPECT_NE(std::string::npos, first.find("ir")->asString().find("define i32 @main"));
+
+    JsonValue parseError = JsonValue::parse(lines[1]);
+    EXPECT_FALSE(parseError.find("success")->asBool());
+    EXPECT_EQ(nullptr, parseError.find("ir"));
+    ASSERT_EQ(1u, parseError.find("diagnostics")->asArray().size());
+    EXPECT_EQ(0u, parseError.find("diagnostics")->asArray()[0].asString().find("Parse error: "));
+
+    JsonValue semanticError = JsonValue::parse(lines[2]);
+    EXPECT_EQ("Semantic error: Undeclared variable 'missing' at line 1, column 21",
+              semanticError.find("diagnostics")->asArray()[0].asString());
+
+    // 空行不计序号，缺少source的记录单独失败
+    JsonValue bad = JsonValue::parse(lines[6]);
+    EXPECT_EQ(6, bad.find("index")->asNumber());
+    EXPECT_EQ("Error: Record has no 'source' string", bad.find("diagnostics")->asArray()[0].asString());
+    EXPECT_TRUE(JsonValue::parse(lines[8]).find("success")->asBool());
+}
+
+TEST(BatchCompilerTest, ParallelOutputMatchesSerial) {
+    size_t serialFailures = 0;
+    size_t parallelFailures = 0;
+    std::vector<std::string> serial = runBatch(makeInput(), 1, true, serialFailures);
+    EXPECT_EQ(serial, runBatch(makeInput(), 3, true, parallelFailures));
+    EXPECT_EQ(serialFailures, parallelFailures);
+
+    // 无序输出包含同样的结果行
+    std::vector<std::string> unordered = runBatch(makeInput(), 3, false, parallelFailures);
+    std::sort(serial.begin(), serial.end());
+    std::sort(unordered.begin(), unordered.end());
+    EXPECT_EQ(serial, unordered);
+}
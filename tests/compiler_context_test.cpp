@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include <future>
+#include <memory>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include "driver/compiler_context.h"
+#include "ir/ir_interpreter.h"
+
+using namespace minicompiler;
+
+TEST(CompilerContextTest, RepeatedCompilesReuseState) {
+    const std::string source = "int square(int x) { return x * x; }\n"
+                               "int main() { print(square(7)); return square(3); }\n";
+
+    CompilerContext context(2);
+    CompileOptions options;
+    options.emitIR = true;
+
+    CompileResult first = context.compile(source, options);
+    ASSERT_TRUE(first.success);
+    EXPECT_TRUE(first.diagnostics.empty());
+    ASSERT_NE(nullptr, first.module);
+    EXPECT_NE(std::string::npos, first.ir.find("define i32 @square"));
+
+    // 出错的编译不影响之后的编译
+    CompileResult broken = context.compile("int main() { return y +; }\n", options);
+    EXPECT_FALSE(broken.success);
+    EXPECT_EQ(nullptr, broken.module);
+    ASSERT_EQ(1, broken.diagnostics.size());
+    EXPECT_EQ("Parse error: Error at ';': Expect expression. at line 1, column 24",
+              broken.diagnostics[0].toString());
+
+    CompileResult undeclared = context.compile("int main() { return y; }\n", options);
+    ASSERT_EQ(1, undeclared.diagnostics.size());
+    EXPECT_EQ("Semantic error", undeclared.diagnostics[0].kind);
+
+    CompileResult again = context.compile(source, options);
+    ASSERT_TRUE(again.success);
+    EXPECT_EQ(first.ir, again.ir);
+    EXPECT_EQ(4u, context.getCompileCount());
+
+    options.optimizationLevel = 2;
+    options.emitIR = false;
+    CompileResult optimized = context.compile(source, options);
+    ASSERT_TRUE(optimized.success);
+    EXPECT_TRUE(optimized.ir.empty());
+    std::ostringstream output;
+    IRInterpreter interpreter(optimized.module, output);
+    EXPECT_EQ(9, interpreter.run("main"));
+    EXPECT_EQ("49\n", output.str());
+}
+
+TEST(CompilerContextTest, CompilesIRText) {
+    CompilerContext context(1);
+    CompileOptions options;
+    options.emitIR = true;
+    CompileResult source = context.compile("int main() { return 42; }\n", options);
+    ASSERT_TRUE(source.success);
+
+    // 以ModuleID注释开头的输入按IR文本解析
+    CompileResult reparsed = context.compile(source.ir, options);
+    ASSERT_TRUE(reparsed.success);
+    EXPECT_EQ(source.ir, reparsed.ir);
+}
+
+namespace {
+
+/**
+ * @brief 输出到某一行进度时取消编译，用来确定性地在指定阶段取消
+ */
+class CancelOnProgress : public std::streambuf {
+public:
+    CancelOnProgress(CancellationToken& token, std::string trigger)
+        : token_(token), trigger_(std::move(trigger)) {}
+
+protected:
+    int overflow(int c) override {
+        if (c == '\n') {
+            if (line_.find(trigger_) != std::string::npos) {
+                token_.cancel();
+            }
+            line_.clear();
+        } else if (c != EOF) {
+            line_ += static_cast<char>(c);
+        }
+        return c;
+    }
+
+private:
+    CancellationToken& token_;
+    std::string trigger_;
+    std::string line_;
+};
+
+} // namespace
+
+TEST(CompilerContextTest, CancellationStopsAtPhaseBoundaries) {
+    std::string source;
+    for (int i = 0; i < 100; ++i) {
+        source += "int f" + std::to_string(i) + "(int x) { return x + " + std::to_string(i) + "; }\n";
+    }
+    source += "int main() { return f7(1); }\n";
+
+    CompilerContext context(2);
+    CompileOptions options;
+    options.optimizationLevel = 2;
+    options.emitIR = true;
+
+    for (const char* trigger : {"Lexical analysis", "Syntax analysis", "Semantic analysis",
+                                "Generating IR", "Optimizing IR"}) {
+        options.cancellation = std::make_shared<CancellationToken>();
+        CancelOnProgress buffer(*options.cancellation, trigger);
+        std::ostream progress(&buffer);
+        options.progress = &progress;
+
+        CompileResult result = context.compile(source, options);
+        EXPECT_TRUE(result.cancelled) << trigger;
+        EXPECT_FALSE(result.success) << trigger;
+        EXPECT_EQ(nullptr, result.module) << trigger;
+        EXPECT_TRUE(result.diagnostics.empty()) << trigger;
+    }
+
+    // 取消之后上下文照常可用
+    options.cancellation = std::make_shared<CancellationToken>();
+    options.progress = nullptr;
+    CompileResult result = context.compile(source, options);
+    ASSERT_TRUE(result.success);
+    EXPECT_FALSE(result.cancelled);
+    EXPECT_NE(std::string::npos, result.ir.find("define i32 @f99"));
+}
+
+TEST(CompilerContextTest, AsyncCompileAndCancel) {
+    const std::string source = "int main() { return 6 * 7; }\n";
+    CompilerContext context(1);
+    CompileOptions options;
+    options.emitIR = true;
+
+    std::future<CompileResult> future = context.compileAsync(source, options);
+    CompileResult result = future.get();
+    ASSERT_TRUE(result.success);
+    EXPECT_EQ(context.compile(source, options).ir, result.ir);
+
+    // 在开始之前就取消的编译立即返回
+    options.cancellation = std::make_shared<CancellationToken>();
+    options.cancellation->cancel();
+    CompileResult cancelled = context.compileAsync(source, options).get();
+    EXPECT_TRUE(cancelled.cancelled);
+    EXPECT_FALSE(cancelled.success);
+}
@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+#include "ir/ir_builder.h"
+#include "ir/ir_interpreter.h"
+#include "ir/ir_parser.h"
+#include "optimizer/optimizer.h"
+#include "semantic/semantic_analyzer.h"
+
+using namespace minicompiler;
+
+namespace {
+
+std::shared_ptr<IRModule> compile(const std::string& source, int optimizationLevel) {
+    Lexer lexer(source);
+    Parser parser(lexer.scanTokens());
+    auto program = parser.parse();
+
+    IRBuilder builder("test");
+    Optimizer optimizer(optimizationLevel);
+    return optimizer.optimize(builder.build(program.get()));
+}
+
+std::string readFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    std::ostringstream oss;
+    oss << file.rdbuf();
+    return oss.str();
+}
+
+} // namespace
+
+TEST(IRInterpreterTest, ArithmeticBranchesAndCalls) {
+    auto module = compile("int square(int x) {\n"
+                          "    return x * x;\n"
+                          "}\n"
+                          "int main() {\n"
+                          "    int sum = 0;\n"
+                          "    int i = 0;\n"
+                          "    while (i < 5) {\n"
+                          "        if (i % 2 == 0) {\n"
+                          "            sum = sum + square(i);\n"
+                          "        } else {\n"
+                          "            sum = sum - 1;\n"
+                          "        }\n"
+                          "        i = i + 1;\n"
+                          "    }\n"
+                          "    print(sum);\n"
+                          "    return sum / 3;\n"
+                          "}\n", 0);
+
+    std::ostringstream output;
+    IRInterpreter interpreter(module, output);
+
+    // 0 + 4 + 16 - 2 = 18
+    EXPECT_EQ(6, interpreter.run());
+    EXPECT_EQ("18\n", output.str());
+    EXPECT_EQ(4, interpreter.getCallCount());
+    EXPECT_GT(interpreter.getInstructionCount(), 0);
+}
+
+TEST(IRInterpreterTest, ShortCircuitSkipsRightOperand) {
+    auto module = compile("int expensive(int n) {\n"
+                          "    print(n);\n"
+                          "    return n;\n"
+                          "}\n"
+                          "int main() {\n"
+                          "    int n = 0;\n"
+                          "    int hits = 0;\n"
+                          "    if (n > 0 && expensive(n)) {\n"
+                          "        hits = hits + 1;\n"
+                          "    }\n"
+                          "    while (n < 3 && !(n == 1 || expensive(n + 10) == 0)) {\n"
+                          "        n = n + 1;\n"
+                          "    }\n"
+                          "    int a = n == 1 || expensive(7);\n"
+                          "    int b = n > 5 && expensive(8);\n"
+                          "    return hits * 100 + a * 10 + b;\n"
+                          "}\n", 0);
+
+    std::ostringstream output;
+    IRInterpreter interpreter(module, output);
+
+    // 条件里的expensive(n)不执行；循环条件在n == 1时短路退出
+    EXPECT_EQ(10, interpreter.run());
+    EXPECT_EQ("10\n", output.str());
+    EXPECT_EQ(2, interpreter.getCallCount());
+    EXPECT_EQ(std::string::npos, module->toString().find(" and "));
+    EXPECT_EQ(std::string::npos, module->toString().find(" or "));
+}
+
+TEST(IRInterpreterTest, InnerBlockShadowsOuterVariable) {
+    const std::string source = "int f(int x) {\n"
+                               "    int y = x;\n"
+                               "    {\n"
+                               "        int x = 100;\n"
+                               "        y = y + x;\n"
+                               "        while (y < 110) {\n"
+                               "            int x = 5;\n"
+                               "            y = y + x;\n"
+                               "        }\n"
+                               "        x = x - 1;\n"
+                               "        y = y + x;\n"
+                               "    }\n"
+                               "    return y * 1000 + x;\n"
+                               "}\n"
+                               "int main() {\n"
+                               "    return f(3);\n"
+                               "}\n";
+
+    // y = 3 + 100 + 5 + 5 + 99；while体中的x=5不改变块中的x，块外的x仍是参数3
+    for (int level : {0, 2}) {
+        IRInterpreter interpreter(compile(source, level));
+        EXPECT_EQ(212003, interpreter.run()) << "O" << level;
+    }
+    EXPECT_NE(std::string::npos, compile(source, 0)->toString().find("%x.0 = alloca"));
+}
+
+TEST(IRInterpreterTest, ImplicitIntFloatConversions) {
+    const std::string source = "float scale(float x) { return x * 2; }\n"
+                               "int truncate(float x) { return x; }\n"
+                               "int main() {\n"
+                               "    int i = 7;\n"
+                               "    float f = i / 2;\n"
+                               "    float g = i / 2.0;\n"
+                               "    int t = g * 3;\n"
+                               "    i = g;\n"
+                               "    print(f, g, t, i, scale(i), truncate(-g));\n"
+                               "    return t + (f < g);\n"
+                               "}\n";
+
+    // 类型来自语义分析，也可以不经分析直接由IR值的类型推出，两种情况结果相同
+    for (bool analyzed : {true, false}) {
+        Lexer lexer(source);
+        Parser parser(lexer.scanTokens());
+        auto program = parser.parse();
+        if (analyzed) {
+            SemanticAnalyzer analyzer;
+            ASSERT_TRUE(analyzer.analyze(program.get()));
+        }
+        auto module = IRBuilder("test").build(program.get());
+        std::string ir = module->toString();
+        EXPECT_NE(std::string::npos, ir.find("int_to_float")) << ir;
+        EXPECT_NE(std::string::npos, ir.find("float_to_int")) << ir;
+
+        for (int level = 0; level <= 2; ++level) {
+            SCOPED_TRACE("analyzed=" + std::to_string(analyzed) + " -O" + std::to_string(level));
+            std::ostringstream output;
+            IRInterpreter interpreter(Optimizer(level).optimize(IRParser(ir).parse()), output);
+            EXPECT_EQ(11, interpreter.run());
+            EXPECT_EQ("3\n3.5\n10\n3\n6\n-3\n", output.str());
+        }
+    }
+}
+
+TEST(IRInterpreterTest, PrintsStringLiterals) {
+    const std::string source = "int main() {\n"
+                               "    int n = 5;\n"
+                               "    print(\"Factorial of\", n, \"in C:\\tmp, 100%\");\n"
+                               "    print(\"\", -2147483647 - 1, 0.1 + 0.2);\n"
+                               "    return 0;\n"
+                               "}\n";
+
+    for (bool flatten : {false, true}) {
+        Lexer lexer(source);
+        Parser parser(lexer.scanTokens());
+        auto program = parser.parse();
+        SemanticAnalyzer analyzer;
+        ASSERT_TRUE(analyzer.analyze(program.get()));
+        IRBuilder builder("test");
+        builder.setFlattenExpressions(flatten);
+        std::string ir = builder.build(program.get())->toString();
+
+        // 经过IR文本往返后字符串不变
+        std::ostringstream output;
+        IRInterpreter interpreter(Optimizer(1).optimize(IRParser(ir).parse()), output);
+        EXPECT_EQ(0, interpreter.run());
+        EXPECT_EQ("Factorial of\n5\nin C:\\tmp, 100%\n\n-2147483648\n0.3\n", output.str()) << ir;
+    }
+}
+
+TEST(IRInterpreterTest, RuntimeErrors) {
+    IRParser parser("define i32 @main() {\n"
+                    "entry:\n"
+                    "  %t0 = div 1, 0\n"
+                    "  ret %t0\n"
+                    "}\n"
+                    "define i32 @loop() {\n"
+                    "entry:\n"
+                    "  jmp entry:\n"
+                    "}\n"
+                    "define i32 @missing() {\n"
+                    "entry:\n"
+                    "  %t0 = call @nowhere\n"
+                    "  ret %t0\n"
+                    "}\n");
+    auto module = parser.parse();
+
+    IRInterpreter interpreter(module);
+    EXPECT_THROW(interpreter.run(), IRInterpreterError);
+    EXPECT_THROW(interpreter.run("missing"), IRInterpreterError);
+
+    interpreter.setInstructionLimit(1000);
+    EXPECT_THROW(interpreter.run("loop"), IRInterpreterError);
+}
+
+/**
+ * @brief 运行时基准语料在每个优化级别下的输出都必须与期望输出一致
+ */
+TEST(IRInterpreterTest, RuntimeCorpusMatchesExpectedOutput) {
+    size_t kernels = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(MINICOMPILER_RUNTIME_CORPUS_DIR)) {
+        if (entry.path().extension() != ".mc") {
+            continue;
+        }
+        kernels++;
+
+        std::filesystem::path expectedPath = entry.path();
+        expectedPath.replace_extension(".expected");
+        std::string source = readFile(entry.path());
+        std::string expected = readFile(expectedPath);
+
+        for (int level = 0; level <= 2; ++level) {
+            SCOPED_TRACE(entry.path().filename().string() + " -O" + std::to_string(level));
+
+            std::ostringstream output;
+            IRInterpreter interpreter(compile(source, level), output);
+            interpreter.setInstructionLimit(100000000);
+            EXPECT_EQ(0, interpreter.run());
+            EXPECT_EQ(expected, output.str());
+        }
+    }
+
+    EXPECT_GT(kernels, 0);
+}
@@ -0,0 +1,320 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ir/ir.h"
+#include "ir/ir_builder.h"
+#include "ir/ir_interpreter.h"
+#include "ir/ir_parser.h"
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+
+using namespace minicompiler;
+
+TEST(IRParserTest, ParseFunction) {
+    std::string text = "; ModuleID = 'test_module'\n\n"
+                       "define i32 @add(i32 %a, i32 %b) {\n"
+                       "entry:\n"
+                       "  %result = add %a, %b\n"
+                       "  ret %result\n"
+                       "}\n\n";
+
+    IRParser parser(text);
+    auto module = parser.parse();
+
+    ASSERT_NE(nullptr, module);
+    EXPECT_EQ("test_module", module->getName());
+    ASSERT_EQ(1, module->getFunctions().size());
+
+    auto func = module->getFunctions()[0];
+    EXPECT_EQ("add", func->getName());
+    EXPECT_EQ(IRType::INT32, func->getReturnType());
+    ASSERT_EQ(2, func->getParameters().size());
+    ASSERT_EQ(1, func->getBlocks().size());
+    ASSERT_EQ(2, func->getBlocks()[0]->getInstructions().size());
+
+    EXPECT_EQ(text, module->toString());
+}
+
+TEST(IRParserTest, ParseOperands) {
+    std::string text = "define f32 @f(f32 %x) {\n"
+                       "entry:\n"
+                       "  %x = alloca f32\n"
+                       "  store %param.x, %x\n"
+                       "  %t0 = load %x\n"
+                       "  %t1 = mul %t0, 2.500000\n"
+                       "  jmp_if %t1, exit:\n"
+                       "  jmp exit:\n"
+                       "exit:\n"
+                       "  ret %t1\n"
+                       "}\n";
+
+    IRParser parser(text, "m");
+    auto module = parser.parse();
+    auto func = module->getFunctions()[0];
+    ASSERT_EQ(2, func->getBlocks().size());
+
+    const auto& insts = func->getBlocks()[0]->getInstructions();
+    ASSERT_EQ(6, insts.size());
+
+    // 同名标识符在函数内共享同一个对象，类型沿指令推导
+    EXPECT_EQ(insts[0]->getResult(), insts[1]->getOperands()[1]);
+    EXPECT_EQ(IRType::FLOAT32, insts[1]->getOperands()[0]->getType());
+    EXPECT_EQ(IRType::FLOAT32, insts[2]->getResult()->getType());
+    EXPECT_EQ(IRType::FLOAT32, insts[3]->getResult()->getType());
+    EXPECT_EQ(IRType::LABEL, insts[4]->getOperands()[1]->getType());
+}
+
+TEST(IRParserTest, RoundTripBuilderOutput) {
+    Lexer lexer("int square(int x) { return x * x; }\n"
+                "int main() { int a = 3; while (a < 10) { a = a + square(a); } return a; }");
+    auto tokens = lexer.scanTokens();
+
+    Parser parser(tokens);
+    auto ast = parser.parse();
+
+    IRBuilder builder("roundtrip");
+    std::string text = builder.build(ast.get())->toString();
+
+    IRParser irParser(text);
+    EXPECT_EQ(text, irParser.parse()->toString());
+}
+
+TEST(IRParserTest, ReportsErrorLine) {
+    std::string text = "define i32 @f() {\n"
+                       "entry:\n"
+                       "  %t0 = frobnicate 1\n"
+                       "}\n";
+
+    IRParser parser(text);
+    try {
+        parser.parse();
+        FAIL() << "Expected IRParseError";
+    } catch (const IRParseError& e) {
+        EXPECT_EQ(3, e.getLocation().line);
+    }
+}
+
+TEST(IRParserTest, BranchTargetsReferenceBlocks) {
+    std::string text = "define i32 @f(i32 %n) {\n"
+                       "entry:\n"
+                       "  br %param.n, exit:, loop:\n"
+                       "loop:\n"
+                       "  jmp loop:\n"
+                       "exit:\n"
+                       "  ret 0\n"
+                       "}\n";
+
+    IRParser parser(text);
+    auto module = parser.parse();
+    auto func = module->getFunctions()[0];
+    ASSERT_EQ(3, func->getBlocks().size());
+
+    // 向前引用的标签和之后定义的基本块是同一个对象
+    const auto& br = func->getBlocks()[0]->getInstructions()[0];
+    auto* exitLabel = dynamic_cast<IRLabel*>(br->getOperands()[1].get());
+    auto* loopLabel = dynamic_cast<IRLabel*>(br->getOperands()[2].get());
+    ASSERT_NE(nullptr, exitLabel);
+    ASSERT_NE(nullptr, loopLabel);
+    EXPECT_EQ(func->getBlocks()[2].get(), exitLabel->getBlock());
+    EXPECT_EQ(func->getBlocks()[1].get(), loopLabel->getBlock());
+    EXPECT_EQ(loopLabel, func->getBlocks()[1]->getInstructions()[0]->getOperands()[0].get());
+    EXPECT_EQ(text, func->toString());
+
+    IRParser duplicate("define i32 @g() {\n"
+                       "entry:\n"
+                       "  ret 0\n"
+                       "entry:\n"
+                       "  ret 1\n"
+                       "}\n");
+    EXPECT_THROW(duplicate.parse(), IRParseError);
+}
+
+TEST(IRParserTest, StringConstants) {
+    std::string text = "define void @main() {\n"
+                       "entry:\n"
+                       "  call @print, \"a, b\", \"q\\22 \\5C\\0A\", \"\"\n"
+                       "  ret\n"
+                       "}\n";
+
+    IRParser parser(text, "m");
+    auto module = parser.parse();
+    const auto& operands = module->getFunctions()[0]->getBlocks()[0]->getInstructions()[0]->getOperands();
+    ASSERT_EQ(4, operands.size());
+
+    std::vector<std::string> values;
+    for (size_t i = 1; i < operands.size(); ++i) {
+        auto* constant = dynamic_cast<IRStringConstant*>(operands[i].get());
+        ASSERT_NE(nullptr, constant);
+        values.push_back(constant->getValue());
+    }
+    EXPECT_EQ((std::vector<std::string>{"a, b", "q\" \\\n", ""}), values);
+
+    // 重新输出的文本与输入相同
+    EXPECT_NE(std::string::npos, module->toString().find("call @print, \"a, b\", \"q\\22 \\5C\\0A\", \"\""));
+
+    IRParser unterminated("define void @f() {\nentry:\n  call @print, \"abc\n}\n", "m");
+    EXPECT_THROW(unterminated.parse(), IRParseError);
+}
+
+TEST(IRParserTest, NumericConstantEdgeCases) {
+    std::string text = "define f32 @f() {\n"
+                       "entry:\n"
+                       "  %t0 = add -inf, +inf\n"
+                       "  %t1 = add -nan, nan\n"
+                       "  %t2 = add 2147483647, -2147483648\n"
+                       "  ret %t0\n"
+                       "}\n";
+
+    IRParser parser(text, "m");
+    auto module = parser.parse();
+    const auto& insts = module->getFunctions()[0]->getBlocks()[0]->getInstructions();
+
+    auto floatAt = [&](size_t inst, size_t operand) {
+        auto* constant = dynamic_cast<IRFloatConstant*>(insts[inst]->getOperands()[operand].get());
+        EXPECT_NE(nullptr, constant);
+        return constant ? constant->getValue() : 0.0f;
+    };
+    EXPECT_TRUE(std::isinf(floatAt(0, 0)) && std::signbit(floatAt(0, 0)));
+    EXPECT_TRUE(std::isinf(floatAt(0, 1)) && !std::signbit(floatAt(0, 1)));
+    EXPECT_TRUE(std::isnan(floatAt(1, 0)));
+    EXPECT_TRUE(std::isnan(floatAt(1, 1)));
+
+    auto* min = dynamic_cast<IRIntConstant*>(insts[2]->getOperands()[1].get());
+    ASSERT_NE(nullptr, min);
+    EXPECT_EQ(-2147483647 - 1, min->getValue());
+
+    // 超出i32范围的整数常量报错，而不是被截断
+    IRParser overflow("define i32 @g() {\nentry:\n  ret 4294967296\n}\n", "m");
+    EXPECT_THROW(overflow.parse(), IRParseError);
+    IRParser underflow("define i32 @g() {\nentry:\n  ret -2147483649\n}\n", "m");
+    EXPECT_THROW(underflow.parse(), IRParseError);
+    IRParser garbage("define i32 @g() {\nentry:\n  ret -foo\n}\n", "m");
+    EXPECT_THROW(garbage.parse(), IRParseError);
+}
+
+TEST(IRParserTest, RoundTripPreservesResultTypes) {
+    // 被调用函数定义在调用之后或只有原型；float比较的结果是i32
+    Lexer lexer("float scale(float x);\n"
+                "void log(int n) { print(n); }\n"
+                "int main() { float f = half(3) + scale(1.5); log(1);\n"
+                "    int c = f < 2.5; while (half(c) > f) { c = c - 1; } return c; }\n"
+                "float half(int n) { return n / 2.0; }\n");
+    Parser parser(lexer.scanTokens());
+    auto ast = parser.parse();
+    ASSERT_FALSE(parser.hadError());
+
+    IRBuilder builder("types");
+    auto built = builder.build(ast.get());
+    std::string text = built->toString();
+    auto parsed = IRParser(text).parse();
+    EXPECT_EQ(text, parsed->toString());
+
+    ASSERT_EQ(built->getFunctions().size(), parsed->getFunctions().size());
+    size_t calls = 0;
+    size_t compares = 0;
+    for (size_t f = 0; f < built->getFunctions().size(); ++f) {
+        const auto& builtBlocks = built->getFunctions()[f]->getBlocks();
+        const auto& parsedBlocks = parsed->getFunctions()[f]->getBlocks();
+        ASSERT_EQ(builtBlocks.size(), parsedBlocks.size());
+        for (size_t b = 0; b < builtBlocks.size(); ++b) {
+            const auto& expected = builtBlocks[b]->getInstructions();
+            const auto& actual = parsedBlocks[b]->getInstructions();
+            ASSERT_EQ(expected.size(), actual.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                if (!expected[i]->getResult()) {
+                    continue;
+                }
+                IROpcode opcode = expected[i]->getOpcode();
+                calls += opcode == IROpcode::CALL;
+                compares += opcode >= IROpcode::CMP_EQ && opcode <= IROpcode::CMP_GE;
+                EXPECT_EQ(expected[i]->getResult()->getType(), actual[i]->getResult()->getType())
+                    << expected[i]->toString();
+            }
+        }
+    }
+    EXPECT_EQ(5, calls);
+    EXPECT_EQ(2, compares);
+}
+
+TEST(IRParserTest, RoundTripSiblingScopesKeepDistinctSlots) {
+    // 并列语句块中的同名变量类型不同，每个alloca都要有自己的名字
+    Lexer lexer("int main() { int c = 1;\n"
+                "    if (c) { int x = 1; print(x); }\n"
+                "    if (c) { float x = 2.5; print(x + 1.5); }\n"
+                "    while (c) { int x = 3; c = c - x + 2; { float x = 0.5; print(x); } }\n"
+                "    return c; }\n");
+    Parser parser(lexer.scanTokens());
+    auto ast = parser.parse();
+    ASSERT_FALSE(parser.hadError());
+
+    IRBuilder builder("scopes");
+    auto built = builder.build(ast.get());
+
+    std::set<std::string> names;
+    std::vector<IRType> types;
+    for (const auto& block : built->getFunctions()[0]->getBlocks()) {
+        for (const auto& inst : block->getInstructions()) {
+            if (inst->getOpcode() == IROpcode::ALLOCA) {
+                EXPECT_TRUE(names.insert(inst->getResult()->getName()).second) << inst->toString();
+                types.push_back(inst->getResult()->getType());
+            }
+        }
+    }
+    EXPECT_EQ(5, names.size());
+
+    std::string text = built->toString();
+    auto parsed = IRParser(text).parse();
+    EXPECT_EQ(text, parsed->toString());
+
+    std::vector<IRType> parsedTypes;
+    for (const auto& block : parsed->getFunctions()[0]->getBlocks()) {
+        for (const auto& inst : block->getInstructions()) {
+            if (inst->getOpcode() == IROpcode::ALLOCA) {
+                parsedTypes.push_back(inst->getResult()->getType());
+            }
+        }
+    }
+    EXPECT_EQ(types, parsedTypes);
+
+    std::ostringstream expected;
+    std::ostringstream actual;
+    EXPECT_EQ(IRInterpreter(built, expected).run(), IRInterpreter(parsed, actual).run());
+    EXPECT_EQ("1\n4\n0.5\n", expected.str());
+    EXPECT_EQ(expected.str(), actual.str());
+}
+
+TEST(IRParserTest, IdentifierDefinitions) {
+    // 先于定义的引用在定义时确定类型，由它推导的结果随之更新
+    std::string text = "define f32 @f() {\n"
+                       "entry:\n"
+                       "  jmp def:\n"
+                       "use:\n"
+                       "  %t1 = add %t0, 1.500000\n"
+                       "  ret %t1\n"
+                       "def:\n"
+                       "  %t0 = int_to_float 2\n"
+                       "  jmp use:\n"
+                       "}\n";
+    auto module = IRParser(text, "m").parse();
+    EXPECT_EQ(text, module->getFunctions()[0]->toString());
+    const auto& use = module->getFunctions()[0]->getBlocks()[1]->getInstructions();
+    EXPECT_EQ(IRType::FLOAT32, use[0]->getOperands()[0]->getType());
+    EXPECT_EQ(IRType::FLOAT32, use[0]->getResult()->getType());
+
+    // 同一个名字定义两次时报错，而不是让第二个alloca沿用第一个的类型
+    IRParser duplicate("define i32 @g() {\n"
+                       "entry:\n"
+                       "  %x = alloca i32\n"
+                       "  %x = alloca f32\n"
+                       "  ret 0\n"
+                       "}\n", "m");
+    try {
+        duplicate.parse();
+        FAIL() << "Expected IRParseError";
+    } catch (const IRParseError& e) {
+        EXPECT_EQ(4, e.getLocation().line);
+    }
+}
@@ -4,6 +4,7 @@
 #include "ir/ir_builder.h"
 #include "lexer/lexer.h"
 #include "parser/parser.h"
+#include "program_generator.h"
 
 using namespace minicompiler;
 
@@ -154,7 +155,82 @@ TEST(IRTest, IRBuilderSimpleExpression) {
     EXPECT_TRUE(ir.find("ret") != std::string::npos);
 }
 
-int main(int argc, char **argv) {
-    ::testing::InitGoogleTest(&argc, argv);
-    return RUN_ALL_TESTS();
-} 
\ No newline at end of file
+TEST(IRTest, IRBuilderBranchesOnCompare) {
+    Lexer lexer("int main() { int i = 0; while (i < 10) { i = i + 1; } if (i == 10) { i = 0; } return i; }");
+    Parser parser(lexer.scanTokens());
+    auto ast = parser.parse();
+    
+    IRBuilder builder("test");
+    auto module = builder.build(ast.get());
+    auto func = module->getFunctions()[0];
+    
+    // 循环条件：一次比较一次分支，没有多余的jmp
+    std::shared_ptr<IRBasicBlock> cond;
+    for (const auto& block : func->getBlocks()) {
+        if (block->getName().rfind("while.cond", 0) == 0) {
+            cond = block;
+        }
+        EXPECT_EQ(std::string::npos, block->getName().find("else"));
+    }
+    ASSERT_NE(nullptr, cond);
+    ASSERT_EQ(3, cond->getInstructions().size());
+    EXPECT_EQ(IROpcode::CMP_LT, cond->getInstructions()[1]->getOpcode());
+    EXPECT_EQ(IROpcode::BR, cond->getInstructions()[2]->getOpcode());
+    EXPECT_EQ(cond->getInstructions()[1]->getResult(), cond->getInstructions()[2]->getOperands()[0]);
+    EXPECT_EQ(3, cond->getInstructions()[2]->getOperands().size());
+    EXPECT_EQ(std::string::npos, module->toString().find("jmp_if"));
+    
+    // 没有else分支的if不分配else标签，标签编号连续
+    EXPECT_EQ(std::string::npos, module->toString().find("else."));
+    EXPECT_NE(std::string::npos, module->toString().find("endif.4:"));
+}
+
+TEST(IRTest, IRBuilderFlatExpressionsMatchTreeWalk) {
+    std::vector<std::string> sources = {
+        "int g(int a, int b) { return a - b; }\n"
+        "int main() { int x = 1; x = g(g(x, -2), x * 3) + !x;\n"
+        "    while (x > 0 && !(g(x, 1) == 3 || x == 7)) { x = x - 1; }\n"
+        "    int y = x < 2 || g(x, 2) > 0;\n"
+        "    return x + y; }\n",
+    };
+    for (uint64_t seed = 1; seed <= 3; ++seed) {
+        GeneratorOptions options;
+        options.seed = seed;
+        options.functions = 6;
+        sources.push_back(ProgramGenerator(options).generate());
+    }
+    
+    for (const auto& source : sources) {
+        Lexer lexer(source);
+        Parser parser(lexer.scanTokens());
+        auto ast = parser.parse();
+        ASSERT_NE(nullptr, ast);
+        
+        IRBuilder flat("test");
+        IRBuilder tree("test");
+        flat.setFlattenExpressions(true);
+        EXPECT_EQ(tree.build(ast.get())->toString(), flat.build(ast.get())->toString());
+    }
+}
+
+TEST(IRTest, IRModulePrintMatchesToString) {
+    auto module = std::make_shared<IRModule>("stream_module");
+    auto func = std::make_shared<IRFunction>("f", IRType::FLOAT32, std::vector<IRFunctionParameter>{});
+    auto entryBlock = std::make_shared<IRBasicBlock>("entry");
+    
+    auto var = std::make_shared<IRIdentifier>("x", IRType::FLOAT32);
+    entryBlock->addInstruction(std::make_shared<IRInstruction>(IROpcode::ALLOCA, var));
+    entryBlock->addInstruction(std::make_shared<IRInstruction>(
+        IROpcode::STORE, nullptr,
+        std::vector<std::shared_ptr<IRValue>>{std::make_shared<IRFloatConstant>(1.5f), var}));
+    entryBlock->addInstruction(std::make_shared<IRInstruction>(
+        IROpcode::RET, nullptr, std::vector<std::shared_ptr<IRValue>>{var}));
+    
+    func->addBlock(entryBlock);
+    module->addFunction(func);
+    
+    std::ostringstream oss;
+    module->print(oss);
+    EXPECT_EQ(module->toString(), oss.str());
+    EXPECT_NE(std::string::npos, oss.str().find("%x = alloca f32\n  store 1.500000, %x\n"));
+}
@@ -54,7 +54,7 @@ TEST(LexerTest, Operators) {
     Lexer lexer("+ - * / % = == != < <= > >= && ||");
     auto tokens = lexer.scanTokens();
     
-    ASSERT_EQ(14, tokens.size()); // 13 operators + EOF
+    ASSERT_EQ(15, tokens.size()); // 14 operators + EOF
     
     EXPECT_EQ(TokenType::PLUS, tokens[0].getType());
     EXPECT_EQ(TokenType::MINUS, tokens[1].getType());
@@ -69,6 +69,8 @@ TEST(LexerTest, Operators) {
     EXPECT_EQ(TokenType::GREATER, tokens[10].getType());
     EXPECT_EQ(TokenType::GREATER_EQUAL, tokens[11].getType());
     EXPECT_EQ(TokenType::AND, tokens[12].getType());
+    EXPECT_EQ(TokenType::OR, tokens[13].getType());
+    EXPECT_EQ(TokenType::END_OF_FILE, tokens[14].getType());
 }
 
 TEST(LexerTest, Comments) {
@@ -93,8 +95,3 @@ TEST(LexerTest, Comments) {
     EXPECT_EQ("z", tokens[7].getLexeme());
     EXPECT_EQ(TokenType::SEMICOLON, tokens[8].getType());
 }
-
-int main(int argc, char **argv) {
-    ::testing::InitGoogleTest(&argc, argv);
-    return RUN_ALL_TESTS();
-} 
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "driver/compiler_context.h"
+#include "ir/ir.h"
+#include "ir/ir_interpreter.h"
+#include "ir/ir_linker.h"
+#include "ir/ir_parser.h"
+#include "optimizer/optimizer.h"
+
+using namespace minicompiler;
+
+namespace {
+
+std::shared_ptr<IRModule> parseIR(const std::string& text, const std::string& name) {
+    IRParser parser(text, name);
+    return parser.parse();
+}
+
+const char* kHelperModule =
+    "define i32 @twice(i32 %x) {\n"
+    "entry:\n"
+    "  %x = alloca i32\n"
+    "  store %param.x, %x\n"
+    "  %t0 = load %x\n"
+    "  %t1 = add %t0, %t0\n"
+    "  ret %t1\n"
+    "}\n"
+    "define i32 @unused() {\n"
+    "entry:\n"
+    "  ret 7\n"
+    "}\n";
+
+const char* kMainModule =
+    "define i32 @main() {\n"
+    "entry:\n"
+    "  %t0 = call @twice, 21\n"
+    "  ret %t0\n"
+    "}\n";
+
+} // namespace
+
+TEST(OptimizerTest, LinkerRejectsDuplicateFunctions) {
+    IRLinker linker("linked");
+    linker.link(parseIR(kHelperModule, "a"));
+    EXPECT_THROW(linker.link(parseIR(kHelperModule, "b")), std::runtime_error);
+}
+
+TEST(OptimizerTest, MultiFileLinkTimeOptimization) {
+    // 与-c -flto相同：每个文件单独编译为IR对象，再解析、链接并整体优化
+    auto compileObject = [](const std::string& source, const std::string& name) {
+        CompilerContext context(1);
+        CompileOptions options;
+        options.moduleName = name;
+        CompileResult result = context.compile(source, options);
+        EXPECT_TRUE(result.success) << name;
+        return result.module ? parseIR(result.module->toString(), name) : nullptr;
+    };
+
+    auto a = compileObject("int helper(int n);\n"
+                           "int main() { print(helper(20)); return helper(1); }\n",
+                           "a.mc");
+    auto b = compileObject("int helper(int n) { return n * 2 + 1; }\n", "bb.mc");
+    ASSERT_NE(nullptr, a);
+    ASSERT_NE(nullptr, b);
+    ASSERT_EQ(1, a->getDeclarations().size());
+    EXPECT_EQ("helper", a->getDeclarations()[0]->getName());
+
+    IRLinker linker("ab");
+    linker.link(a);
+    linker.link(b);
+    linker.resolve();
+    auto module = linker.getModule();
+    EXPECT_TRUE(module->getDeclarations().empty());
+
+    Optimizer optimizer(1);
+    optimizer.setWholeProgram(true);
+    optimizer.setProgressStream(nullptr);
+    module = optimizer.optimize(module);
+
+    std::ostringstream output;
+    IRInterpreter interpreter(module, output);
+    EXPECT_EQ(3, interpreter.run());
+    EXPECT_EQ("41\n", output.str());
+
+    // 只有声明没有定义的函数在链接时报告
+    IRLinker unresolved("a");
+    unresolved.link(compileObject("int helper(int n);\n"
+                                  "int main() { return helper(1); }\n",
+                                  "a.mc"));
+    EXPECT_THROW(unresolved.resolve(), std::runtime_error);
+
+    // 声明与定义的签名不一致
+    IRLinker conflicting("ab");
+    conflicting.link(compileObject("float helper(int n);\n"
+                                   "int main() { return helper(1); }\n",
+                                   "a.mc"));
+    conflicting.link(b);
+    EXPECT_THROW(conflicting.resolve(), std::runtime_error);
+}
+
+TEST(OptimizerTest, WholeProgramInliningAcrossModules) {
+    IRLinker linker("linked");
+    linker.link(parseIR(kHelperModule, "helpers"));
+    linker.link(parseIR(kMainModule, "main"));
+
+    Optimizer optimizer(1);
+    optimizer.setWholeProgram(true);
+    auto module = optimizer.optimize(linker.getModule());
+
+    // twice被内联进main后不再可达，unused从未被调用，都被删除
+    ASSERT_EQ(1, module->getFunctions().size());
+    auto main = module->getFunctions()[0];
+    EXPECT_EQ("main", main->getName());
+
+    for (const auto& block : main->getBlocks()) {
+        for (const auto& inst : block->getInstructions()) {
+            EXPECT_NE(IROpcode::CALL, inst->getOpcode());
+        }
+    }
+
+    // 实参直接替换形参
+    std::string text = module->toString();
+    EXPECT_NE(std::string::npos, text.find("store 21, %x.i0"));
+}
+
+TEST(OptimizerTest, InlinedAllocasAreHoistedToEntry) {
+    CompilerContext context(1);
+    CompileOptions options;
+    options.moduleName = "loop";
+    CompileResult result = context.compile("int square(int x) { int y = x * x; return y; }\n"
+                                           "int main() { int i = 0; int sum = 0;\n"
+                                           "    while (i < 10) { sum = sum + square(i); i = i + 1; }\n"
+                                           "    return sum; }\n",
+                                           options);
+    ASSERT_TRUE(result.success);
+    auto module = result.module;
+
+    std::ostringstream unoptimizedOutput;
+    int expected = IRInterpreter(module, unoptimizedOutput).run();
+
+    Optimizer optimizer(2);
+    optimizer.setProgressStream(nullptr);
+    module = optimizer.optimize(module);
+    auto main = module->getFunction("main");
+    ASSERT_NE(nullptr, main);
+
+    // 调用点在循环体中，内联出的返回值栈槽和被调用者的局部变量仍然只在入口块分配一次
+    size_t hoisted = 0;
+    bool inlined = false;
+    for (const auto& block : main->getBlocks()) {
+        for (const auto& inst : block->getInstructions()) {
+            EXPECT_NE(IROpcode::CALL, inst->getOpcode());
+            if (inst->getOpcode() != IROpcode::ALLOCA) {
+                continue;
+            }
+            EXPECT_EQ(main->getBlocks().front(), block) << inst->toString();
+            const std::string& name = inst->getResult()->getName();
+            hoisted += name.find(".i") != std::string::npos;
+        }
+        inlined |= block->getName().rfind("square.", 0) == 0;
+    }
+    EXPECT_TRUE(inlined);
+    EXPECT_EQ(3, hoisted);
+
+    std::ostringstream output;
+    EXPECT_EQ(expected, IRInterpreter(module, output).run());
+    EXPECT_EQ(285, expected);
+}
+
+TEST(OptimizerTest, InterproceduralConstantPropagation) {
+    // 递归函数不会被内联，两个调用点都传入常量5
+    auto module = parseIR("define i32 @spin(i32 %n) {\n"
+                          "entry:\n"
+                          "  %n = alloca i32\n"
+                          "  store %param.n, %n\n"
+                          "  %t0 = call @spin, 5\n"
+                          "  ret %t0\n"
+                          "}\n"
+                          "define i32 @main() {\n"
+                          "entry:\n"
+                          "  %t0 = call @spin, 5\n"
+                          "  ret %t0\n"
+                          "}\n", "m");
+
+    Optimizer optimizer(1);
+    optimizer.setWholeProgram(true);
+    optimizer.optimize(module);
+
+    auto spin = module->getFunction("spin");
+    ASSERT_NE(nullptr, spin);
+    EXPECT_EQ("store 5, %n", spin->getBlocks()[0]->getInstructions()[1]->toString());
+}
+
+TEST(OptimizerTest, NoDeadFunctionEliminationWithoutWholeProgram) {
+    auto module = parseIR(std::string(kHelperModule) + kMainModule, "m");
+
+    Optimizer optimizer(1);
+    optimizer.optimize(module);
+
+    EXPECT_EQ(3, module->getFunctions().size());
+}
+
+TEST(OptimizerTest, TimeBudgetSkipsExpensivePasses) {
+    auto link = []() {
+        IRLinker linker("linked");
+        linker.link(parseIR(kHelperModule, "helpers"));
+        linker.link(parseIR(kMainModule, "main"));
+        return linker.getModule();
+    };
+
+    // 截止时间已过：跳过内联和过程间常量传播，死函数消除照常删除unused
+    Optimizer late(2);
+    late.setWholeProgram(true);
+    late.setProgressStream(nullptr);
+    late.setDeadline(std::chrono::steady_clock::now() - std::chrono::seconds(1));
+    auto unoptimized = late.optimize(link());
+    EXPECT_EQ((std::vector<std::string>{"inline", "ipcp"}), late.getSkipped());
+    ASSERT_EQ(2, unoptimized->getFunctions().size());
+    EXPECT_EQ("twice", unoptimized->getFunctions()[0]->getName());
+    EXPECT_EQ("main", unoptimized->getFunctions()[1]->getName());
+    EXPECT_NE(std::string::npos, unoptimized->toString().find("call @twice, 21"));
+
+    // 预算充足时与没有预算的结果相同
+    Optimizer unlimited(2);
+    unlimited.setWholeProgram(true);
+    unlimited.setProgressStream(nullptr);
+    Optimizer budgeted(2);
+    budgeted.setWholeProgram(true);
+    budgeted.setProgressStream(nullptr);
+    budgeted.setDeadline(std::chrono::steady_clock::now() + std::chrono::hours(1));
+    EXPECT_EQ(unlimited.optimize(link())->toString(), budgeted.optimize(link())->toString());
+    EXPECT_TRUE(budgeted.getSkipped().empty());
+}
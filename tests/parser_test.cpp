@@ -1,6 +1,11 @@
 #include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ast/ast_walker.h"
 #include "lexer/lexer.h"
 #include "parser/parser.h"
+#include "program_generator.h"
 
 using namespace minicompiler;
 
@@ -132,7 +137,334 @@ TEST(ParserTest, WhileStatement) {
     ASSERT_EQ(1, body->getStatements().size());
 }
 
-int main(int argc, char **argv) {
-    ::testing::InitGoogleTest(&argc, argv);
-    return RUN_ALL_TESTS();
-} 
\ No newline at end of file
+TEST(ParserTest, RecoversAndReportsEveryError) {
+    Lexer lexer("int f(int a,) { int x = 1; return x; }\n"
+                "int g() {\n"
+                "    int y = ;\n"
+                "    y = 2\n"
+                "    return y;\n"
+                "    1 = y;\n"
+                "    if (y > ) { y = 3; }\n"
+                "    while (y < 10) y = y + 1;\n"
+                "    return y;\n"
+                "}\n"
+                "int h() { return 2; }\n"
+                "int k() { if (1) { return 1;\n");
+    
+    Parser parser(lexer.scanTokens());
+    auto program = parser.parse();
+    
+    std::vector<std::string> errors;
+    for (const auto& error : parser.getErrors()) {
+        errors.push_back(std::to_string(error.getLocation().line) + ": " + error.what());
+    }
+    EXPECT_EQ((std::vector<std::string>{
+                  "1: Error at ')': Expect parameter type.",
+                  "3: Error at ';': Expect expression.",
+                  "5: Error at 'return': Expect ';' after expression.",
+                  "6: Error at '=': Invalid assignment target.",
+                  "7: Error at ')': Expect expression.",
+                  "13: Error at end of file: Expect '}' after block.",
+              }),
+              errors);
+    
+    // 出错的声明和语句被丢弃，其余的照常解析，不留空节点
+    ASSERT_EQ(2, program->getStatements().size());
+    auto* g = dynamic_cast<FunctionDeclaration*>(program->getStatements()[0].get());
+    ASSERT_NE(nullptr, g);
+    EXPECT_EQ("g", g->getName());
+    EXPECT_EQ("h", dynamic_cast<FunctionDeclaration*>(program->getStatements()[1].get())->getName());
+    
+    const auto& body = g->getBody()->getStatements();
+    ASSERT_EQ(5, body.size());
+    for (const auto& stmt : body) {
+        ASSERT_NE(nullptr, stmt);
+    }
+    EXPECT_NE(nullptr, dynamic_cast<BlockStatement*>(body[2].get()));
+    EXPECT_NE(nullptr, dynamic_cast<WhileStatement*>(body[3].get()));
+}
+
+TEST(ParserTest, OutOfRangeLiteralsAreRecoverable) {
+    std::string hugeFloat(400, '9');
+    Lexer lexer("int f() { int x = 99999999999; return x; }\n"
+                "int g() {\n"
+                "    int y = 2147483647;\n"
+                "    float z = " + hugeFloat + ".5;\n"
+                "    y = 1 +;\n"
+                "    return y;\n"
+                "}\n");
+    
+    Parser parser(lexer.scanTokens());
+    auto program = parser.parse();
+    
+    std::vector<std::string> errors;
+    for (const auto& error : parser.getErrors()) {
+        errors.push_back(std::to_string(error.getLocation().line) + ": " + error.what());
+    }
+    EXPECT_EQ((std::vector<std::string>{
+                  "1: Error at '99999999999': Integer literal out of range.",
+                  "4: Error at '" + hugeFloat + ".5': Float literal out of range.",
+                  "5: Error at ';': Expect expression.",
+              }),
+              errors);
+    
+    // 越界字面量所在的语句被丢弃，后面的代码照常解析
+    ASSERT_EQ(2, program->getStatements().size());
+    auto* f = dynamic_cast<FunctionDeclaration*>(program->getStatements()[0].get());
+    auto* g = dynamic_cast<FunctionDeclaration*>(program->getStatements()[1].get());
+    ASSERT_NE(nullptr, f);
+    ASSERT_NE(nullptr, g);
+    EXPECT_EQ(1, f->getBody()->getStatements().size());
+    EXPECT_EQ(2, g->getBody()->getStatements().size());
+}
+
+namespace {
+
+/**
+ * @brief 把表达式打印成全括号形式，便于检查优先级和结合性
+ */
+std::string format(const Expression* expr) {
+    if (auto* literal = dynamic_cast<const IntegerLiteral*>(expr)) {
+        return std::to_string(literal->getValue());
+    }
+    if (auto* variable = dynamic_cast<const VariableExpression*>(expr)) {
+        return variable->getName();
+    }
+    if (auto* unary = dynamic_cast<const UnaryExpression*>(expr)) {
+        return std::string(unary->getOperator() == TokenType::NOT ? "!" : "-") + format(unary->getOperand());
+    }
+    if (auto* binary = dynamic_cast<const BinaryExpression*>(expr)) {
+        static const char* const names[] = {"+", "-", "*", "/", "%", "=", "==", "!=", "<", "<=", ">", ">=", "&&", "||"};
+        int index = static_cast<int>(binary->getOperator()) - static_cast<int>(TokenType::PLUS);
+        return "(" + format(binary->getLeft()) + " " + names[index] + " " + format(binary->getRight()) + ")";
+    }
+    return "?";
+}
+
+/**
+ * @brief 把AST连同位置和符号名输出成文本，用来比较两棵树是否相同
+ */
+class ASTDumper : public ASTWalker<ASTDumper> {
+public:
+    using ASTWalker<ASTDumper>::visit;
+    
+    explicit ASTDumper(const StringInterner& interner) : interner_(interner) {}
+    
+    void walk(ASTNode* node) {
+        out << static_cast<int>(node->getKind()) << "@" << node->getLocation().line
+            << ":" << node->getLocation().column << " ";
+        ASTWalker<ASTDumper>::walk(node);
+    }
+    
+    void visit(VariableExpression* node) {
+        out << interner_.str(node->getSymbol()) << " ";
+    }
+    
+    void visit(VarDeclaration* node) {
+        out << interner_.str(node->getSymbol()) << " ";
+        ASTWalker<ASTDumper>::visit(node);
+    }
+    
+    void visit(BinaryExpression* node) {
+        out << static_cast<int>(node->getOperator()) << " ";
+        ASTWalker<ASTDumper>::visit(node);
+    }
+    
+    void visit(FunctionDeclaration* node) {
+        out << node->getName() << "(";
+        for (const auto& param : node->getParameters()) {
+            out << param.symbol << ":" << interner_.str(param.symbol) << " ";
+        }
+        out << ") ";
+        ASTWalker<ASTDumper>::visit(node);
+    }
+    
+    std::ostringstream out;
+    
+private:
+    const StringInterner& interner_;
+};
+
+/**
+ * @brief 解析源代码，把AST、驻留表和错误输出成文本
+ */
+std::string parseAndDump(const std::string& source, unsigned jobs) {
+    Lexer lexer(source);
+    Parser parser(lexer.scanTokens());
+    parser.setParallelJobs(jobs);
+    auto program = parser.parse();
+    
+    const StringInterner& interner = *program->getInterner();
+    ASTDumper dumper(interner);
+    dumper.walk(program.get());
+    for (Symbol symbol = 0; symbol < interner.size(); ++symbol) {
+        dumper.out << interner.str(symbol) << ",";
+    }
+    for (const auto& error : parser.getErrors()) {
+        dumper.out << "\n" << error.getLocation().line << ":" << error.getLocation().column << " " << error.what();
+    }
+    return dumper.out.str();
+}
+
+} // namespace
+
+TEST(ParserTest, ParallelParsingMatchesSequential) {
+    GeneratorOptions options;
+    options.seed = 7;
+    options.functions = 300;
+    std::string generated = ProgramGenerator(options).generate();
+    EXPECT_EQ(parseAndDump(generated, 1), parseAndDump(generated, 4));
+    
+    // 错误留在各自的函数中：分段结果可以直接合并
+    std::string source;
+    for (int i = 0; i < 200; ++i) {
+        std::string n = std::to_string(i);
+        source += "int f" + n + "(int a" + n + ") {\n";
+        source += i % 7 == 0 ? "    int x = a" + n + " + ;\n" : "    int x = a" + n + " * 2;\n";
+        source += i % 11 == 0 ? "    x = 1\n" : "    x = x + 1;\n";
+        source += "    return x;\n}\n";
+        if (i % 50 == 0) {
+            source += "int g" + n + ";\n";
+        }
+    }
+    std::string sequential = parseAndDump(source, 1);
+    EXPECT_NE(std::string::npos, sequential.find("Expect expression."));
+    EXPECT_EQ(sequential, parseAndDump(source, 4));
+    
+    // 段边界前缺少分号，解析需要查看下一段的标记：退回串行解析，结果仍然相同
+    std::string crossing = source;
+    crossing.replace(crossing.find("int f32("), 0, "int late = 1\n");
+    EXPECT_EQ(parseAndDump(crossing, 1), parseAndDump(crossing, 4));
+    
+    // 花括号不配对时不分段
+    std::string unbalanced = source;
+    unbalanced.replace(unbalanced.find("int f100("), 0, "void h() { if (1) { x = 1; }\n");
+    EXPECT_EQ(parseAndDump(unbalanced, 1), parseAndDump(unbalanced, 4));
+}
+
+TEST(ParserTest, LazyBodiesParseOnlyReachableFunctions) {
+    const std::string source = "int unused(int a) { return a +; }\n"
+                               "int leaf(int a) { return a * 2; }\n"
+                               "int middle(int a) { return leaf(a) + 1; }\n"
+                               "int main() { int x = middle(3); { int y = x; } return x; }\n"
+                               "void dead() { dead(); }\n";
+    
+    Lexer lexer(source);
+    Parser parser(lexer.scanTokens());
+    parser.setLazyFunctionBodies(true);
+    auto program = parser.parse();
+    
+    // unused中的语法错误不会被发现
+    EXPECT_FALSE(parser.hadError());
+    std::vector<std::string> names;
+    for (const auto& stmt : program->getStatements()) {
+        auto* function = dynamic_cast<FunctionDeclaration*>(stmt.get());
+        ASSERT_NE(nullptr, function);
+        ASSERT_NE(nullptr, function->getBody());
+        names.push_back(function->getName());
+    }
+    EXPECT_EQ((std::vector<std::string>{"leaf", "middle", "main"}), names);
+    
+    // 可达函数体中的错误照常报告
+    Lexer broken("int f() { return 1 +; }\nint main() { return f(); }\n");
+    Parser lazy(broken.scanTokens());
+    lazy.setLazyFunctionBodies(true);
+    auto partial = lazy.parse();
+    ASSERT_EQ(1, lazy.getErrors().size());
+    EXPECT_EQ(1, lazy.getErrors()[0].getLocation().line);
+    
+    // 没有main时所有函数都是入口
+    Lexer library("int f() { return 1; }\nint g() { return 2; }\n");
+    Parser all(library.scanTokens());
+    all.setLazyFunctionBodies(true);
+    EXPECT_EQ(2, all.parse()->getStatements().size());
+}
+
+TEST(ParserTest, FunctionPrototypes) {
+    const std::string source = "int helper(int n);\n"
+                               "float scale(float x);\n"
+                               "int main() { return helper(1); }\n";
+    
+    for (bool lazy : {false, true}) {
+        Lexer lexer(source);
+        Parser parser(lexer.scanTokens());
+        parser.setLazyFunctionBodies(lazy);
+        auto program = parser.parse();
+        EXPECT_FALSE(parser.hadError());
+        
+        // 原型没有函数体；按需解析时不可达的原型同样保留
+        ASSERT_EQ(3, program->getStatements().size());
+        auto* helper = dynamic_cast<FunctionDeclaration*>(program->getStatements()[0].get());
+        auto* scale = dynamic_cast<FunctionDeclaration*>(program->getStatements()[1].get());
+        ASSERT_NE(nullptr, helper);
+        ASSERT_NE(nullptr, scale);
+        EXPECT_EQ(nullptr, helper->getBody());
+        EXPECT_EQ(nullptr, scale->getBody());
+        EXPECT_EQ("float", scale->getReturnType());
+        ASSERT_EQ(1, helper->getParameters().size());
+        EXPECT_EQ("n", helper->getParameters()[0].name);
+    }
+}
+
+TEST(ParserTest, OperatorPrecedenceAndAssociativity) {
+    Lexer lexer("x = y = 1 - 2 - 3 * 4 % 5 < 6 == 7 && 8 || !-9 > 0;");
+    Parser parser(lexer.scanTokens());
+    auto program = parser.parse();
+    ASSERT_FALSE(parser.hadError());
+    ASSERT_EQ(1, program->getStatements().size());
+    
+    auto* stmt = dynamic_cast<ExpressionStatement*>(program->getStatements()[0].get());
+    ASSERT_NE(nullptr, stmt);
+    EXPECT_EQ("(x = (y = ((((((1 - 2) - ((3 * 4) % 5)) < 6) == 7) && 8) || (!-9 > 0))))",
+              format(stmt->getExpression()));
+}
+
+TEST(ParserTest, ExpressionNestingLimit) {
+    auto nested = [](int depth) {
+        return "int x = " + std::string(depth, '(') + "1" + std::string(depth, ')') + ";\n";
+    };
+    
+    Lexer shallow(nested(200));
+    Parser ok(shallow.scanTokens());
+    ok.parse();
+    EXPECT_FALSE(ok.hadError());
+    
+    // 超过限制时报告错误并恢复，后面的声明照常解析
+    Lexer deep(nested(100000) + "int y = 2;\n");
+    Parser parser(deep.scanTokens());
+    auto program = parser.parse();
+    ASSERT_EQ(1, parser.getErrors().size());
+    EXPECT_NE(std::string::npos, std::string(parser.getErrors()[0].what()).find("Expression nested too deeply."));
+    ASSERT_EQ(1, program->getStatements().size());
+    EXPECT_EQ("y", dynamic_cast<VarDeclaration*>(program->getStatements()[0].get())->getName());
+    
+    // 长运算符链和前缀运算符链不递归解析，但生成的树同样受高度限制
+    auto chain = [](int terms) {
+        std::string source = "1";
+        for (int i = 1; i < terms; ++i) {
+            source += " + 1";
+        }
+        return source;
+    };
+    auto prefix = [](int depth) {
+        return std::string(depth, '-') + "1";
+    };
+    
+    for (const std::string& expr : {chain(256), prefix(200), "g(" + chain(200) + ", 1)", "(" + prefix(100) + ") * " + chain(100)}) {
+        Lexer lexer("int x = " + expr + ";\n");
+        Parser within(lexer.scanTokens());
+        within.parse();
+        EXPECT_FALSE(within.hadError()) << expr.substr(0, 40);
+    }
+    
+    for (const std::string& expr : {chain(200000), prefix(100000), chain(257), "g(" + prefix(256) + ")",
+                                     "(" + prefix(200) + ") * " + chain(100)}) {
+        Lexer lexer("int x = " + expr + ";\nint y = 2;\n");
+        Parser limited(lexer.scanTokens());
+        auto result = limited.parse();
+        ASSERT_EQ(1, limited.getErrors().size()) << expr.substr(0, 40);
+        EXPECT_NE(std::string::npos, std::string(limited.getErrors()[0].what()).find("Expression nested too deeply."));
+        ASSERT_EQ(1, result->getStatements().size());
+        EXPECT_EQ("y", dynamic_cast<VarDeclaration*>(result->getStatements()[0].get())->getName());
+    }
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include "common/json.h"
+#include "perf_stats.h"
+
+using namespace minicompiler;
+
+TEST(PerfGateTest, ParseJson) {
+    JsonValue value = JsonValue::parse(
+        "{\"name\": \"BM_Lexer/1\", \"times\": [1.5, -2e3, 7], \"ok\": true, "
+        "\"unit\": null, \"escaped\": \"a\\\"b\\u0041\"}");
+
+    ASSERT_TRUE(value.isObject());
+    EXPECT_EQ("BM_Lexer/1", value.find("name")->asString());
+    ASSERT_EQ(3, value.find("times")->asArray().size());
+    EXPECT_DOUBLE_EQ(-2000.0, value.find("times")->asArray()[1].asNumber());
+    EXPECT_TRUE(value.find("ok")->asBool());
+    EXPECT_TRUE(value.find("unit")->isNull());
+    EXPECT_EQ("a\"bA", value.find("escaped")->asString());
+    EXPECT_EQ(nullptr, value.find("missing"));
+
+    EXPECT_THROW(JsonValue::parse("{\"a\": [1, 2}"), JsonError);
+}
+
+TEST(PerfGateTest, MedianAndMannWhitney) {
+    EXPECT_DOUBLE_EQ(3.0, median({5, 1, 3}));
+    EXPECT_DOUBLE_EQ(2.5, median({4, 1, 3, 2}));
+
+    std::vector<double> baseline = {100, 101, 99, 100, 102};
+    std::vector<double> slower = {120, 119, 121, 122, 118};
+    std::vector<double> same = {100, 102, 99, 101, 100};
+
+    EXPECT_LT(mannWhitneyGreater(baseline, slower), 0.01);
+    EXPECT_GT(mannWhitneyGreater(slower, baseline), 0.99);
+    EXPECT_GT(mannWhitneyGreater(baseline, same), 0.2);
+}
+
+TEST(PerfGateTest, CollectSamplesAndBaselineRoundTrip) {
+    JsonValue results = JsonValue::parse(
+        "{\"benchmarks\": ["
+        "{\"name\": \"BM_A\", \"run_name\": \"BM_A\", \"run_type\": \"iteration\", "
+        "\"cpu_time\": 2.0, \"time_unit\": \"us\"},"
+        "{\"name\": \"BM_A\", \"run_name\": \"BM_A\", \"run_type\": \"iteration\", "
+        "\"cpu_time\": 3.0, \"time_unit\": \"us\"},"
+        "{\"name\": \"BM_A_mean\", \"run_name\": \"BM_A\", \"run_type\": \"aggregate\", "
+        "\"cpu_time\": 2.5, \"time_unit\": \"us\"},"
+        "{\"name\": \"BM_B\", \"run_type\": \"iteration\", \"error_occurred\": true, "
+        "\"cpu_time\": 1.0, \"time_unit\": \"ns\"}"
+        "]}");
+
+    BenchmarkSamples samples;
+    collectSamples(results, "cpu_time", samples);
+    ASSERT_EQ(1, samples.size());
+    EXPECT_EQ((std::vector<double>{2000.0, 3000.0}), samples["BM_A"]);
+
+    BenchmarkSamples restored = readBaseline(JsonValue::parse(writeBaseline(samples, "cpu_time")));
+    EXPECT_EQ(samples, restored);
+}
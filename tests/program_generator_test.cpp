@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "program_generator.h"
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+
+using namespace minicompiler;
+
+TEST(ProgramGeneratorTest, SameSeedSameProgram) {
+    GeneratorOptions options;
+    options.seed = 42;
+
+    EXPECT_EQ(ProgramGenerator(options).generate(), ProgramGenerator(options).generate());
+
+    options.seed = 43;
+    GeneratorOptions other;
+    other.seed = 42;
+    EXPECT_NE(ProgramGenerator(options).generate(), ProgramGenerator(other).generate());
+}
+
+TEST(ProgramGeneratorTest, GeneratedProgramParses) {
+    GeneratorOptions options;
+    options.functions = 32;
+    options.maxDepth = 4;
+    options.fanOut = 3;
+    std::string source = ProgramGenerator(options).generate();
+
+    Lexer lexer(source);
+    std::vector<Token> tokens = lexer.scanTokens();
+    for (const auto& token : tokens) {
+        ASSERT_NE(TokenType::UNKNOWN, token.getType());
+    }
+
+    Parser parser(tokens);
+    auto program = parser.parse();
+
+    // 32个函数加上main，解析出错的声明会是空指针
+    ASSERT_EQ(33, program->getStatements().size());
+    for (const auto& stmt : program->getStatements()) {
+        ASSERT_NE(nullptr, stmt);
+    }
+}
+
+TEST(ProgramGeneratorTest, TargetSizeOverridesFunctionCount) {
+    GeneratorOptions options;
+    options.functions = 1;
+    options.targetBytes = 64 * 1024;
+
+    std::ostringstream oss;
+    uint64_t written = ProgramGenerator(options).generate(oss);
+
+    EXPECT_EQ(oss.str().size(), written);
+    EXPECT_GE(written, options.targetBytes);
+    EXPECT_LT(written, options.targetBytes * 2);
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <climits>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "runtime/format.h"
+#include "runtime/runtime.h"
+
+using namespace minicompiler;
+
+namespace {
+
+std::string format(int32_t value) {
+    char text[kMaxIntChars];
+    return std::string(text, formatInt(value, text));
+}
+
+std::string format(float value) {
+    char text[kMaxFloatChars];
+    return std::string(text, formatFloat(value, text));
+}
+
+template <typename T>
+std::string streamFormat(T value) {
+    std::ostringstream oss;
+    oss << value;
+    return oss.str();
+}
+
+/**
+ * @brief 把运行时的输出重定向到临时文件，结束时读回全部内容
+ */
+class CapturedOutput {
+public:
+    CapturedOutput() : file_(std::tmpfile()) { mc_set_output_fd(fileno(file_)); }
+
+    ~CapturedOutput() { std::fclose(file_); }
+
+    std::string finish() {
+        mc_set_output_fd(1);
+        std::string text;
+        std::rewind(file_);
+        char chunk[4096];
+        size_t read;
+        while ((read = std::fread(chunk, 1, sizeof(chunk), file_)) > 0) {
+            text.append(chunk, read);
+        }
+        return text;
+    }
+
+private:
+    std::FILE* file_;
+};
+
+} // namespace
+
+TEST(RuntimeTest, FormatIntMatchesStreams) {
+    for (int32_t value : {0, 1, 9, 10, 99, 100, 101, 999, 1000, 65536, 99999999, 100000000, 123456789,
+                          INT_MAX, -1, -10, -99, -100, -123456789, INT_MIN}) {
+        EXPECT_EQ(streamFormat(value), format(value));
+    }
+    for (int64_t value = -100000; value <= 100000; value += 7) {
+        ASSERT_EQ(streamFormat(value), format(static_cast<int32_t>(value)));
+    }
+}
+
+TEST(RuntimeTest, FormatFloatMatchesStreams) {
+    for (float value : {0.0f, -0.0f, 1.0f, 0.5f, 3.5f, -3.5f, 0.1f, 1.0f / 3.0f, 7.48548f, 100000.0f, 999999.0f,
+                        1000000.0f, 1234567.0f, 1e-5f, 1.5e-7f, 3.4e38f, -1.17549e-38f,
+                        std::numeric_limits<float>::max(), std::numeric_limits<float>::denorm_min(),
+                        std::numeric_limits<float>::lowest(), std::numeric_limits<float>::infinity(),
+                        -std::numeric_limits<float>::infinity()}) {
+        EXPECT_EQ(streamFormat(value), format(value)) << value;
+    }
+    EXPECT_EQ("nan", format(std::numeric_limits<float>::quiet_NaN()));
+}
+
+TEST(RuntimeTest, BufferedPrintFlushesInOrder) {
+    std::string expected;
+    CapturedOutput captured;
+
+    // 超过缓冲区大小，中途至少写出一次
+    for (int i = 0; i < 20000; ++i) {
+        mc_print_i32(i * 37 - 5000);
+        expected += std::to_string(i * 37 - 5000) + "\n";
+        if (i % 1000 == 0) {
+            mc_print_str("step", 4);
+            mc_print_f32(i / 8.0f);
+            expected += "step\n" + streamFormat(i / 8.0f) + "\n";
+        }
+    }
+    std::string large(100000, 'x');
+    mc_print_str(large.data(), large.size());
+    expected += large + "\n";
+
+    // 其它线程的输出在线程结束时写出，先写出本线程缓冲的内容以确定顺序
+    mc_flush();
+    std::thread([]() { mc_print_str("from thread", 11); }).join();
+    expected += "from thread\n";
+
+    mc_print_i32(INT_MIN);
+    expected += "-2147483648\n";
+    mc_flush();
+    EXPECT_EQ(expected, captured.finish());
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "lexer/lexer.h"
+#include "parser/parser.h"
+#include "semantic/semantic_analyzer.h"
+#include "program_generator.h"
+
+using namespace minicompiler;
+
+namespace {
+
+std::unique_ptr<Program> parse(const std::string& source) {
+    Lexer lexer(source);
+    Parser parser(lexer.scanTokens());
+    return parser.parse();
+}
+
+/**
+ * @brief 分析源代码，返回所有错误信息
+ */
+std::vector<std::string> analyze(const std::string& source, unsigned jobs = 1) {
+    auto program = parse(source);
+    SemanticAnalyzer analyzer;
+    analyzer.setParallelJobs(jobs);
+    analyzer.analyze(program.get());
+
+    std::vector<std::string> messages;
+    for (const auto& error : analyzer.getErrors()) {
+        messages.push_back(std::to_string(error.location.line) + ": " + error.message);
+    }
+    return messages;
+}
+
+} // namespace
+
+TEST(SemanticAnalyzerTest, ValidProgramsHaveNoErrors) {
+    EXPECT_TRUE(analyze("float half(int n) { return n / 2.0; }\n"
+                        "int main() {\n"
+                        "    int x = 3;\n"
+                        "    float y = half(x) + x;\n"
+                        "    x = y;\n"
+                        "    { int x = 1; print(x, y, \"done\"); }\n"
+                        "    return later(x) % 2;\n"
+                        "}\n"
+                        "int later(int a) { return a; }\n")
+                    .empty());
+
+    // 运行时基准语料和生成的程序都必须通过检查
+    for (const auto& entry : std::filesystem::directory_iterator(MINICOMPILER_RUNTIME_CORPUS_DIR)) {
+        if (entry.path().extension() != ".mc") {
+            continue;
+        }
+        std::ifstream file(entry.path());
+        std::ostringstream source;
+        source << file.rdbuf();
+        EXPECT_TRUE(analyze(source.str()).empty()) << entry.path();
+    }
+
+    for (uint64_t seed = 1; seed <= 3; ++seed) {
+        GeneratorOptions options;
+        options.seed = seed;
+        options.functions = 80;
+        EXPECT_TRUE(analyze(ProgramGenerator(options).generate(), 4).empty()) << "seed " << seed;
+    }
+}
+
+TEST(SemanticAnalyzerTest, ReportsAllErrorsInSourceOrder) {
+    std::vector<std::string> errors = analyze("int g;\n"
+                                              "void v() { return 1; }\n"
+                                              "int f(int a, int a) {\n"
+                                              "    int b = a;\n"
+                                              "    int b = 2;\n"
+                                              "    { int c = 1; }\n"
+                                              "    c = v();\n"
+                                              "    if (v()) { return; }\n"
+                                              "    return missing(1.5 % 2) + f(1);\n"
+                                              "}\n"
+                                              "int f(int x, int y) { return x; }\n"
+                                              "float f(int x) { return x; }\n");
+
+    EXPECT_EQ((std::vector<std::string>{
+                  "1: Global variable 'g' is not supported",
+                  "2: Void function 'v' should not return a value",
+                  "3: Redeclaration of 'a'",
+                  "5: Redeclaration of 'b'",
+                  "7: Undeclared variable 'c'",
+                  "8: Condition has type 'void'",
+                  "8: Non-void function 'f' should return a value",
+                  "9: Call to undeclared function 'missing'",
+                  "9: Operator '%' requires int operands",
+                  "9: Function 'f' expects 2 arguments, got 1",
+                  "11: Redefinition of function 'f'",
+                  "12: Conflicting declaration of function 'f'",
+              }),
+              errors);
+}
+
+TEST(SemanticAnalyzerTest, PrototypesDeclareExternalFunctions) {
+    // 原型声明的函数可以由其它模块定义，调用按原型检查
+    EXPECT_TRUE(analyze("int helper(int n);\n"
+                        "float scale(float x);\n"
+                        "int main() { print(scale(helper(2))); return helper(1); }\n"
+                        "int helper(int n) { return n; }\n")
+                    .empty());
+
+    EXPECT_EQ((std::vector<std::string>{
+                  "2: Function 'helper' expects 1 argument, got 0",
+                  "3: Conflicting declaration of function 'helper'",
+              }),
+              analyze("int helper(int n);\n"
+                      "int main() { return helper(); }\n"
+                      "float helper(int n) { return n; }\n"));
+}
+
+TEST(SemanticAnalyzerTest, ParallelResultMatchesSerial) {
+    // 每个函数一个错误，分区边界落在函数之间
+    std::string source;
+    for (int i = 0; i < 200; ++i) {
+        source += "int f" + std::to_string(i) + "(int a) {\n";
+        source += i % 3 == 0 ? "    return b" + std::to_string(i) + ";\n" : "    return a;\n";
+        source += "}\n";
+    }
+
+    std::vector<std::string> serial = analyze(source, 1);
+    EXPECT_EQ(67u, serial.size());
+    EXPECT_EQ("2: Undeclared variable 'b0'", serial.front());
+    EXPECT_EQ(serial, analyze(source, 4));
+}
+
+TEST(SemanticAnalyzerTest, RecordsExpressionTypes) {
+    auto program = parse("float half(int n) { return n / 2.0; }\n"
+                         "int main() { int x = half(3) + 1 < 2; return x; }\n");
+    SemanticAnalyzer analyzer;
+    ASSERT_TRUE(analyzer.analyze(program.get()));
+
+    auto* half = dynCast<FunctionDeclaration>(program->getStatements()[0].get());
+    auto* ret = dynCast<ReturnStatement>(half->getBody()->getStatements()[0].get());
+    auto* quotient = dynCast<BinaryExpression>(ret->getValue());
+    EXPECT_EQ(ValueType::FLOAT, quotient->getType());
+    EXPECT_EQ(ValueType::INT, quotient->getLeft()->getType());
+
+    auto* main = dynCast<FunctionDeclaration>(program->getStatements()[1].get());
+    auto* decl = dynCast<VarDeclaration>(main->getBody()->getStatements()[0].get());
+    auto* compare = dynCast<BinaryExpression>(decl->getInitializer());
+    EXPECT_EQ(ValueType::INT, compare->getType());
+    EXPECT_EQ(ValueType::FLOAT, compare->getLeft()->getType());
+    EXPECT_EQ(ValueType::FLOAT, dynCast<BinaryExpression>(compare->getLeft())->getLeft()->getType());
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "common/scoped_symbol_table.h"
+#include "common/string_interner.h"
+
+using namespace minicompiler;
+
+TEST(StringInternerTest, SameTextSameSymbol) {
+    StringInterner interner;
+    Symbol a = interner.intern("alpha");
+    Symbol b = interner.intern("beta");
+    EXPECT_NE(a, b);
+    EXPECT_EQ(a, interner.intern(std::string("alpha")));
+    EXPECT_EQ(b, interner.find("beta"));
+    EXPECT_EQ(kNoSymbol, interner.find("gamma"));
+    EXPECT_EQ("alpha", interner.str(a));
+    EXPECT_EQ(2u, interner.size());
+
+    // 大量追加后早先的编号和字符串不变
+    for (int i = 0; i < 1000; ++i) {
+        interner.intern("v" + std::to_string(i));
+    }
+    EXPECT_EQ(a, interner.find("alpha"));
+    EXPECT_EQ("beta", interner.str(b));
+}
+
+TEST(ScopedSymbolTableTest, ShadowingAndScopeExit) {
+    ScopedSymbolTable<int> table;
+    const Symbol x = 0, y = 1, z = 7;
+
+    table.pushScope();
+    table.declare(x, 1);
+    table.declare(y, 2);
+    EXPECT_TRUE(table.isDeclaredInCurrentScope(x));
+
+    table.pushScope();
+    EXPECT_FALSE(table.isDeclaredInCurrentScope(x));
+    table.declare(x, 10);
+    table.declare(z, 30);
+    ASSERT_NE(nullptr, table.lookup(x));
+    EXPECT_EQ(10, *table.lookup(x));
+    EXPECT_EQ(2, *table.lookup(y));
+    EXPECT_TRUE(table.isDeclaredInCurrentScope(x));
+    EXPECT_EQ(2u, table.depth());
+
+    // 同一作用域重复声明也遮蔽前一个，离开作用域时一并撤销
+    table.declare(x, 11);
+    EXPECT_EQ(11, *table.lookup(x));
+
+    table.popScope();
+    EXPECT_EQ(1, *table.lookup(x));
+    EXPECT_EQ(nullptr, table.lookup(z));
+    EXPECT_EQ(nullptr, table.lookup(100));
+
+    table.clear();
+    EXPECT_EQ(0u, table.depth());
+    EXPECT_EQ(nullptr, table.lookup(x));
+    EXPECT_EQ(nullptr, table.lookup(y));
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "common/perf_counters.h"
+#include "common/time_report.h"
+
+using namespace minicompiler;
+
+TEST(TimeReportTest, AccumulatesPhasesInOrder) {
+    TimeReport report(true);
+    {
+        auto phase = report.phase("Lexical analysis");
+    }
+    {
+        auto phase = report.phase("Syntax analysis");
+    }
+    {
+        auto phase = report.phase("Lexical analysis");
+    }
+
+    std::ostringstream oss;
+    report.print(oss);
+    std::string text = oss.str();
+
+    size_t lexer = text.find("Lexical analysis");
+    size_t parser = text.find("Syntax analysis");
+    ASSERT_NE(std::string::npos, lexer);
+    ASSERT_NE(std::string::npos, parser);
+    EXPECT_LT(lexer, parser);
+    EXPECT_EQ(std::string::npos, text.find("Lexical analysis", lexer + 1));
+    EXPECT_NE(std::string::npos, text.find("Total"));
+}
+
+TEST(TimeReportTest, DisabledReportPrintsNothing) {
+    TimeReport report;
+    {
+        auto phase = report.phase("Optimization");
+    }
+
+    std::ostringstream oss;
+    report.print(oss);
+    EXPECT_TRUE(oss.str().empty());
+}
+
+TEST(TimeReportTest, HardwareCountersDegradeGracefully) {
+    PerfCounters counters;
+    counters.start();
+    volatile int sink = 0;
+    for (int i = 0; i < 100000; ++i) {
+        sink = sink + i;
+    }
+    PerfCounterValues values = counters.stop();
+
+    if (!counters.isAvailable()) {
+        // 容器中没有硬件计数器：没有读数，并给出原因
+        EXPECT_FALSE(counters.getError().empty());
+        for (size_t i = 0; i < kPerfCounterCount; ++i) {
+            EXPECT_FALSE(values.has(static_cast<PerfCounter>(i)));
+        }
+    } else if (values.has(PerfCounter::INSTRUCTIONS)) {
+        EXPECT_GT(values.get(PerfCounter::INSTRUCTIONS), 0);
+    }
+
+    // 计数器不可用时报告仍然完整输出
+    TimeReport report(true, true);
+    {
+        auto phase = report.phase("Code generation");
+    }
+    std::ostringstream oss;
+    report.print(oss);
+    EXPECT_NE(std::string::npos, oss.str().find("Code generation"));
+}
@@ -0,0 +1,126 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+
+#include "program_generator.h"
+#include "common/output_file.h"
+
+using namespace minicompiler;
+
+void printUsage(const char* programName) {
+    std::cerr << "Usage: " << programName << " [options]" << std::endl;
+    std::cerr << "Generate a deterministic synthetic MiniCompiler program." << std::endl;
+    std::cerr << "Options:" << std::endl;
+    std::cerr << "  -o <output_file>     Write to file instead of stdout" << std::endl;
+    std::cerr << "  --seed=<n>           Random seed (default: 1)" << std::endl;
+    std::cerr << "  --functions=<n>      Number of functions besides main (default: 16)" << std::endl;
+    std::cerr << "  --size=<bytes>       Generate functions until the output reaches this size;" << std::endl;
+    std::cerr << "                       accepts K/M/G suffixes and overrides --functions" << std::endl;
+    std::cerr << "  --depth=<n>          Maximum statement nesting depth (default: 3)" << std::endl;
+    std::cerr << "  --loops=<p>          Fraction of nested statements that are loops (default: 0.3)" << std::endl;
+    std::cerr << "  --expr-depth=<n>     Maximum expression tree depth (default: 4)" << std::endl;
+    std::cerr << "  --fan-out=<n>        Maximum callees per function (default: 2)" << std::endl;
+    std::cerr << "  --identifiers=<n>    Local variables per function (default: 8)" << std::endl;
+    std::cerr << "  --statements=<n>     Statements per block (default: 4)" << std::endl;
+    std::cerr << "  -h, --help           Display this help message" << std::endl;
+}
+
+/**
+ * @brief 解析带K/M/G后缀的字节数
+ */
+bool parseSize(const char* text, uint64_t& size) {
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(text, &end, 10);
+    if (end == text) {
+        return false;
+    }
+
+    switch (*end) {
+    case 'K': case 'k': value <<= 10; ++end; break;
+    case 'M': case 'm': value <<= 20; ++end; break;
+    case 'G': case 'g': value <<= 30; ++end; break;
+    default: break;
+    }
+
+    size = value;
+    return *end == '\0';
+}
+
+/**
+ * @brief 如果参数形如<name>=<value>，返回value，否则返回nullptr
+ */
+const char* optionValue(const char* arg, const char* name) {
+    size_t length = strlen(name);
+    if (strncmp(arg, name, length) == 0 && arg[length] == '=') {
+        return arg + length + 1;
+    }
+    return nullptr;
+}
+
+int main(int argc, char* argv[]) {
+    GeneratorOptions options;
+    std::string outputFile;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* value = nullptr;
+        if (strcmp(argv[i], "-o") == 0) {
+            if (i + 1 < argc) {
+                outputFile = argv[++i];
+            } else {
+                std::cerr << "Error: -o option requires an argument" << std::endl;
+                return 1;
+            }
+        } else if ((value = optionValue(argv[i], "--seed"))) {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if ((value = optionValue(argv[i], "--functions"))) {
+            options.functions = std::atoi(value);
+        } else if ((value = optionValue(argv[i], "--size"))) {
+            if (!parseSize(value, options.targetBytes)) {
+                std::cerr << "Error: Invalid size '" << value << "'" << std::endl;
+                return 1;
+            }
+        } else if ((value = optionValue(argv[i], "--depth"))) {
+            options.maxDepth = std::atoi(value);
+        } else if ((value = optionValue(argv[i], "--loops"))) {
+            options.loopDensity = std::atof(value);
+        } else if ((value = optionValue(argv[i], "--expr-depth"))) {
+            options.expressionDepth = std::atoi(value);
+        } else if ((value = optionValue(argv[i], "--fan-out"))) {
+            options.fanOut = std::atoi(value);
+        } else if ((value = optionValue(argv[i], "--identifiers"))) {
+            options.identifiers = std::atoi(value);
+        } else if ((value = optionValue(argv[i], "--statements"))) {
+            options.statementsPerBlock = std::atoi(value);
+        } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else {
+            std::cerr << "Error: Unknown option '" << argv[i] << "'" << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    ProgramGenerator generator(options);
+
+    if (outputFile.empty()) {
+        generator.generate(std::cout);
+        std::cout.flush();
+        return std::cout ? 0 : 1;
+    }
+
+    OutputFile file(outputFile);
+    if (!file.isOpen()) {
+        std::cerr << "Error: Could not open file '" << outputFile << "' for writing" << std::endl;
+        return 1;
+    }
+
+    generator.generate(file.stream());
+    if (!file.close()) {
+        std::cerr << "Error: Failed to write file '" << outputFile << "'" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,262 @@
+#include "program_generator.h"
+#include <algorithm>
+#include <sstream>
+
+namespace minicompiler {
+
+ProgramGenerator::ProgramGenerator(const GeneratorOptions& options)
+    : options_(options), state_(options.seed) {
+    options_.functions = std::max(options_.functions, 0);
+    options_.maxDepth = std::max(options_.maxDepth, 0);
+    options_.expressionDepth = std::max(options_.expressionDepth, 0);
+    options_.fanOut = std::max(options_.fanOut, 0);
+    options_.identifiers = std::max(options_.identifiers, 1);
+    options_.statementsPerBlock = std::max(options_.statementsPerBlock, 1);
+}
+
+uint64_t ProgramGenerator::next() {
+    uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+int ProgramGenerator::range(int low, int high) {
+    return low + static_cast<int>(next() % static_cast<uint64_t>(high - low + 1));
+}
+
+bool ProgramGenerator::chance(double probability) {
+    // 取高53位作为[0, 1)内的均匀分布
+    return static_cast<double>(next() >> 11) * 0x1.0p-53 < probability;
+}
+
+uint64_t ProgramGenerator::generate(std::ostream& os) {
+    uint64_t written = 0;
+    arity_.clear();
+
+    for (int i = 0; options_.targetBytes > 0 ? written < options_.targetBytes : i < options_.functions;
+         ++i) {
+        out_.clear();
+        function(i);
+        os.write(out_.data(), static_cast<std::streamsize>(out_.size()));
+        written += out_.size();
+    }
+
+    // main调用最后一个函数并打印结果
+    out_.clear();
+    out_ += "int main() {\n";
+    if (!arity_.empty()) {
+        size_t last = arity_.size() - 1;
+        out_ += "    int result = f";
+        out_ += std::to_string(last);
+        out_ += "(";
+        for (int i = 0; i < arity_[last]; ++i) {
+            out_ += i == 0 ? "" : ", ";
+            out_ += std::to_string(range(0, 9));
+        }
+        out_ += ");\n    print(result);\n";
+    }
+    out_ += "    return 0;\n}\n";
+    os.write(out_.data(), static_cast<std::streamsize>(out_.size()));
+    written += out_.size();
+
+    return written;
+}
+
+std::string ProgramGenerator::generate() {
+    std::ostringstream oss;
+    generate(oss);
+    return oss.str();
+}
+
+void ProgramGenerator::function(int index) {
+    parameters_ = range(1, 3);
+    arity_.push_back(parameters_);
+
+    // 只调用编号更小的函数，调用图是DAG
+    callees_.clear();
+    int fanOut = std::min(options_.fanOut, index);
+    for (int i = 0; i < fanOut; ++i) {
+        callees_.push_back(range(0, index - 1));
+    }
+
+    out_ += "int f";
+    out_ += std::to_string(index);
+    out_ += "(";
+    for (int i = 0; i < parameters_; ++i) {
+        out_ += i == 0 ? "int p" : ", int p";
+        out_ += std::to_string(i);
+    }
+    out_ += ") {\n";
+
+    for (int i = 0; i < options_.identifiers; ++i) {
+        out_ += "    int v";
+        out_ += std::to_string(i);
+        out_ += " = ";
+        out_ += std::to_string(range(0, 99));
+        out_ += ";\n";
+    }
+
+    // 每层嵌套一个循环计数器，循环体内从不赋值
+    for (int i = 0; i < options_.maxDepth; ++i) {
+        out_ += "    int l";
+        out_ += std::to_string(i);
+        out_ += " = 0;\n";
+    }
+
+    block(0);
+
+    out_ += "    return ";
+    expression(0);
+    out_ += ";\n}\n\n";
+}
+
+void ProgramGenerator::block(int depth) {
+    for (int i = 0; i < options_.statementsPerBlock; ++i) {
+        statement(depth);
+    }
+}
+
+void ProgramGenerator::statement(int depth) {
+    if (depth < options_.maxDepth && chance(0.3)) {
+        if (chance(options_.loopDensity)) {
+            loop(depth);
+        } else {
+            branch(depth);
+        }
+        return;
+    }
+
+    indent(depth);
+    if (!callees_.empty() && chance(0.1)) {
+        call(0);
+    } else {
+        out_ += "v";
+        out_ += std::to_string(range(0, options_.identifiers - 1));
+        out_ += " = ";
+        expression(0);
+    }
+    out_ += ";\n";
+}
+
+void ProgramGenerator::loop(int depth) {
+    std::string counter = "l" + std::to_string(depth);
+
+    indent(depth);
+    out_ += counter;
+    out_ += " = 0;\n";
+    indent(depth);
+    out_ += "while (";
+    out_ += counter;
+    out_ += " < ";
+    out_ += std::to_string(range(2, 8));
+    out_ += ") {\n";
+
+    block(depth + 1);
+
+    indent(depth + 1);
+    out_ += counter;
+    out_ += " = ";
+    out_ += counter;
+    out_ += " + 1;\n";
+    indent(depth);
+    out_ += "}\n";
+}
+
+void ProgramGenerator::branch(int depth) {
+    indent(depth);
+    out_ += "if (";
+    condition(0);
+    out_ += ") {\n";
+    block(depth + 1);
+    indent(depth);
+
+    if (chance(0.5)) {
+        out_ += "} else {\n";
+        block(depth + 1);
+        indent(depth);
+    }
+    out_ += "}\n";
+}
+
+void ProgramGenerator::condition(int depth) {
+    static const char* comparisons[] = {" < ", " <= ", " > ", " >= ", " == ", " != "};
+
+    expression(depth + 1);
+    out_ += comparisons[range(0, 5)];
+    expression(depth + 1);
+
+    if (depth < options_.expressionDepth && chance(0.25)) {
+        out_ += chance(0.5) ? " && " : " || ";
+        condition(depth + 1);
+    }
+}
+
+void ProgramGenerator::expression(int depth) {
+    if (depth >= options_.expressionDepth || chance(0.3)) {
+        int kind = range(0, 9);
+        if (kind < 3) {
+            out_ += std::to_string(range(0, 99));
+        } else if (kind == 3 && !callees_.empty()) {
+            call(depth);
+        } else {
+            variable();
+        }
+        return;
+    }
+
+    static const char* operators[] = {" + ", " - ", " * "};
+
+    // 嵌套的二元表达式加括号，顶层不加
+    if (depth > 0) {
+        out_ += "(";
+    }
+    expression(depth + 1);
+    if (chance(0.1)) {
+        // 模数为非零常量
+        out_ += " % ";
+        out_ += std::to_string(range(1, 16));
+    } else {
+        out_ += operators[range(0, 2)];
+        expression(depth + 1);
+    }
+    if (depth > 0) {
+        out_ += ")";
+    }
+}
+
+void ProgramGenerator::call(int depth) {
+    int callee = callees_[range(0, static_cast<int>(callees_.size()) - 1)];
+
+    out_ += "f";
+    out_ += std::to_string(callee);
+    out_ += "(";
+    for (int i = 0; i < arity_[callee]; ++i) {
+        if (i > 0) {
+            out_ += ", ";
+        }
+        // 实参不再包含调用，避免调用嵌套过深
+        std::vector<int> saved;
+        saved.swap(callees_);
+        expression(depth + 1);
+        saved.swap(callees_);
+    }
+    out_ += ")";
+}
+
+void ProgramGenerator::variable() {
+    int choice = range(0, options_.identifiers + parameters_ - 1);
+    if (choice < options_.identifiers) {
+        out_ += "v";
+        out_ += std::to_string(choice);
+    } else {
+        out_ += "p";
+        out_ += std::to_string(choice - options_.identifiers);
+    }
+}
+
+void ProgramGenerator::indent(int depth) {
+    out_.append(static_cast<size_t>(depth + 1) * 4, ' ');
+}
+
+} // namespace minicompiler
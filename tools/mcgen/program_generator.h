@@ -0,0 +1,96 @@
+#ifndef MINICOMPILER_PROGRAM_GENERATOR_H
+#define MINICOMPILER_PROGRAM_GENERATOR_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace minicompiler {
+
+/**
+ * @brief 合成程序的规模与形状参数
+ */
+struct GeneratorOptions {
+    // 随机数种子，相同的种子和参数总是生成相同的程序
+    uint64_t seed = 1;
+
+    // 函数数量（不含main）
+    int functions = 16;
+
+    // 语句最大嵌套深度（if/while）
+    int maxDepth = 3;
+
+    // 复合语句中循环所占比例，范围[0, 1]
+    double loopDensity = 0.3;
+
+    // 表达式树最大深度
+    int expressionDepth = 4;
+
+    // 每个函数最多调用的不同函数数
+    int fanOut = 2;
+
+    // 每个函数的局部变量数
+    int identifiers = 8;
+
+    // 每个语句块的语句数
+    int statementsPerBlock = 4;
+
+    // 目标输出字节数，非0时忽略functions，持续生成函数直到达到该大小
+    uint64_t targetBytes = 0;
+};
+
+/**
+ * @brief 确定性的合成程序生成器
+ *
+ * 生成的程序总能通过词法和语法分析，并且一定会终止：函数只调用编号更小的函数，
+ * 每个循环都有专用的计数器和固定的上界，除数和模数都是非零常量。
+ * 程序逐个函数写入输出流，生成数百MB的输入也不需要在内存中保存完整文本。
+ */
+class ProgramGenerator {
+public:
+    explicit ProgramGenerator(const GeneratorOptions& options);
+
+    /**
+     * @brief 生成程序并写入输出流
+     * @return 写入的字节数
+     */
+    uint64_t generate(std::ostream& os);
+
+    /**
+     * @brief 生成程序并以字符串返回
+     */
+    std::string generate();
+
+private:
+    // splitmix64，输出不依赖标准库实现
+    uint64_t next();
+    int range(int low, int high);
+    bool chance(double probability);
+
+    void function(int index);
+    void block(int depth);
+    void statement(int depth);
+    void loop(int depth);
+    void branch(int depth);
+    void condition(int depth);
+    void expression(int depth);
+    void call(int depth);
+    void variable();
+    void indent(int depth);
+
+    GeneratorOptions options_;
+    uint64_t state_;
+    std::string out_;
+
+    // 当前函数的信息
+    int parameters_ = 0;
+    std::vector<int> callees_;
+
+    // 每个已生成函数的参数个数
+    std::vector<int> arity_;
+};
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_PROGRAM_GENERATOR_H
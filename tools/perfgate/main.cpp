@@ -0,0 +1,193 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/json.h"
+#include "perf_stats.h"
+
+using namespace minicompiler;
+
+void printUsage(const char* programName) {
+    std::cerr << "Usage: " << programName << " compare --baseline=<file> [options] <results.json>..." << std::endl;
+    std::cerr << "       " << programName << " update --baseline=<file> [options] <results.json>..." << std::endl;
+    std::cerr << "Compare Google Benchmark JSON results (run with --benchmark_repetitions)" << std::endl;
+    std::cerr << "against a stored baseline, or replace the baseline with them." << std::endl;
+    std::cerr << "Options:" << std::endl;
+    std::cerr << "  --baseline=<file>    Baseline file" << std::endl;
+    std::cerr << "  --tolerance=<r>      Allowed median slowdown, e.g. 0.10 for 10% (default: 0.10)" << std::endl;
+    std::cerr << "  --alpha=<p>          Significance level of the Mann-Whitney test (default: 0.05)" << std::endl;
+    std::cerr << "  --metric=<name>      cpu_time or real_time (default: cpu_time)" << std::endl;
+    std::cerr << "  -h, --help           Display this help message" << std::endl;
+}
+
+bool readFile(const std::string& filename, std::string& content) {
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    if (!file) {
+        std::cerr << "Error: Could not open file '" << filename << "'" << std::endl;
+        return false;
+    }
+    std::ostringstream oss;
+    oss << file.rdbuf();
+    content = oss.str();
+    return true;
+}
+
+/**
+ * @brief 以合适的单位格式化纳秒时间
+ */
+std::string formatTime(double ns) {
+    static const char* units[] = {"ns", "us", "ms", "s"};
+    int unit = 0;
+    while (ns >= 1000.0 && unit < 3) {
+        ns /= 1000.0;
+        unit++;
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.2f %s", ns, units[unit]);
+    return buffer;
+}
+
+const char* optionValue(const char* arg, const char* name) {
+    size_t length = strlen(name);
+    if (strncmp(arg, name, length) == 0 && arg[length] == '=') {
+        return arg + length + 1;
+    }
+    return nullptr;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::string command = argv[1];
+    if (command == "-h" || command == "--help") {
+        printUsage(argv[0]);
+        return 0;
+    }
+    if (command != "compare" && command != "update") {
+        std::cerr << "Error: Unknown command '" << command << "'" << std::endl;
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::string baselineFile;
+    std::string metric = "cpu_time";
+    double tolerance = 0.10;
+    double alpha = 0.05;
+    std::vector<std::string> resultFiles;
+
+    for (int i = 2; i < argc; ++i) {
+        const char* value = nullptr;
+        if ((value = optionValue(argv[i], "--baseline"))) {
+            baselineFile = value;
+        } else if ((value = optionValue(argv[i], "--tolerance"))) {
+            tolerance = std::atof(value);
+        } else if ((value = optionValue(argv[i], "--alpha"))) {
+            alpha = std::atof(value);
+        } else if ((value = optionValue(argv[i], "--metric"))) {
+            metric = value;
+        } else if (argv[i][0] == '-') {
+            std::cerr << "Error: Unknown option '" << argv[i] << "'" << std::endl;
+            printUsage(argv[0]);
+            return 2;
+        } else {
+            resultFiles.push_back(argv[i]);
+        }
+    }
+
+    if (baselineFile.empty() || resultFiles.empty()) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    BenchmarkSamples current;
+    try {
+        for (const auto& file : resultFiles) {
+            std::string text;
+            if (!readFile(file, text)) {
+                return 2;
+            }
+            collectSamples(JsonValue::parse(text), metric, current);
+        }
+    } catch (const JsonError& e) {
+        std::cerr << "Error: Invalid benchmark results: " << e.what() << std::endl;
+        return 2;
+    }
+
+    if (command == "update") {
+        std::ofstream file(baselineFile, std::ios::out | std::ios::trunc);
+        file << writeBaseline(current, metric);
+        if (!file) {
+            std::cerr << "Error: Failed to write file '" << baselineFile << "'" << std::endl;
+            return 2;
+        }
+        std::cout << "Wrote baseline with " << current.size() << " benchmarks to " << baselineFile << std::endl;
+        return 0;
+    }
+
+    BenchmarkSamples baseline;
+    try {
+        std::string text;
+        if (!readFile(baselineFile, text)) {
+            return 2;
+        }
+        baseline = readBaseline(JsonValue::parse(text));
+    } catch (const JsonError& e) {
+        std::cerr << "Error: Invalid baseline: " << e.what() << std::endl;
+        return 2;
+    }
+
+    // 逐个基准比较中位数，只有变慢超过容差且统计显著时才算回归
+    int regressions = 0;
+    std::printf("%-40s %12s %12s %9s %8s  %s\n", "Benchmark", "Baseline", "Current", "Change", "p-value", "Status");
+
+    for (const auto& entry : current) {
+        auto it = baseline.find(entry.first);
+        if (it == baseline.end()) {
+            std::printf("%-40s %12s %12s %9s %8s  %s\n", entry.first.c_str(), "-",
+                        formatTime(median(entry.second)).c_str(), "-", "-", "new");
+            continue;
+        }
+
+        double before = median(it->second);
+        double after = median(entry.second);
+        double change = before > 0.0 ? after / before - 1.0 : 0.0;
+        double slower = mannWhitneyGreater(it->second, entry.second);
+        double faster = mannWhitneyGreater(entry.second, it->second);
+
+        const char* status = "ok";
+        if (change > tolerance && slower < alpha) {
+            status = "REGRESSION";
+            regressions++;
+        } else if (change < -tolerance && faster < alpha) {
+            status = "improved";
+        }
+
+        std::printf("%-40s %12s %12s %+8.1f%% %8.3f  %s\n", entry.first.c_str(),
+                    formatTime(before).c_str(), formatTime(after).c_str(), change * 100.0,
+                    change >= 0.0 ? slower : faster, status);
+    }
+
+    for (const auto& entry : baseline) {
+        if (current.find(entry.first) == current.end()) {
+            std::printf("%-40s %12s %12s %9s %8s  %s\n", entry.first.c_str(),
+                        formatTime(median(entry.second)).c_str(), "-", "-", "-", "missing");
+        }
+    }
+
+    if (regressions > 0) {
+        std::printf("\n%d benchmark(s) regressed by more than %.1f%% (alpha = %.3f)\n",
+                    regressions, tolerance * 100.0, alpha);
+        return 1;
+    }
+
+    std::printf("\nNo performance regressions (tolerance %.1f%%, alpha = %.3f)\n", tolerance * 100.0, alpha);
+    return 0;
+}
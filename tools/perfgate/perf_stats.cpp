@@ -0,0 +1,165 @@
+#include "perf_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace minicompiler {
+
+double median(std::vector<double> samples) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+
+    size_t middle = samples.size() / 2;
+    std::nth_element(samples.begin(), samples.begin() + middle, samples.end());
+    double upper = samples[middle];
+    if (samples.size() % 2 == 1) {
+        return upper;
+    }
+
+    double lower = *std::max_element(samples.begin(), samples.begin() + middle);
+    return (lower + upper) / 2.0;
+}
+
+double mannWhitneyGreater(const std::vector<double>& baseline, const std::vector<double>& current) {
+    if (baseline.empty() || current.empty()) {
+        return 1.0;
+    }
+
+    // 合并后排序求秩，相同的值取平均秩
+    struct Observation {
+        double value;
+        bool isCurrent;
+    };
+    std::vector<Observation> all;
+    for (double value : baseline) {
+        all.push_back({value, false});
+    }
+    for (double value : current) {
+        all.push_back({value, true});
+    }
+    std::sort(all.begin(), all.end(),
+              [](const Observation& a, const Observation& b) { return a.value < b.value; });
+
+    double n1 = static_cast<double>(baseline.size());
+    double n2 = static_cast<double>(current.size());
+    double n = n1 + n2;
+    double currentRankSum = 0.0;
+    double tieTerm = 0.0;
+
+    for (size_t i = 0; i < all.size();) {
+        size_t j = i;
+        while (j < all.size() && all[j].value == all[i].value) {
+            j++;
+        }
+        double averageRank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2.0;
+        for (size_t k = i; k < j; ++k) {
+            if (all[k].isCurrent) {
+                currentRankSum += averageRank;
+            }
+        }
+        double ties = static_cast<double>(j - i);
+        tieTerm += ties * ties * ties - ties;
+        i = j;
+    }
+
+    double u = currentRankSum - n2 * (n2 + 1.0) / 2.0;
+    double mean = n1 * n2 / 2.0;
+    double variance = n1 * n2 / 12.0 * ((n + 1.0) - tieTerm / (n * (n - 1.0)));
+    if (variance <= 0.0) {
+        return 1.0;
+    }
+
+    double z = (u - mean - 0.5) / std::sqrt(variance);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+namespace {
+
+double toNanoseconds(double value, const std::string& unit) {
+    if (unit == "us") {
+        return value * 1e3;
+    }
+    if (unit == "ms") {
+        return value * 1e6;
+    }
+    if (unit == "s") {
+        return value * 1e9;
+    }
+    return value;
+}
+
+} // namespace
+
+void collectSamples(const JsonValue& results, const std::string& metric, BenchmarkSamples& samples) {
+    const JsonValue* benchmarks = results.find("benchmarks");
+    if (!benchmarks || !benchmarks->isArray()) {
+        return;
+    }
+
+    for (const auto& entry : benchmarks->asArray()) {
+        const JsonValue* runType = entry.find("run_type");
+        if (runType && runType->asString() != "iteration") {
+            continue;
+        }
+        const JsonValue* error = entry.find("error_occurred");
+        if (error && error->asBool()) {
+            continue;
+        }
+
+        const JsonValue* name = entry.find("run_name");
+        if (!name) {
+            name = entry.find("name");
+        }
+        const JsonValue* time = entry.find(metric);
+        if (!name || !time || !time->isNumber()) {
+            continue;
+        }
+
+        const JsonValue* unit = entry.find("time_unit");
+        samples[name->asString()].push_back(
+            toNanoseconds(time->asNumber(), unit ? unit->asString() : "ns"));
+    }
+}
+
+BenchmarkSamples readBaseline(const JsonValue& baseline) {
+    BenchmarkSamples samples;
+    const JsonValue* benchmarks = baseline.find("benchmarks");
+    if (!benchmarks || !benchmarks->isArray()) {
+        return samples;
+    }
+
+    for (const auto& entry : benchmarks->asArray()) {
+        const JsonValue* name = entry.find("name");
+        const JsonValue* values = entry.find("samples_ns");
+        if (!name || !values || !values->isArray()) {
+            continue;
+        }
+        auto& target = samples[name->asString()];
+        for (const auto& value : values->asArray()) {
+            target.push_back(value.asNumber());
+        }
+    }
+    return samples;
+}
+
+std::string writeBaseline(const BenchmarkSamples& samples, const std::string& metric) {
+    std::ostringstream oss;
+    oss.precision(10);
+    oss << "{\n  \"metric\": " << jsonQuote(metric) << ",\n  \"benchmarks\": [";
+
+    bool first = true;
+    for (const auto& entry : samples) {
+        oss << (first ? "\n" : ",\n") << "    {\"name\": " << jsonQuote(entry.first) << ", \"samples_ns\": [";
+        for (size_t i = 0; i < entry.second.size(); ++i) {
+            oss << (i == 0 ? "" : ", ") << entry.second[i];
+        }
+        oss << "]}";
+        first = false;
+    }
+
+    oss << "\n  ]\n}\n";
+    return oss.str();
+}
+
+} // namespace minicompiler
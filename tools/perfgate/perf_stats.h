@@ -0,0 +1,55 @@
+#ifndef MINICOMPILER_PERFGATE_PERF_STATS_H
+#define MINICOMPILER_PERFGATE_PERF_STATS_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "common/json.h"
+
+namespace minicompiler {
+
+/**
+ * @brief 每个基准的多次测量结果（纳秒）
+ */
+using BenchmarkSamples = std::map<std::string, std::vector<double>>;
+
+/**
+ * @brief 计算中位数，空样本返回0
+ */
+double median(std::vector<double> samples);
+
+/**
+ * @brief 单侧Mann-Whitney U检验
+ *
+ * 原假设是两组样本来自同一分布，备择假设是current整体大于baseline（变慢）。
+ * 使用带连续性校正和结校正的正态近似。
+ *
+ * @return p值，样本为空时返回1
+ */
+double mannWhitneyGreater(const std::vector<double>& baseline, const std::vector<double>& current);
+
+/**
+ * @brief 从Google Benchmark的JSON输出中提取每次重复的时间
+ *
+ * 只取run_type为iteration的条目，跳过聚合结果和出错的基准，
+ * 重复运行的条目按run_name归并。时间统一换算为纳秒。
+ *
+ * @param results --benchmark_out生成的JSON
+ * @param metric "cpu_time"或"real_time"
+ * @param samples 输出，追加到已有样本之后
+ */
+void collectSamples(const JsonValue& results, const std::string& metric, BenchmarkSamples& samples);
+
+/**
+ * @brief 读取基线文件
+ */
+BenchmarkSamples readBaseline(const JsonValue& baseline);
+
+/**
+ * @brief 把样本写成基线文件的JSON文本
+ */
+std::string writeBaseline(const BenchmarkSamples& samples, const std::string& metric);
+
+} // namespace minicompiler
+
+#endif // MINICOMPILER_PERFGATE_PERF_STATS_H